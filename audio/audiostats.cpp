@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/audiostats.h"
+#include "audio/audiostream.h"
+
+namespace Audio {
+
+void DurationHistogram::reset() {
+	count = 0;
+	total = 0;
+	max = 0;
+	for (int i = 0; i < kBuckets; i++)
+		buckets[i] = 0;
+}
+
+void DurationHistogram::add(uint32 msecs) {
+	int bucket = 0;
+	for (uint32 v = msecs; v && bucket < kBuckets - 1; v >>= 1)
+		bucket++;
+
+	buckets[bucket]++;
+	count++;
+	total += msecs;
+	if (msecs > max)
+		max = msecs;
+}
+
+Common::String DurationHistogram::format() const {
+	if (!count)
+		return "no samples";
+
+	Common::String s = Common::String::format("n=%u avg=%.2f max=%u |", count, (double)total / count, max);
+	for (int i = 0; i < kBuckets; i++) {
+		if (buckets[i])
+			s += Common::String::format(" %u%s:%u", i ? 1 << (i - 1) : 0, i == kBuckets - 1 ? "+" : "", buckets[i]);
+	}
+	return s;
+}
+
+/**
+ * A triangle wave, which is cheap enough not to distort the measurement
+ * of what it costs to mix it.
+ */
+class LoadStream : public AudioStream {
+public:
+	LoadStream(int rate, bool stereo) : _rate(rate), _stereo(stereo), _phase(0) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		for (int i = 0; i < numSamples; i++) {
+			// Each channel gets its own sample, so stereo plays an octave higher
+			_phase = (_phase + 1) & 127;
+			buffer[i] = (int16)((_phase < 64 ? _phase : 128 - _phase) * 32 - 1024);
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const { return _stereo; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return false; }
+
+private:
+	const int _rate;
+	const bool _stereo;
+	int _phase;
+};
+
+AudioStream *makeLoadStream(int rate, bool stereo) {
+	return new LoadStream(rate, stereo);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_AUDIOSTATS_H
+#define AUDIO_AUDIOSTATS_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/str.h"
+
+namespace Audio {
+
+class AudioStream;
+
+/**
+ * Durations in milliseconds, counted in power of two buckets: 0, 1, 2-3,
+ * 4-7 and so on, the last bucket taking everything longer than that.
+ *
+ * Only one thread adds to a histogram. Others may read it meanwhile and
+ * see the count and the buckets disagree by one, which does not matter
+ * for statistics.
+ */
+struct DurationHistogram {
+	enum {
+		kBuckets = 9
+	};
+
+	uint32 count;
+	uint32 total;
+	uint32 max;
+	uint32 buckets[kBuckets];
+
+	DurationHistogram() { reset(); }
+
+	void reset();
+	void add(uint32 msecs);
+
+	/**
+	 * Formats the histogram as a single line, with the buckets which
+	 * are not empty as "lowest duration:count".
+	 */
+	Common::String format() const;
+};
+
+/**
+ * What the mixer knows about one of its channels.
+ */
+struct MixerChannelStats {
+	uint32 handle;
+	int id;
+	int type;
+	bool paused;
+	/** Callbacks in which the channel was mixed */
+	uint32 mixCalls;
+	/** Time spent in mixing the channel, summed over all callbacks */
+	uint32 mixMillis;
+	/** Sample frames mixed */
+	uint32 samples;
+};
+
+/**
+ * Statistics of the mixer.
+ *
+ * @see Mixer::getStats()
+ */
+struct MixerStats {
+	uint outputRate;
+	/** Size of the output buffer of the backend in sample frames, 0 if not known */
+	uint bufferSamples;
+	/** Times the backend had nothing new to play, as far as it can tell */
+	uint32 underruns;
+	/** Time taken by each mixer callback */
+	DurationHistogram callbackTime;
+	/** The channels still known to the mixer */
+	Common::Array<MixerChannelStats> channels;
+};
+
+/**
+ * Statistics of one QueuingAudioStream.
+ */
+struct QueueStats {
+	/** Tells the queues apart, in the order they were made */
+	uint32 serial;
+	int rate;
+	bool stereo;
+	/** Streams queued right now */
+	uint32 depth;
+	uint32 peakDepth;
+	/** Reads which found the queue short of samples before it was finished */
+	uint32 starved;
+};
+
+/**
+ * Set up the list of queues behind getQueueStats(). The mixer does this
+ * when it is made, before there are any other threads. Queues made before
+ * that are not counted.
+ */
+void initQueueStats();
+
+/**
+ * Fetch the statistics of every QueuingAudioStream which has not been
+ * deleted yet.
+ */
+void getQueueStats(Common::Array<QueueStats> &stats);
+
+/**
+ * Reset the peak depth and starved count of every QueuingAudioStream.
+ */
+void resetQueueStats();
+
+/**
+ * Create an endless triangle wave, for loading the mixer with synthetic
+ * streams. Using different rates makes them go through the rate
+ * converters like real sounds do.
+ */
+AudioStream *makeLoadStream(int rate, bool stereo);
+
+} // End of namespace Audio
+
+#endif
@@ -27,7 +27,9 @@
 #include "common/queue.h"
 #include "common/util.h"
 
+#include "audio/audiostats.h"
 #include "audio/audiostream.h"
+#include "audio/decodeahead.h"
 #include "audio/decoders/flac.h"
 #include "audio/decoders/mp3.h"
 //#include "audio/decoders/quicktime.h"
@@ -72,8 +74,9 @@ SeekableAudioStream *SeekableAudioStream::openStreamFile(const Common::String &b
 		Common::String filename = basename + STREAM_FILEFORMATS[i].fileExtension;
 		fileHandle->open(filename);
 		if (fileHandle->isOpen()) {
-			// Create the stream object
-			stream = STREAM_FILEFORMATS[i].openStreamFile(fileHandle, DisposeAfterUse::YES);
+			// Create the stream object. All of these formats are costly
+			// to decode, so it is done ahead of playback.
+			stream = makeDecodeAheadStream(STREAM_FILEFORMATS[i].openStreamFile(fileHandle, DisposeAfterUse::YES), DisposeAfterUse::YES);
 			fileHandle = 0;
 			break;
 		}
@@ -299,11 +302,22 @@ private:
 	 */
 	Common::Queue<StreamHolder> _queue;
 
+	/**
+	 * The statistics, see QueueStats. The depth is kept apart from the
+	 * queue, so that it can be read without taking the mutex.
+	 */
+	uint32 _serial;
+	volatile uint32 _depth;
+	volatile uint32 _peakDepth;
+	volatile uint32 _starved;
+
 public:
-	QueuingAudioStreamImpl(int rate, bool stereo)
-	    : _rate(rate), _stereo(stereo), _finished(false) {}
+	QueuingAudioStreamImpl(int rate, bool stereo);
 	~QueuingAudioStreamImpl();
 
+	void getStats(QueueStats &stats) const;
+	void resetStats();
+
 	// Implement the AudioStream API
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 	virtual bool isStereo() const { return _stereo; }
@@ -324,7 +338,41 @@ public:
 	}
 };
 
+// Every QueuingAudioStream, for getQueueStats(). Both are set up by
+// initQueueStats(), and live as long as the process.
+static Common::Array<QueuingAudioStreamImpl *> *queuingStreams = 0;
+static Common::Mutex *queuingStreamsMutex = 0;
+static uint32 queuingStreamSerial = 0;
+
+void initQueueStats() {
+	if (queuingStreams)
+		return;
+
+	queuingStreamsMutex = new Common::Mutex();
+	queuingStreams = new Common::Array<QueuingAudioStreamImpl *>();
+}
+
+QueuingAudioStreamImpl::QueuingAudioStreamImpl(int rate, bool stereo)
+    : _rate(rate), _stereo(stereo), _finished(false), _serial(0), _depth(0), _peakDepth(0), _starved(0) {
+	if (!queuingStreams)
+		return;
+
+	Common::StackLock lock(*queuingStreamsMutex);
+	_serial = queuingStreamSerial++;
+	queuingStreams->push_back(this);
+}
+
 QueuingAudioStreamImpl::~QueuingAudioStreamImpl() {
+	if (queuingStreams) {
+		Common::StackLock lock(*queuingStreamsMutex);
+		for (uint i = 0; i < queuingStreams->size(); i++) {
+			if ((*queuingStreams)[i] == this) {
+				queuingStreams->remove_at(i);
+				break;
+			}
+		}
+	}
+
 	while (!_queue.empty()) {
 		StreamHolder tmp = _queue.pop();
 		if (tmp._disposeAfterUse == DisposeAfterUse::YES)
@@ -339,6 +387,9 @@ void QueuingAudioStreamImpl::queueAudioStream(AudioStream *stream, DisposeAfterU
 
 	Common::StackLock lock(_mutex);
 	_queue.push(StreamHolder(stream, disposeAfterUse));
+	_depth = _depth + 1;
+	if (_depth > _peakDepth)
+		_peakDepth = _depth;
 }
 
 int QueuingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
@@ -351,18 +402,58 @@ int QueuingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
 
 		if (stream->endOfData()) {
 			StreamHolder tmp = _queue.pop();
+			_depth = _depth - 1;
 			if (tmp._disposeAfterUse == DisposeAfterUse::YES)
 				delete stream;
 		}
 	}
 
+	if (samplesDecoded < numSamples && !_finished)
+		_starved = _starved + 1;
+
 	return samplesDecoded;
 }
 
+void QueuingAudioStreamImpl::getStats(QueueStats &stats) const {
+	stats.serial = _serial;
+	stats.rate = _rate;
+	stats.stereo = _stereo;
+	stats.depth = _depth;
+	stats.peakDepth = _peakDepth;
+	stats.starved = _starved;
+}
+
+void QueuingAudioStreamImpl::resetStats() {
+	// Like the writers of the statistics
+	Common::StackLock lock(_mutex);
+	_peakDepth = _depth;
+	_starved = 0;
+}
+
 QueuingAudioStream *makeQueuingAudioStream(int rate, bool stereo) {
 	return new QueuingAudioStreamImpl(rate, stereo);
 }
 
+void getQueueStats(Common::Array<QueueStats> &stats) {
+	stats.clear();
+	if (!queuingStreams)
+		return;
+
+	Common::StackLock lock(*queuingStreamsMutex);
+	stats.resize(queuingStreams->size());
+	for (uint i = 0; i < queuingStreams->size(); i++)
+		(*queuingStreams)[i]->getStats(stats[i]);
+}
+
+void resetQueueStats() {
+	if (!queuingStreams)
+		return;
+
+	Common::StackLock lock(*queuingStreamsMutex);
+	for (uint i = 0; i < queuingStreams->size(); i++)
+		(*queuingStreams)[i]->resetStats();
+}
+
 Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo) {
 	Timestamp result(where.convertToFramerate(rate * (isStereo ? 2 : 1)));
 
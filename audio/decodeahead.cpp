@@ -0,0 +1,304 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+#include "audio/decodeahead.h"
+
+namespace Audio {
+
+/** How often the decoding timer runs, in microseconds */
+#define DECODE_AHEAD_INTERVAL 10000
+
+/**
+ * The state shared by a DecodeAheadStream and the decoding timer. It
+ * outlives the stream: the stream only marks it as released, and the timer
+ * frees it, so that deleting the stream never has to wait for the decoder.
+ *
+ * The ring indices are only ever written by one side: head and finished by
+ * the timer, tail by the stream. They count samples, and wrap around. They
+ * are guarded by decodeAheadMutex, like the seek requests and the released
+ * flag, which also orders them with the samples in the ring.
+ */
+struct DecodeAheadBuffer {
+	SeekableAudioStream *stream;
+	DisposeAfterUse::Flag disposeAfterUse;
+	uint loops;
+	uint completeIterations;
+
+	int16 *ring;
+	uint32 size;
+	uint32 head;
+	uint32 tail;
+
+	Timestamp seekTarget;
+	uint32 seekCount;
+	uint32 seekDone;
+	// Where the samples of the last seek done start
+	uint32 seekHead;
+
+	bool finished;
+	bool released;
+};
+
+// Both are created along with the first stream and kept, like the decoding
+// timer, for the rest of the process. Removing the timer from a stream
+// destructor would wait for it, while the mixer deletes streams under its
+// own lock, which the timer procs of the engines take too.
+static Common::Array<DecodeAheadBuffer *> *decodeAheadBuffers = 0;
+// Only there with a system, as without one there is no timer either
+static Common::Mutex *decodeAheadMutex = 0;
+
+// Reads which got fewer samples than asked for because the decoder lagged
+static volatile uint32 decodeAheadUnderruns = 0;
+
+static void lockBuffers() {
+	if (decodeAheadMutex)
+		decodeAheadMutex->lock();
+}
+
+static void unlockBuffers() {
+	if (decodeAheadMutex)
+		decodeAheadMutex->unlock();
+}
+
+static void decodeAheadHandler(void *) {
+	decodeAheadStreams();
+}
+
+static void freeDecodeAheadBuffer(DecodeAheadBuffer *buf) {
+	if (buf->disposeAfterUse == DisposeAfterUse::YES)
+		delete buf->stream;
+	delete[] buf->ring;
+	delete buf;
+}
+
+/**
+ * Decode until the ring is full, the wrapped stream has no more data, or
+ * a new seek comes in. Only called by the decoding timer, or from the
+ * DecodeAheadStream constructor before the timer knows about the buffer.
+ */
+static void fillDecodeAheadBuffer(DecodeAheadBuffer *buf) {
+	lockBuffers();
+	const uint32 seekCount = buf->seekCount;
+	const bool seek = (seekCount != buf->seekDone);
+	const Timestamp seekTarget = buf->seekTarget;
+	unlockBuffers();
+
+	if (seek) {
+		if (!buf->stream->seek(seekTarget))
+			warning("DecodeAheadStream: could not seek the wrapped stream");
+		buf->completeIterations = 0;
+
+		lockBuffers();
+		buf->finished = false;
+		buf->seekHead = buf->head;
+		buf->seekDone = seekCount;
+		unlockBuffers();
+	}
+
+	bool rewound = false;
+	for (;;) {
+		lockBuffers();
+		const bool stop = buf->finished || buf->seekCount != seekCount;
+		const uint32 head = buf->head;
+		// The reader only ever frees up space
+		const uint32 space = buf->size - (head - buf->tail);
+		unlockBuffers();
+		if (stop)
+			break;
+
+		const uint32 pos = head & (buf->size - 1);
+		const int numSamples = MIN(space, buf->size - pos);
+		if (numSamples == 0)
+			break;
+
+		const int samplesRead = buf->stream->readBuffer(buf->ring + pos, numSamples);
+		if (samplesRead > 0)
+			rewound = false;
+
+		bool finished = false;
+		const bool endOfData = buf->stream->endOfData();
+		if (endOfData) {
+			// Also stop looping a stream which turns out to be empty
+			++buf->completeIterations;
+			if ((buf->loops && buf->completeIterations == buf->loops) || rewound || !buf->stream->rewind())
+				finished = true;
+			rewound = true;
+		}
+
+		lockBuffers();
+		buf->head = head + MAX(samplesRead, 0);
+		buf->finished = finished;
+		unlockBuffers();
+
+		if (!endOfData && samplesRead < numSamples) {
+			// Nothing more to decode for now
+			break;
+		}
+	}
+}
+
+void decodeAheadStreams() {
+	if (!decodeAheadBuffers)
+		return;
+
+	// New streams are added meanwhile, but only this removes any
+	Common::Array<DecodeAheadBuffer *> buffers, released;
+	lockBuffers();
+	for (uint i = 0; i < decodeAheadBuffers->size(); ) {
+		DecodeAheadBuffer *buf = (*decodeAheadBuffers)[i];
+		if (buf->released) {
+			released.push_back(buf);
+			decodeAheadBuffers->remove_at(i);
+		} else {
+			buffers.push_back(buf);
+			i++;
+		}
+	}
+	unlockBuffers();
+
+	for (uint i = 0; i < released.size(); i++)
+		freeDecodeAheadBuffer(released[i]);
+
+	for (uint i = 0; i < buffers.size(); i++)
+		fillDecodeAheadBuffer(buffers[i]);
+}
+
+DecodeAheadStream::DecodeAheadStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint loops, uint lookahead)
+	: _isStereo(stream->isStereo()), _rate(stream->getRate()), _length(stream->getLength()), _flushedSeek(0) {
+
+	_buffer = new DecodeAheadBuffer();
+	_buffer->stream = stream;
+	_buffer->disposeAfterUse = disposeAfterUse;
+	_buffer->loops = loops;
+	_buffer->completeIterations = 0;
+
+	// Round up to a power of two, so that the indices can simply wrap around
+	const uint32 samples = (uint32)_rate * (_isStereo ? 2 : 1) * lookahead / 1000;
+	_buffer->size = 2048;
+	while (_buffer->size < samples)
+		_buffer->size <<= 1;
+	_buffer->ring = new int16[_buffer->size];
+	_buffer->head = _buffer->tail = 0;
+
+	_buffer->seekCount = _buffer->seekDone = 0;
+	_buffer->seekHead = 0;
+	_buffer->finished = false;
+	_buffer->released = false;
+
+	if (!decodeAheadBuffers) {
+		decodeAheadBuffers = new Common::Array<DecodeAheadBuffer *>();
+		if (g_system) {
+			decodeAheadMutex = new Common::Mutex();
+			g_system->getTimerManager()->installTimerProc(&decodeAheadHandler, DECODE_AHEAD_INTERVAL, 0, "decodeAhead");
+		}
+	}
+
+	// Start with a full buffer
+	fillDecodeAheadBuffer(_buffer);
+
+	lockBuffers();
+	decodeAheadBuffers->push_back(_buffer);
+	unlockBuffers();
+}
+
+DecodeAheadStream::~DecodeAheadStream() {
+	// The decoding timer deletes the buffer and the wrapped stream
+	lockBuffers();
+	_buffer->released = true;
+	unlockBuffers();
+}
+
+int DecodeAheadStream::readBuffer(int16 *buffer, const int numSamples) {
+	lockBuffers();
+	if (_buffer->seekCount != _buffer->seekDone) {
+		unlockBuffers();
+		return 0;
+	}
+
+	// Skip what was decoded before the last seek
+	if (_flushedSeek != _buffer->seekDone) {
+		_buffer->tail = _buffer->seekHead;
+		_flushedSeek = _buffer->seekDone;
+	}
+
+	const uint32 tail = _buffer->tail;
+	const int samples = MIN<uint32>(_buffer->head - tail, numSamples);
+	unlockBuffers();
+
+	const uint32 pos = tail & (_buffer->size - 1);
+	const int first = MIN<uint32>(samples, _buffer->size - pos);
+
+	memcpy(buffer, _buffer->ring + pos, first * sizeof(int16));
+	memcpy(buffer + first, _buffer->ring, (samples - first) * sizeof(int16));
+
+	lockBuffers();
+	_buffer->tail = tail + samples;
+	const bool finished = _buffer->finished;
+	unlockBuffers();
+
+	if (samples < numSamples && !finished)
+		decodeAheadUnderruns = decodeAheadUnderruns + 1;
+
+	return samples;
+}
+
+bool DecodeAheadStream::endOfData() const {
+	lockBuffers();
+	bool end = false;
+	if (_buffer->seekCount == _buffer->seekDone) {
+		// Once finished, head does not move until the next seek
+		const uint32 readPos = (_flushedSeek != _buffer->seekDone) ? _buffer->seekHead : _buffer->tail;
+		end = _buffer->finished && _buffer->head == readPos;
+	}
+	unlockBuffers();
+	return end;
+}
+
+bool DecodeAheadStream::seek(const Timestamp &where) {
+	if (_length.totalNumberOfFrames() && where > _length)
+		return false;
+
+	lockBuffers();
+	_buffer->seekTarget = where;
+	_buffer->seekCount++;
+	unlockBuffers();
+	return true;
+}
+
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint loops, uint lookahead) {
+	if (!stream)
+		return 0;
+
+	return new DecodeAheadStream(stream, disposeAfterUse, loops, lookahead);
+}
+
+uint32 getDecodeAheadUnderruns() {
+	return decodeAheadUnderruns;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,122 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_DECODEAHEAD_H
+#define AUDIO_DECODEAHEAD_H
+
+#include "common/scummsys.h"
+#include "common/types.h"
+
+#include "audio/audiostream.h"
+
+namespace Audio {
+
+struct DecodeAheadBuffer;
+
+/**
+ * A seekable audio stream which decodes another one ahead of playback, from
+ * a timer proc, into a ring buffer. Reading from it only copies samples, so
+ * the cost of decoding MP3, Vorbis or FLAC does not land on the audio thread.
+ *
+ * The ring buffer has a single writer, the decoding timer, and a single
+ * reader, whoever plays the stream. Neither of them ever waits on the other
+ * for longer than it takes to hand over the ring positions or a seek, which
+ * is done under a mutex. If the decoder falls behind, readBuffer() returns
+ * fewer samples than requested while endOfData() stays false. Deleting a
+ * stream does not wait for the decoder either: the decoding timer frees the
+ * buffer and the wrapped stream the next time it runs.
+ *
+ * A seek only takes effect once the decoding timer has seeked the wrapped
+ * stream; until then no samples are returned.
+ *
+ * @see makeDecodeAheadStream
+ */
+class DecodeAheadStream : public SeekableAudioStream {
+public:
+	/**
+	 * Creates a decode ahead stream. The buffer is filled before this returns.
+	 *
+	 * @param stream Stream to decode
+	 * @param disposeAfterUse Whether to delete the stream along with this one
+	 * @param loops How often to play the stream (0 = infinite). Looping is done
+	 *              by the decoding timer, so that there is no gap when rewinding.
+	 * @param lookahead How much audio to keep decoded, in milliseconds
+	 */
+	DecodeAheadStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint loops, uint lookahead);
+	~DecodeAheadStream();
+
+	int readBuffer(int16 *buffer, const int numSamples);
+	bool endOfData() const;
+
+	bool isStereo() const { return _isStereo; }
+	int getRate() const { return _rate; }
+
+	/**
+	 * Seeks to the given position. The whole buffer is thrown away, and the
+	 * seek is done on the wrapped stream by the decoding timer, so success is
+	 * reported as long as the position is within the stream.
+	 */
+	bool seek(const Timestamp &where);
+
+	/**
+	 * Returns the length of the wrapped stream, i.e. of one loop.
+	 */
+	Timestamp getLength() const { return _length; }
+
+private:
+	DecodeAheadBuffer *_buffer;
+	const bool _isStereo;
+	const int _rate;
+	const Timestamp _length;
+
+	// The last seek whose flush has been applied to the buffer
+	uint32 _flushedSeek;
+};
+
+/**
+ * Wrap a stream into a DecodeAheadStream.
+ *
+ * @param stream  Stream to decode ahead of playback (may be NULL)
+ * @param disposeAfterUse Whether to delete the stream along with the new one
+ * @param loops   How often to play the stream (0 = infinite)
+ * @param lookahead How much audio to keep decoded, in milliseconds
+ * @return A new SeekableAudioStream, or NULL if stream was NULL.
+ */
+SeekableAudioStream *makeDecodeAheadStream(SeekableAudioStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint loops = 1, uint lookahead = 500);
+
+/**
+ * Decode ahead of playback for every DecodeAheadStream, and free the buffers
+ * of the ones which have been deleted. This is called from a timer proc
+ * installed along with the first stream and kept for the rest of the
+ * process; it only has to be called directly where there are no timers.
+ */
+void decodeAheadStreams();
+
+/**
+ * Returns how often a DecodeAheadStream returned fewer samples than
+ * requested because its decoder had fallen behind, over all streams.
+ */
+uint32 getDecodeAheadUnderruns();
+
+} // End of namespace Audio
+
+#endif
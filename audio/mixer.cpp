@@ -21,6 +21,7 @@
  */
 
 #include "common/util.h"
+#include "common/mutex.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -53,14 +54,43 @@ public:
 	 *             10 means that the buffer contains twice 10 sample, each
 	 *             16 bits, for a total of 40 bytes.
 	 * @return number of sample pairs processed (which can still be silence!)
+	 *
+	 * Only called from the audio thread, holding the stream mutex.
 	 */
 	int mix(int16 *data, uint len);
 
 	/**
 	 * Queries whether the channel is still playing or not.
+	 * Only called from the audio thread, holding the stream mutex.
 	 */
 	bool isFinished() const { return _stream->endOfStream(); }
 
+	/**
+	 * Stops the channel. The audio thread drops it at its next callback
+	 * and hands it back through the retired list, and an owned stream is
+	 * deleted with the channel. A stream owned by the caller may be deleted
+	 * as soon as this returns, so then this waits until the audio thread is
+	 * done with mixing it.
+	 */
+	void stop();
+
+	/**
+	 * Queries whether the channel has been stopped.
+	 */
+	bool isStopped() const;
+
+	/**
+	 * Queries whether the channel is still known to the mixer, i.e. not
+	 * stopped. Finished channels are deleted as soon as the audio thread
+	 * hands them back.
+	 */
+	bool isAlive() const { return !_stopped; }
+
+	/**
+	 * Returns the mutex held by the audio thread while it uses the stream.
+	 */
+	Common::Mutex &getStreamMutex() { return _streamMutex; }
+
 	/**
 	 * Queries whether the channel is a permanent channel.
 	 * A permanent channel is not affected by a Mixer::stopAll
@@ -84,7 +114,7 @@ public:
 	/**
 	 * Queries whether the channel is currently paused.
 	 */
-	bool isPaused() const { return (_pauseLevel != 0); }
+	bool isPaused() const;
 
 	/**
 	 * Sets the channel's own volume.
@@ -142,6 +172,17 @@ public:
 	 */
 	SoundHandle getHandle() const { return _handle; }
 
+	/**
+	 * Fills in the statistics of the channel.
+	 */
+	void getStats(MixerChannelStats &stats) const;
+
+	/**
+	 * Resets the statistics of the channel. Only called from the audio
+	 * thread, which is the only one to write them.
+	 */
+	void resetStats();
+
 private:
 	const Mixer::SoundType _type;
 	SoundHandle _handle;
@@ -149,22 +190,36 @@ private:
 	int _pauseLevel;
 	int _id;
 
-	byte _volume;
-	int8 _balance;
+	volatile byte _volume;
+	volatile int8 _balance;
 
 	void updateChannelVolumes();
-	st_volume_t _volL, _volR;
+	// Left volume in the high half, right volume in the low half, so
+	// that the audio thread always sees a matching pair
+	volatile uint32 _volLR;
 
 	Mixer *_mixer;
 
+	// The pause state, the time stamps and _stopped are guarded by
+	// _stateMutex, which is never held while the stream decodes
 	uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
 	uint32 _mixerTimeStamp;
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
 
+	volatile uint32 _mixCalls;
+	volatile uint32 _mixMillis;
+	volatile uint32 _mixSamples;
+
+	// Only written by the engine threads, with the mixer mutex held
+	bool _stopped;
+	Common::Mutex _stateMutex;
+	Common::Mutex _streamMutex;
+
 	RateConverter *_converter;
-	Common::DisposablePtr<AudioStream> _stream;
+	AudioStream *_stream;
+	const bool _ownsStream;
 };
 
 #pragma mark -
@@ -173,17 +228,19 @@ private:
 
 
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _syst(system), _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _syst(system), _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _resetStats(false), _underruns(0), _underrunsAtReset(0), _bufferSamples(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		_channels[i] = 0;
+	initQueueStats();
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		delete _channels[i];
+	// The audio thread is gone by now, so every channel can be deleted.
+	// The pending and retired ones are in the handle map as well.
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i)
+		delete i->_value;
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -194,29 +251,83 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
-			index = i;
-			break;
-		}
-	}
-	if (index == -1) {
-		warning("MixerImpl::out of mixer slots");
-		delete chan;
-		return;
+uint MixerImpl::getOutputLatency() const {
+	return _bufferSamples * 1000 / _sampleRate;
+}
+
+void MixerImpl::getStats(MixerStats &stats) {
+	stats.outputRate = _sampleRate;
+	stats.bufferSamples = _bufferSamples;
+	stats.underruns = _underruns - _underrunsAtReset;
+	stats.callbackTime = _callbackTime;
+
+	Common::StackLock lock(_mutex);
+	deleteRetiredChannels();
+	stats.channels.clear();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i) {
+		if (!i->_value->isAlive())
+			continue;
+		MixerChannelStats chanStats;
+		i->_value->getStats(chanStats);
+		stats.channels.push_back(chanStats);
 	}
+}
 
-	_channels[index] = chan;
+void MixerImpl::resetStats() {
+	Common::StackLock lock(_mutex);
+	_underrunsAtReset = _underruns;
+
+	Common::StackLock handoverLock(_handoverMutex);
+	_resetStats = true;
+}
+
+void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+	// 0xFFFFFFFF is the value of an unused SoundHandle
+	if (_handleSeed == 0xFFFFFFFF)
+		_handleSeed = 0;
 
 	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	chanHandle._val = _handleSeed++;
 
 	chan->setHandle(chanHandle);
-	_handleSeed++;
+	_channels[chanHandle._val] = chan;
 	if (handle)
 		*handle = chanHandle;
+
+	// Hand the channel over to the audio thread
+	Common::StackLock handoverLock(_handoverMutex);
+	_pending.push_back(chan);
+}
+
+Channel *MixerImpl::findChannel(SoundHandle handle) {
+	deleteRetiredChannels();
+
+	ChannelMap::iterator i = _channels.find(handle._val);
+	if (i == _channels.end() || !i->_value->isAlive())
+		return 0;
+	return i->_value;
+}
+
+void MixerImpl::stopChannel(Channel *chan) {
+	if (chan->isStopped())
+		return;
+	chan->stop();
+}
+
+void MixerImpl::deleteRetiredChannels() {
+	Common::Array<Channel *> retired;
+	{
+		Common::StackLock handoverLock(_handoverMutex);
+		if (_retired.empty())
+			return;
+		retired = _retired;
+		_retired.clear();
+	}
+
+	for (uint i = 0; i < retired.size(); i++) {
+		_channels.erase(retired[i]->getHandle()._val);
+		delete retired[i];
+	}
 }
 
 void MixerImpl::playStream(
@@ -237,10 +348,12 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+	deleteRetiredChannels();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
-		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+		for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i)
+			if (i->_value->isAlive() && i->_value->getId() == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -267,7 +380,7 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	const uint32 start = _syst->getMillis();
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
@@ -277,44 +390,75 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	// Splice in the channels started since the last callback
+	bool resetStats;
+	{
+		Common::StackLock handoverLock(_handoverMutex);
+		for (uint i = 0; i < _pending.size(); i++)
+			_mixing.push_back(_pending[i]);
+		_pending.clear();
+
+		resetStats = _resetStats;
+		_resetStats = false;
+	}
+
+	if (resetStats) {
+		_callbackTime.reset();
+		for (uint i = 0; i < _mixing.size(); i++)
+			_mixing[i]->resetStats();
+	}
+
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+	for (uint i = 0; i < _mixing.size(); ) {
+		Channel *chan = _mixing[i];
+		bool done;
+		{
+			// The stream mutex is taken first, so that a stop which waits
+			// on it is either seen here or waits for the mixing to end
+			Common::StackLock streamLock(chan->getStreamMutex());
+			done = chan->isStopped() || chan->isFinished();
+			if (!done && !chan->isPaused()) {
+				tmp = chan->mix(buf, len);
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
+		if (done) {
+			_mixing.remove_at(i);
+			// Hand it back. The channel may be deleted from now on.
+			Common::StackLock handoverLock(_handoverMutex);
+			_retired.push_back(chan);
+		} else {
+			i++;
+		}
+	}
+
+	_callbackTime.add(_syst->getMillis() - start);
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+	deleteRetiredChannels();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i) {
+		if (!i->_value->isPermanent())
+			stopChannel(i->_value);
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+	deleteRetiredChannels();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i) {
+		if (i->_value->getId() == id)
+			stopChannel(i->_value);
 	}
 }
 
@@ -322,21 +466,22 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	stopChannel(chan);
+	deleteRetiredChannels();
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= type && type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+	Common::StackLock lock(_mutex);
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i) {
+		if (i->_value->getType() == type)
+			i->_value->notifyGlobalVolChange();
 	}
 }
 
@@ -348,37 +493,41 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->setVolume(volume);
+	chan->setVolume(volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return chan->getVolume();
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->setBalance(balance);
+	chan->setBalance(balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Common::StackLock lock(_mutex);
+
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return chan->getBalance();
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -388,27 +537,28 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return chan->getElapsedTime();
 }
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
-		}
+	deleteRetiredChannels();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i) {
+		if (i->_value->isAlive())
+			i->_value->pause(paused);
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+	deleteRetiredChannels();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i) {
+		if (i->_value->isAlive() && i->_value->getId() == id) {
+			i->_value->pause(paused);
 			return;
 		}
 	}
@@ -418,39 +568,40 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	_channels[index]->pause(paused);
+	chan->pause(paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+	deleteRetiredChannels();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i)
+		if (i->_value->isAlive() && i->_value->getId() == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	Channel *chan = findChannel(handle);
+	if (chan)
+		return chan->getId();
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannel(handle) != 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+	deleteRetiredChannels();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i)
+		if (i->_value->isAlive() && i->_value->getType() == type)
 			return true;
 	return false;
 }
@@ -470,9 +621,9 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
+	for (ChannelMap::iterator i = _channels.begin(); i != _channels.end(); ++i) {
+		if (i->_value->getType() == type)
+			i->_value->notifyGlobalVolChange();
 	}
 }
 
@@ -490,9 +641,9 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
                  DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0),
-      _stream(stream, autofreeStream) {
+      _balance(0), _volLR(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+      _pauseStartTime(0), _pauseTime(0), _mixCalls(0), _mixMillis(0), _mixSamples(0), _stopped(false), _converter(0),
+      _stream(stream), _ownsStream(autofreeStream == DisposeAfterUse::YES) {
 	assert(mixer);
 	assert(stream);
 
@@ -502,6 +653,31 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 
 Channel::~Channel() {
 	delete _converter;
+	if (_ownsStream)
+		delete _stream;
+}
+
+void Channel::stop() {
+	{
+		Common::StackLock lock(_stateMutex);
+		_stopped = true;
+	}
+
+	// The audio thread does not touch the stream of a stopped channel once
+	// it is done with the current mix
+	if (!_ownsStream) {
+		Common::StackLock streamLock(_streamMutex);
+	}
+}
+
+bool Channel::isStopped() const {
+	Common::StackLock lock(_stateMutex);
+	return _stopped;
+}
+
+bool Channel::isPaused() const {
+	Common::StackLock lock(_stateMutex);
+	return _pauseLevel != 0;
 }
 
 void Channel::setVolume(const byte volume) {
@@ -531,39 +707,45 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
+	st_volume_t volL, volR;
+	const int8 balance = _balance;
+
 	if (!_mixer->isSoundTypeMuted(_type)) {
 		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
 
-		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
-		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+		if (balance == 0) {
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = vol / Mixer::kMaxChannelVolume;
+		} else if (balance < 0) {
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = ((127 + balance) * vol) / (Mixer::kMaxChannelVolume * 127);
 		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = ((127 - balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volR = vol / Mixer::kMaxChannelVolume;
 		}
 	} else {
-		_volL = _volR = 0;
+		volL = volR = 0;
 	}
+
+	_volLR = ((uint32)volL << 16) | volR;
 }
 
 void Channel::pause(bool paused) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
+	Common::StackLock lock(_stateMutex);
 	if (paused) {
 		_pauseLevel++;
 
 		if (_pauseLevel == 1)
 			_pauseStartTime = g_system->getMillis();
 	} else if (_pauseLevel > 0) {
-		_pauseLevel--;
-
-		if (!_pauseLevel) {
+		if (_pauseLevel == 1) {
 			_pauseTime = (g_system->getMillis() - _pauseStartTime);
 			_pauseStartTime = 0;
 		}
+
+		_pauseLevel--;
 	}
 }
 
@@ -573,10 +755,11 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
+	Common::StackLock lock(_stateMutex);
 	if (_mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
+	if (_pauseLevel != 0)
 		delta = _pauseStartTime - _mixerTimeStamp;
 	else
 		delta = g_system->getMillis() - _mixerTimeStamp - _pauseTime;
@@ -604,14 +787,43 @@ int Channel::mix(int16 *data, uint len) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis();
-		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		const uint32 samplesConsumed = _samplesDecoded;
+		const uint32 mixerTimeStamp = g_system->getMillis();
+
+		const uint32 volLR = _volLR;
+		res = _converter->flow(*_stream, data, len, (st_volume_t)(volLR >> 16), (st_volume_t)(volLR & 0xFFFF));
 		_samplesDecoded += res;
+
+		// Only published now, so that getElapsedTime() never waits on the decoding
+		{
+			Common::StackLock lock(_stateMutex);
+			_samplesConsumed = samplesConsumed;
+			_mixerTimeStamp = mixerTimeStamp;
+			_pauseTime = 0;
+		}
+
+		_mixCalls = _mixCalls + 1;
+		_mixMillis = _mixMillis + (g_system->getMillis() - mixerTimeStamp);
+		_mixSamples = _mixSamples + res;
 	}
 
 	return res;
 }
 
+void Channel::getStats(MixerChannelStats &stats) const {
+	stats.handle = _handle._val;
+	stats.id = _id;
+	stats.type = _type;
+	stats.paused = isPaused();
+	stats.mixCalls = _mixCalls;
+	stats.mixMillis = _mixMillis;
+	stats.samples = _mixSamples;
+}
+
+void Channel::resetStats() {
+	_mixCalls = 0;
+	_mixMillis = 0;
+	_mixSamples = 0;
+}
+
 } // End of namespace Audio
@@ -31,6 +31,7 @@ namespace Audio {
 class AudioStream;
 class Channel;
 class Timestamp;
+struct MixerStats;
 
 /**
  * A SoundHandle instances corresponds to a specific sound
@@ -277,6 +278,28 @@ public:
 	 * @return the output sample rate in Hz
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	/**
+	 * Query how far the sound which can be heard lags behind what has been
+	 * mixed, because of the buffering done by the backend.
+	 *
+	 * @return the output latency in milliseconds, 0 if not known
+	 */
+	virtual uint getOutputLatency() const = 0;
+
+	/**
+	 * Fetch the timing statistics of the mixer and of its channels,
+	 * gathered since the mixer was made or since resetStats().
+	 *
+	 * @param stats where to put the statistics
+	 */
+	virtual void getStats(MixerStats &stats) = 0;
+
+	/**
+	 * Reset the timing statistics of the mixer and of its channels. The
+	 * audio thread does this on its next callback.
+	 */
+	virtual void resetStats() = 0;
 };
 
 
@@ -24,7 +24,10 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hashmap.h"
 #include "common/mutex.h"
+#include "audio/audiostats.h"
 #include "audio/mixer.h"
 
 namespace Audio {
@@ -46,13 +49,27 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * The channels are shared between the engine threads and the audio thread
+ * without a global lock. The engine threads keep track of all channels in
+ * a handle map, guarded by _mutex, which the audio thread never takes.
+ * Channels pass between the two through a pending list and a retired list,
+ * guarded by _handoverMutex, which either side only holds for a few pointer
+ * moves. The audio thread splices the pending channels into its own channel
+ * table at the start of each callback. It never frees a channel: it hands
+ * it back through the retired list once it has dropped it from its table,
+ * and the engine threads delete it, with its stream if the channel owns it.
+ * Each channel has a stream mutex, held by the audio thread while mixing
+ * it, and a state mutex for its pause state and time stamps, which is only
+ * held for a few reads or writes. The engine threads only take the stream
+ * mutex to stop a channel which does not own its stream. Volume and balance
+ * are single words which the engine threads write and the audio thread
+ * reads.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
-	enum {
-		NUM_CHANNELS = 32
-	};
+	typedef Common::HashMap<uint32, Channel *> ChannelMap;
 
 	OSystem *_syst;
 	Common::Mutex _mutex;
@@ -69,7 +86,33 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
+
+	// Every channel which has not been deleted yet, by handle. Engine threads only.
+	ChannelMap _channels;
+
+	// Guards the two lists below and the statistics reset request. Never
+	// held for more than a few pointer moves.
+	Common::Mutex _handoverMutex;
+
+	// Channels started but not yet seen by the audio thread
+	Common::Array<Channel *> _pending;
+
+	// Channels the audio thread is done with, to be deleted by the engine threads
+	Common::Array<Channel *> _retired;
+
+	// Set by resetStats(), for the audio thread to reset its statistics
+	bool _resetStats;
+
+	// The channels being mixed. Audio thread only.
+	Common::Array<Channel *> _mixing;
+
+	// Statistics, only updated by the audio thread, except for the
+	// buffer size, which is set by the backend. The underruns are never
+	// reset, getStats() reports them since the last resetStats() instead.
+	DurationHistogram _callbackTime;
+	volatile uint32 _underruns;
+	uint32 _underrunsAtReset;
+	volatile uint _bufferSamples;
 
 
 public:
@@ -118,9 +161,16 @@ public:
 	virtual int getVolumeForSoundType(SoundType type) const;
 
 	virtual uint getOutputRate() const;
+	virtual uint getOutputLatency() const;
+
+	virtual void getStats(MixerStats &stats);
+	virtual void resetStats();
 
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
+	Channel *findChannel(SoundHandle handle);
+	void stopChannel(Channel *chan);
+	void deleteRetiredChannels();
 
 public:
 	/**
@@ -140,6 +190,26 @@ public:
 	 * their audio system has been completed.
 	 */
 	void setReady(bool ready);
+
+	/**
+	 * Tell the mixer how many sample frames the backend buffers for
+	 * output, for the statistics and the output latency.
+	 */
+	void setOutputBufferSize(uint samples) { _bufferSamples = samples; }
+
+	/**
+	 * Count an underrun, i.e. the backend having to play something else
+	 * than fresh mixer output. Only to be called from one thread, normally
+	 * the audio thread.
+	 */
+	void reportUnderrun() { _underruns = _underruns + 1; }
+
+	/**
+	 * The underruns and the callback times, without fetching all the
+	 * statistics. For backends which adapt their buffering to them.
+	 */
+	uint32 getUnderruns() const { return _underruns; }
+	const DurationHistogram &getCallbackTime() const { return _callbackTime; }
 };
 
 
@@ -1,7 +1,9 @@
 MODULE := audio
 
 MODULE_OBJS := \
+	audiostats.o \
 	audiostream.o \
+	decodeahead.o \
 	fmopl.o \
 	mididrv.o \
 	midiparser.o \
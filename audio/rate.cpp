@@ -31,10 +31,20 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/config-manager.h"
 #include "common/frac.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define USE_SSE2_MIXING
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON_MIXING
+#endif
+
 namespace Audio {
 
 
@@ -47,6 +57,105 @@ namespace Audio {
 #define INTERMEDIATE_BUFFER_SIZE 512
 
 
+/**
+ * Apply the volume to numFrames frames from the input buffer, and add them
+ * with clipping to the stereo output buffer.
+ *
+ * The SSE2/NEON versions handle four frames at once and give the same result
+ * as the plain version below: both channel volumes are at most
+ * kMaxMixerVolume, so the scaled sample always fits in 16 bits, and a
+ * saturating add is then the same as clampedAdd.
+ */
+template<bool stereo, bool reverseStereo>
+static void mixFrames(st_sample_t *obuf, const st_sample_t *in, st_size_t numFrames, st_volume_t vol_l, st_volume_t vol_r) {
+#if defined(USE_SSE2_MIXING)
+	// The output order of the volumes, matching the input after the swap below
+	const __m128i vol = reverseStereo ? _mm_set_epi16(vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r)
+	                                  : _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+	const __m128i round = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	for (; numFrames >= 4; numFrames -= 4) {
+		__m128i samples;
+		if (stereo) {
+			samples = _mm_loadu_si128((const __m128i *)in);
+			in += 8;
+			if (reverseStereo) {
+				samples = _mm_shufflelo_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+				samples = _mm_shufflehi_epi16(samples, _MM_SHUFFLE(2, 3, 0, 1));
+			}
+		} else {
+			samples = _mm_loadl_epi64((const __m128i *)in);
+			samples = _mm_unpacklo_epi16(samples, samples);
+			in += 4;
+		}
+
+		// 32 bit products, divided by kMaxMixerVolume rounding towards zero
+		__m128i lo = _mm_mullo_epi16(samples, vol);
+		__m128i hi = _mm_mulhi_epi16(samples, vol);
+		__m128i prod0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i prod1 = _mm_unpackhi_epi16(lo, hi);
+		prod0 = _mm_add_epi32(prod0, _mm_and_si128(_mm_srai_epi32(prod0, 31), round));
+		prod1 = _mm_add_epi32(prod1, _mm_and_si128(_mm_srai_epi32(prod1, 31), round));
+		prod0 = _mm_srai_epi32(prod0, 8);
+		prod1 = _mm_srai_epi32(prod1, 8);
+
+		__m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		out = _mm_adds_epi16(out, _mm_packs_epi32(prod0, prod1));
+		_mm_storeu_si128((__m128i *)obuf, out);
+		obuf += 8;
+	}
+#elif defined(USE_NEON_MIXING)
+	const int16 volArray[8] = {
+		(int16)(reverseStereo ? vol_r : vol_l), (int16)(reverseStereo ? vol_l : vol_r),
+		(int16)(reverseStereo ? vol_r : vol_l), (int16)(reverseStereo ? vol_l : vol_r),
+		(int16)(reverseStereo ? vol_r : vol_l), (int16)(reverseStereo ? vol_l : vol_r),
+		(int16)(reverseStereo ? vol_r : vol_l), (int16)(reverseStereo ? vol_l : vol_r)
+	};
+	const int16x8_t vol = vld1q_s16(volArray);
+	const int32x4_t round = vdupq_n_s32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	for (; numFrames >= 4; numFrames -= 4) {
+		int16x8_t samples;
+		if (stereo) {
+			samples = vld1q_s16(in);
+			in += 8;
+			if (reverseStereo)
+				samples = vrev32q_s16(samples);
+		} else {
+			int16x4_t mono = vld1_s16(in);
+			int16x4x2_t dup = vzip_s16(mono, mono);
+			samples = vcombine_s16(dup.val[0], dup.val[1]);
+			in += 4;
+		}
+
+		// 32 bit products, divided by kMaxMixerVolume rounding towards zero
+		int32x4_t prod0 = vmull_s16(vget_low_s16(samples), vget_low_s16(vol));
+		int32x4_t prod1 = vmull_s16(vget_high_s16(samples), vget_high_s16(vol));
+		prod0 = vaddq_s32(prod0, vandq_s32(vshrq_n_s32(prod0, 31), round));
+		prod1 = vaddq_s32(prod1, vandq_s32(vshrq_n_s32(prod1, 31), round));
+		int16x8_t scaled = vcombine_s16(vqshrn_n_s32(prod0, 8), vqshrn_n_s32(prod1, 8));
+
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+		obuf += 8;
+	}
+#endif
+
+	for (; numFrames > 0; numFrames--) {
+		st_sample_t out0, out1;
+		out0 = *in++;
+		out1 = (stereo ? *in++ : out0);
+
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+	}
+}
+
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -173,6 +282,9 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** interpolated frames waiting to be mixed */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -239,26 +351,284 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		}
 
 		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE && obuf < oend) {
+		// still space in the output buffer. The interpolated frames are
+		// gathered first, so that they can be mixed in one go.
+		st_sample_t *frame = outBuf;
+		st_sample_t *frameEnd = outBuf + MIN<long>(ARRAYSIZE(outBuf), oend - obuf);
+		while (opos < (frac_t)FRAC_ONE && frame < frameEnd) {
 			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
-			out1 = (stereo ?
+			frame[0] = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
+			frame[1] = (stereo ?
 						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS)) :
-						  out0);
+						  frame[0]);
+			frame += 2;
+
+			// Increment output position
+			opos += opos_inc;
+		}
+
+		st_size_t numFrames = (frame - outBuf) / 2;
+		mixFrames<true, reverseStereo>(obuf, outBuf, numFrames, vol_l, vol_r);
+		obuf += numFrames * 2;
+	}
+	return (obuf - ostart) / 2;
+}
+
+
+#pragma mark -
+
+
+/** Maximum number of coefficients applied to each output frame */
+#define FIR_MAX_TAPS 64
+
+/** Coefficient banks are only built for up to this many phases */
+#define FIR_MAX_PHASES 1024
+
+/** The coefficients are fixed point with this many fractional bits */
+#define FIR_COEF_BITS 14
+
+/** Number of coefficient banks kept around */
+#define FIR_MAX_BANKS 8
+
+/**
+ * The coefficients of a polyphase filter for one rate pair. The input is
+ * upsampled by 'up' and then downsampled by 'down', both reduced by their
+ * gcd. Phase p holds the 'taps' coefficients applied to the input frames
+ * leading up to an output frame at fractional position p / up, oldest
+ * frame first.
+ */
+struct FIRBank {
+	st_rate_t up, down;
+	int taps;
+	int16 *coefs;
+};
+
+static FIRBank *firBanks[FIR_MAX_BANKS];
+
+/**
+ * Build a windowed sinc low pass filter cutting off a bit below the lower
+ * of the two Nyquist frequencies. Each phase is normalized on its own, so
+ * that a constant input gives exactly the same constant back.
+ */
+static FIRBank *makeFIRBank(st_rate_t up, st_rate_t down) {
+	FIRBank *bank = new FIRBank;
+	bank->up = up;
+	bank->down = down;
+
+	// When downsampling the filter has to be longer for the same steepness
+	bank->taps = MIN<int>(16 * ((down + up - 1) / up), FIR_MAX_TAPS);
+	bank->coefs = new int16[up * bank->taps];
+
+	const int length = up * bank->taps;
+	const double center = (length - 1) / 2.0;
+	const double cutoff = 0.45 / MAX(up, down);
+	double *phase = new double[bank->taps];
+
+	for (st_rate_t p = 0; p < up; p++) {
+		double sum = 0.0;
+		for (int j = 0; j < bank->taps; j++) {
+			// The newest input frame comes last
+			const int n = p + (bank->taps - 1 - j) * up;
+			const double x = n - center;
+			double sinc = 2 * cutoff;
+			if (x != 0.0)
+				sinc = sin(2 * M_PI * cutoff * x) / (M_PI * x);
+			const double window = 0.42 - 0.5 * cos(2 * M_PI * n / (length - 1)) + 0.08 * cos(4 * M_PI * n / (length - 1));
+			phase[j] = sinc * window;
+			sum += phase[j];
+		}
+
+		int16 *coefs = bank->coefs + p * bank->taps;
+		int total = 0, largest = 0;
+		for (int j = 0; j < bank->taps; j++) {
+			coefs[j] = (int16)floor(phase[j] / sum * (1 << FIR_COEF_BITS) + 0.5);
+			total += coefs[j];
+			if (ABS(coefs[j]) > ABS(coefs[largest]))
+				largest = j;
+		}
+		// Put the rounding error where it matters least
+		coefs[largest] += (1 << FIR_COEF_BITS) - total;
+	}
+
+	delete[] phase;
+	return bank;
+}
+
+/**
+ * Return the coefficient bank for the given rates, building it on first use.
+ * The first FIR_MAX_BANKS banks are shared by all converters and kept until
+ * exit; any further one belongs to the converter it is built for, which is
+ * told so through 'shared'. This is only called when creating a channel,
+ * with the mixer lock held.
+ */
+static const FIRBank *getFIRBank(st_rate_t up, st_rate_t down, bool &shared) {
+	int i;
+	for (i = 0; i < FIR_MAX_BANKS && firBanks[i]; i++) {
+		if (firBanks[i]->up == up && firBanks[i]->down == down) {
+			shared = true;
+			return firBanks[i];
+		}
+	}
+
+	FIRBank *bank = makeFIRBank(up, down);
+	shared = (i < FIR_MAX_BANKS);
+	if (shared)
+		firBanks[i] = bank;
+	return bank;
+}
+
+/**
+ * Apply the filter of one phase to the frames ending at x.
+ * taps is a multiple of 8. The sum is exact in all versions.
+ */
+static inline st_sample_t firInnerProduct(const st_sample_t *x, const int16 *coefs, int taps) {
+	int32 sum;
+#if defined(USE_SSE2_MIXING)
+	__m128i acc = _mm_setzero_si128();
+	for (int j = 0; j < taps; j += 8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(x + j)), _mm_loadu_si128((const __m128i *)(coefs + j))));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	sum = _mm_cvtsi128_si32(acc);
+#elif defined(USE_NEON_MIXING)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (int j = 0; j < taps; j += 8) {
+		int16x8_t samples = vld1q_s16(x + j);
+		int16x8_t c = vld1q_s16(coefs + j);
+		acc = vmlal_s16(acc, vget_low_s16(samples), vget_low_s16(c));
+		acc = vmlal_s16(acc, vget_high_s16(samples), vget_high_s16(c));
+	}
+	int32x2_t pair = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	sum = vget_lane_s32(vpadd_s32(pair, pair), 0);
+#else
+	sum = 0;
+	for (int j = 0; j < taps; j++)
+		sum += x[j] * coefs[j];
+#endif
+	sum = (sum + (1 << (FIR_COEF_BITS - 1))) >> FIR_COEF_BITS;
+	return (st_sample_t)CLIP<int32>(sum, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+/**
+ * Audio rate converter based on a polyphase FIR filter. Gives much less
+ * aliasing than LinearRateConverter, at the cost of 16 or more
+ * multiplications per output sample.
+ *
+ * Used instead of LinearRateConverter when the "resampler" config key is
+ * set to "fir", and the reduced rate ratio needs no more than
+ * FIR_MAX_PHASES phases.
+ */
+template<bool stereo, bool reverseStereo>
+class FIRRateConverter : public RateConverter {
+protected:
+	const FIRBank *_bank;
+	bool _ownsBank;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** the input frames, one array per channel */
+	st_sample_t _hist0[FIR_MAX_TAPS + INTERMEDIATE_BUFFER_SIZE];
+	st_sample_t _hist1[FIR_MAX_TAPS + INTERMEDIATE_BUFFER_SIZE];
+	/** number of frames in the history */
+	int _histLen;
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	/** the newest input frame used for the next output frame */
+	int _pos;
+	/** phase of the next output frame, in 1/up of an input frame */
+	st_rate_t _phase;
+	/** whole input frames and phases to advance per output frame */
+	int _posInc;
+	st_rate_t _phaseInc;
 
-			obuf += 2;
+	/** filtered frames waiting to be mixed */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+public:
+	FIRRateConverter(const FIRBank *bank, bool ownsBank);
+	~FIRRateConverter() {
+		if (_ownsBank) {
+			delete[] _bank->coefs;
+			delete _bank;
+		}
+	}
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+FIRRateConverter<stereo, reverseStereo>::FIRRateConverter(const FIRBank *bank, bool ownsBank) : _bank(bank), _ownsBank(ownsBank) {
+	// Start with silence before the first input frame
+	_histLen = _bank->taps - 1;
+	memset(_hist0, 0, _histLen * sizeof(st_sample_t));
+	memset(_hist1, 0, _histLen * sizeof(st_sample_t));
+
+	_pos = _histLen;
+	_phase = 0;
+	_posInc = _bank->down / _bank->up;
+	_phaseInc = _bank->down % _bank->up;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int FIRRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+	const int taps = _bank->taps;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+
+		// read input until the frame at _pos is there
+		while (_pos >= _histLen) {
+			// Only keep the frames still needed
+			int first = MIN(_pos - (taps - 1), _histLen);
+			memmove(_hist0, _hist0 + first, (_histLen - first) * sizeof(st_sample_t));
+			if (stereo)
+				memmove(_hist1, _hist1 + first, (_histLen - first) * sizeof(st_sample_t));
+			_histLen -= first;
+			_pos -= first;
+
+			int inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+			if (inLen <= 0)
+				return (obuf - ostart) / 2;
+
+			const st_sample_t *inPtr = inBuf;
+			for (; inLen > 0; inLen -= (stereo ? 2 : 1)) {
+				_hist0[_histLen] = *inPtr++;
+				if (stereo)
+					_hist1[_histLen] = *inPtr++;
+				_histLen++;
+			}
+		}
+
+		// Filter as many frames as the input and the output buffer allow
+		st_sample_t *frame = outBuf;
+		st_sample_t *frameEnd = outBuf + MIN<long>(ARRAYSIZE(outBuf), oend - obuf);
+		while (_pos < _histLen && frame < frameEnd) {
+			const int16 *coefs = _bank->coefs + _phase * taps;
+			const int start = _pos - (taps - 1);
+			frame[0] = firInnerProduct(_hist0 + start, coefs, taps);
+			frame[1] = (stereo ? firInnerProduct(_hist1 + start, coefs, taps) : frame[0]);
+			frame += 2;
 
 			// Increment output position
-			opos += opos_inc;
+			_pos += _posInc;
+			_phase += _phaseInc;
+			if (_phase >= _bank->up) {
+				_phase -= _bank->up;
+				_pos++;
+			}
 		}
+
+		st_size_t numFrames = (frame - outBuf) / 2;
+		mixFrames<true, reverseStereo>(obuf, outBuf, numFrames, vol_l, vol_r);
+		obuf += numFrames * 2;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -283,7 +653,6 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
 		st_sample_t *ostart = obuf;
@@ -305,20 +674,9 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
+		st_size_t numFrames = (stereo ? len / 2 : len);
+		mixFrames<stereo, reverseStereo>(obuf, _buffer, numFrames, vol_l, vol_r);
+		obuf += numFrames * 2;
 		return (obuf - ostart) / 2;
 	}
 
@@ -333,6 +691,16 @@ public:
 template<bool stereo, bool reverseStereo>
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 	if (inrate != outrate) {
+		if (ConfMan.get("resampler") == "fir") {
+			st_rate_t div = Common::gcd(inrate, outrate);
+			st_rate_t up = outrate / div, down = inrate / div;
+			if (up <= FIR_MAX_PHASES) {
+				bool shared;
+				const FIRBank *bank = getFIRBank(up, down, shared);
+				return new FIRRateConverter<stereo, reverseStereo>(bank, !shared);
+			}
+		}
+
 		if ((inrate % outrate) == 0) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
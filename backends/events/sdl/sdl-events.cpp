@@ -356,6 +356,9 @@ bool SdlEventSource::pollEvent(Common::Event &event) {
 		return true;
 	}
 
+	// The adaptive audio buffer is resized from here, not from its timer
+	((OSystem_SDL *)g_system)->getMixerManager()->applyBufferSize();
+
 	SDL_Event ev;
 	while (SDL_PollEvent(&ev)) {
 		preprocessEvents(&ev);
@@ -27,7 +27,7 @@
 DoubleBufferSDLMixerManager::DoubleBufferSDLMixerManager()
 	:
 	_soundMutex(0), _soundCond(0), _soundThread(0),
-	_soundThreadIsRunning(false), _soundThreadShouldQuit(false) {
+	_soundThreadIsRunning(false), _soundThreadShouldQuit(false), _soundBufFresh(false) {
 
 }
 
@@ -49,15 +49,25 @@ void DoubleBufferSDLMixerManager::startAudio() {
 	_soundBufSize = bufSize;
 	_soundBuffers[0] = (byte *)calloc(1, bufSize);
 	_soundBuffers[1] = (byte *)calloc(1, bufSize);
+	// Starting with silence is no underrun
+	_soundBufFresh = true;
 
 	_soundThreadIsRunning = true;
 
 	// Finally start the thread
 	_soundThread = SDL_CreateThread(mixerProducerThreadEntry, this);
 
+	// The producer thread mixes one buffer ahead of the one being played
+	_mixer->setOutputBufferSize(_obtained.samples * 2);
+
 	SdlMixerManager::startAudio();
 }
 
+void DoubleBufferSDLMixerManager::stopAudio() {
+	// The buffers are made again by startAudio(), with the new size
+	deinitThreadedMixer();
+}
+
 void DoubleBufferSDLMixerManager::mixerProducerThread() {
 	byte nextSoundBuffer;
 
@@ -75,6 +85,7 @@ void DoubleBufferSDLMixerManager::mixerProducerThread() {
 
 		// Swap buffers
 		_activeSoundBuf = nextSoundBuffer;
+		_soundBufFresh = true;
 	}
 	SDL_UnlockMutex(_soundMutex);
 }
@@ -118,6 +129,12 @@ void DoubleBufferSDLMixerManager::callbackHandler(byte *samples, int len) {
 	// Copy data from the current sound buffer
 	memcpy(samples, _soundBuffers[_activeSoundBuf], len);
 
+	// The producer thread did not make it in time, so the last buffer
+	// is played once more
+	if (!_soundBufFresh)
+		_mixer->reportUnderrun();
+	_soundBufFresh = false;
+
 	// Unlock mutex and wake up the produced thread
 	SDL_UnlockMutex(_soundMutex);
 	SDL_CondSignal(_soundCond);
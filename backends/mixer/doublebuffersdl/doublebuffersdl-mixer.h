@@ -44,6 +44,9 @@ protected:
 	uint _soundBufSize;
 	byte *_soundBuffers[2];
 
+	/** Whether the active buffer has not been played yet */
+	bool _soundBufFresh;
+
 	/**
 	 * Handles and swap the sound buffers
 	 */
@@ -60,6 +63,7 @@ protected:
 	static int SDLCALL mixerProducerThreadEntry(void *arg);
 
 	virtual void startAudio();
+	virtual void stopAudio();
 	virtual void callbackHandler(byte *samples, int len);
 };
 
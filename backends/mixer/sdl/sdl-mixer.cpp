@@ -29,6 +29,7 @@
 #include "common/system.h"
 #include "common/config-manager.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 
 #ifdef GP2X
 #define SAMPLES_PER_SEC 11025
@@ -37,14 +38,31 @@
 #endif
 //#define SAMPLES_PER_SEC 44100
 
+// How often the adaptive buffer is checked, in microseconds
+#define ADAPT_INTERVAL 1000000
+// How many checks in a row without underruns before shrinking the buffer
+#define ADAPT_SHRINK_CHECKS 30
+
 SdlMixerManager::SdlMixerManager()
 	:
 	_mixer(0),
-	_audioSuspended(false) {
+	_audioSuspended(false),
+	_lastCallbackTime(0),
+	_adaptive(false),
+	_minSamples(0),
+	_maxSamples(0),
+	_lastUnderruns(0),
+	_lastCallbacks(0),
+	_lastCallbackTotal(0),
+	_cleanChecks(0),
+	_requestedSamples(0) {
 
 }
 
 SdlMixerManager::~SdlMixerManager() {
+	if (_adaptive)
+		g_system->getTimerManager()->removeTimerProc(adaptTimer);
+
 	_mixer->setReady(false);
 
 	SDL_CloseAudio();
@@ -61,6 +79,17 @@ void SdlMixerManager::init() {
 	// Get the desired audio specs
 	SDL_AudioSpec desired = getAudioSpec(SAMPLES_PER_SEC);
 
+	// The adaptive buffer starts at about 10 ms, and never gets larger
+	// than the fixed one
+	_adaptive = ConfMan.getBool("adaptive_audio_buffer");
+	if (_adaptive) {
+		_maxSamples = desired.samples;
+		_minSamples = 256;
+		while (_minSamples * 100 < (uint32)desired.freq && _minSamples < _maxSamples)
+			_minSamples <<= 1;
+		desired.samples = _minSamples;
+	}
+
 	// Needed as SDL_OpenAudio as of SDL-1.2.14 mutates fields in
 	// "desired" if used directly.
 	SDL_AudioSpec fmt = desired;
@@ -72,6 +101,7 @@ void SdlMixerManager::init() {
 		_mixer = new Audio::MixerImpl(g_system, desired.freq);
 		assert(_mixer);
 		_mixer->setReady(false);
+		_adaptive = false;
 	} else {
 		debug(1, "Output sample rate: %d Hz", _obtained.freq);
 		if (_obtained.freq != desired.freq)
@@ -93,9 +123,13 @@ void SdlMixerManager::init() {
 
 		_mixer = new Audio::MixerImpl(g_system, _obtained.freq);
 		assert(_mixer);
+		_mixer->setOutputBufferSize(_obtained.samples);
 		_mixer->setReady(true);
 
 		startAudio();
+
+		if (_adaptive)
+			g_system->getTimerManager()->installTimerProc(adaptTimer, ADAPT_INTERVAL, this, "sdlMixerAdapt");
 	}
 }
 
@@ -135,9 +169,110 @@ void SdlMixerManager::startAudio() {
 
 void SdlMixerManager::callbackHandler(byte *samples, int len) {
 	assert(_mixer);
+
+	// SDL does not tell about underruns. The device plays one buffer
+	// between two callbacks, so when a callback comes in much later
+	// than that, the device must have run dry meanwhile.
+	uint32 now = SDL_GetTicks();
+	uint32 period = _obtained.samples * 1000 / _obtained.freq;
+	if (_lastCallbackTime && now - _lastCallbackTime > period + period / 2 + 1)
+		_mixer->reportUnderrun();
+	_lastCallbackTime = now;
+
 	_mixer->mixCallback(samples, len);
 }
 
+bool SdlMixerManager::reopenAudio(uint16 samples) {
+	SDL_CloseAudio();
+	stopAudio();
+
+	SDL_AudioSpec desired = _obtained;
+	desired.samples = samples;
+	desired.callback = sdlCallback;
+	desired.userdata = this;
+
+	SDL_AudioSpec fmt = desired;
+	SDL_AudioSpec obtained;
+	bool reopened = false;
+	if (SDL_OpenAudio(&fmt, &obtained) == 0) {
+		// The mixer cannot change its rate, so anything but the size
+		// changing means going back to the old device settings
+		if (obtained.freq == _obtained.freq && obtained.format == _obtained.format && obtained.channels == _obtained.channels)
+			reopened = true;
+		else
+			SDL_CloseAudio();
+	}
+
+	if (reopened) {
+		_obtained = obtained;
+		debug(1, "Output buffer size: %d samples", _obtained.samples);
+	} else {
+		warning("Could not change the SDL mixer output buffer size to %d", samples);
+		fmt = _obtained;
+		if (SDL_OpenAudio(&fmt, NULL) != 0) {
+			warning("Could not open audio device: %s", SDL_GetError());
+			_mixer->setReady(false);
+			return false;
+		}
+	}
+
+	_mixer->setOutputBufferSize(_obtained.samples);
+	_lastCallbackTime = 0;
+	startAudio();
+	return reopened;
+}
+
+void SdlMixerManager::adaptBufferSize() {
+	Common::StackLock lock(_deviceMutex);
+	if (_audioSuspended || !_mixer->isReady() || _requestedSamples)
+		return;
+
+	const Audio::DurationHistogram &callbackTime = _mixer->getCallbackTime();
+	uint32 underruns = _mixer->getUnderruns();
+	uint32 callbacks = callbackTime.count;
+	uint32 callbackTotal = callbackTime.total;
+
+	// The statistics may have been reset meanwhile
+	bool valid = underruns >= _lastUnderruns && callbacks >= _lastCallbacks && callbackTotal >= _lastCallbackTotal;
+	uint32 newUnderruns = underruns - _lastUnderruns;
+	uint32 newCallbacks = callbacks - _lastCallbacks;
+	uint32 newTotal = callbackTotal - _lastCallbackTotal;
+	_lastUnderruns = underruns;
+	_lastCallbacks = callbacks;
+	_lastCallbackTotal = callbackTotal;
+	if (!valid)
+		return;
+
+	uint16 samples = _obtained.samples;
+	if (newUnderruns) {
+		_cleanChecks = 0;
+		if (samples < _maxSamples)
+			_requestedSamples = samples * 2;
+	} else if (++_cleanChecks >= ADAPT_SHRINK_CHECKS && samples > _minSamples) {
+		_cleanChecks = 0;
+		// Mixing has to take less than a quarter of the smaller period
+		uint32 period = samples / 2 * 1000 / _obtained.freq;
+		if (newCallbacks && newTotal * 4 < period * newCallbacks)
+			_requestedSamples = samples / 2;
+	}
+}
+
+void SdlMixerManager::applyBufferSize() {
+	Common::StackLock lock(_deviceMutex);
+	if (!_requestedSamples)
+		return;
+
+	uint16 samples = _requestedSamples;
+	_requestedSamples = 0;
+	if (!_audioSuspended && _mixer->isReady())
+		reopenAudio(samples);
+}
+
+void SdlMixerManager::adaptTimer(void *refCon) {
+	SdlMixerManager *manager = (SdlMixerManager *)refCon;
+	manager->adaptBufferSize();
+}
+
 void SdlMixerManager::sdlCallback(void *this_, byte *samples, int len) {
 	SdlMixerManager *manager = (SdlMixerManager *)this_;
 	assert(manager);
@@ -146,17 +281,20 @@ void SdlMixerManager::sdlCallback(void *this_, byte *samples, int len) {
 }
 
 void SdlMixerManager::suspendAudio() {
+	Common::StackLock lock(_deviceMutex);
 	SDL_CloseAudio();
 	_audioSuspended = true;
 }
 
 int SdlMixerManager::resumeAudio() {
+	Common::StackLock lock(_deviceMutex);
 	if (!_audioSuspended)
 		return -2;
 	if (SDL_OpenAudio(&_obtained, NULL) < 0){
 		return -1;
 	}
 	SDL_PauseAudio(0);
+	_lastCallbackTime = 0;
 	_audioSuspended = false;
 	return 0;
 }
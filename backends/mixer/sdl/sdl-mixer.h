@@ -25,6 +25,7 @@
 
 #include "backends/platform/sdl/sdl-sys.h"
 #include "audio/mixer_intern.h"
+#include "common/mutex.h"
 
 /**
  * SDL mixer manager. It wraps the actual implementation
@@ -59,6 +60,13 @@ public:
 	 */
 	virtual int resumeAudio();
 
+	/**
+	 * Reopens the audio device with the buffer size adaptBufferSize()
+	 * asked for, if any. Closing the device waits for the callback, so
+	 * this is done from the main thread rather than from the timer.
+	 */
+	void applyBufferSize();
+
 protected:
 	/** The mixer implementation */
 	Audio::MixerImpl *_mixer;
@@ -69,9 +77,37 @@ protected:
 	 */
 	SDL_AudioSpec _obtained;
 
+	/**
+	 * Held while opening or closing the audio device, and for the
+	 * buffer size requests
+	 */
+	Common::Mutex _deviceMutex;
+
 	/** State of the audio system */
 	bool _audioSuspended;
 
+	/** When the last callback came in, to catch late ones */
+	uint32 _lastCallbackTime;
+
+	/**
+	 * Whether the buffer size follows the underruns, between the two
+	 * sizes below. See adaptBufferSize().
+	 */
+	bool _adaptive;
+	uint16 _minSamples;
+	uint16 _maxSamples;
+
+	/** The mixer statistics at the last adaptBufferSize() */
+	uint32 _lastUnderruns;
+	uint32 _lastCallbacks;
+	uint32 _lastCallbackTotal;
+
+	/** How many adaptBufferSize() in a row found no underruns */
+	uint _cleanChecks;
+
+	/** The buffer size for applyBufferSize() to switch to, 0 if none */
+	uint16 _requestedSamples;
+
 	/**
 	 * Returns the desired audio specification
 	 */
@@ -82,6 +118,28 @@ protected:
 	 */
 	virtual void startAudio();
 
+	/**
+	 * Stops what startAudio() started besides SDL audio, once the
+	 * device has been closed
+	 */
+	virtual void stopAudio() {}
+
+	/**
+	 * Closes the audio device and opens it again with another buffer
+	 * size. Keeps the old size if the device does not take the new one
+	 * with the same format. Called with _deviceMutex held.
+	 */
+	bool reopenAudio(uint16 samples);
+
+	/**
+	 * Asks for the buffer size to be doubled after underruns, and halved
+	 * after a while without any, as long as mixing takes well under the
+	 * time the smaller buffer plays. Called from a timer.
+	 */
+	void adaptBufferSize();
+
+	static void adaptTimer(void *refCon);
+
 	/**
 	 * Handles the audio callback
 	 */
@@ -157,6 +157,9 @@ void registerDefaults() {
 	ConfMan.registerDefault("speech_mute", false);
 	ConfMan.registerDefault("mute", false);
 
+	ConfMan.registerDefault("resampler", "linear");
+	ConfMan.registerDefault("adaptive_audio_buffer", false);
+
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
 	ConfMan.registerDefault("enable_gs", false);
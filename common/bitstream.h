@@ -28,6 +28,7 @@
 #include "common/scummsys.h"
 #include "common/textconsole.h"
 #include "common/stream.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -67,6 +68,9 @@ public:
 	/** Add a bit to the value x, making it an n+1-bit value. */
 	virtual void addBit(uint32 &x, uint32 n) = 0;
 
+	/** Are the bits handed out MSB to LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -127,6 +131,32 @@ private:
 			_value <<= 32 - valueBits;
 		}
 
+	/** The number of bits left in the current value. */
+	inline uint32 bitsLeft() const {
+		return (_inValue == 0) ? 0 : valueBits - _inValue;
+	}
+
+	/** The next n bits of the current value, with n < 32. */
+	inline uint32 valueBitsPeek(uint32 n) const {
+		if (n == 0)
+			return 0;
+
+		if (isMSB2LSB)
+			return _value >> (32 - n);
+
+		return _value & ((1u << n) - 1);
+	}
+
+	/** Drop the next n bits of the current value, with n <= bitsLeft(). */
+	inline void valueBitsSkip(uint32 n) {
+		if (isMSB2LSB)
+			_value <<= n;
+		else
+			_value >>= n;
+
+		_inValue = (_inValue + n) % valueBits;
+	}
+
 public:
 	/** Create a bit stream using this input data stream and optionally delete it on destruction. */
 	BitStreamImpl(SeekableReadStream *stream, bool disposeAfterUse = false) :
@@ -191,6 +221,13 @@ public:
 		if (n > 32)
 			error("BitStreamImpl::getBits(): Too many bits requested to be read");
 
+		// All the bits are in the current value
+		if (n <= bitsLeft()) {
+			uint32 v = valueBitsPeek(n);
+			valueBitsSkip(n);
+			return v;
+		}
+
 		// Read the number of bits
 		uint32 v = 0;
 
@@ -225,19 +262,43 @@ public:
 	/**
 	 * Read a multi-bit value from the bit stream, without changing the stream's position.
 	 *
-	 * The bit order is the same as in getBits().
+	 * The bit order is the same as in getBits(). Bits past the end of the
+	 * stream read as 0, so that a decoder can always peek as far as its
+	 * longest code.
 	 */
 	uint32 peekBits(uint8 n) {
-		uint32 value   = _value;
-		uint8  inValue = _inValue;
-		uint32 curPos  = _stream->pos();
-
-		uint32 v = getBits(n);
+		if (n > 32)
+			error("BitStreamImpl::peekBits(): Too many bits requested to be read");
+
+		// All the bits are in the current value
+		const uint32 left = bitsLeft();
+		if (n <= left)
+			return valueBitsPeek(n);
+
+		// Take the rest from the following values
+		uint32 v = valueBitsPeek(left);
+		uint32 curPos = _stream->pos();
+		uint32 endPos = _stream->size() & ~((uint32) ((valueBits >> 3) - 1));
+
+		for (uint32 have = left; have < n; ) {
+			uint32 data = 0;
+			if ((uint32)_stream->pos() < endPos)
+				data = readData();
+
+			uint32 count = MIN<uint32>(n - have, valueBits);
+			if (isMSB2LSB) {
+				data <<= 32 - valueBits;
+				v = (count == 32) ? data : ((v << count) | (data >> (32 - count)));
+			} else {
+				if (count < 32)
+					data &= (1u << count) - 1;
+				v |= data << have;
+			}
+
+			have += count;
+		}
 
 		_stream->seek(curPos);
-		_inValue = inValue;
-		_value   = value;
-
 		return v;
 	}
 
@@ -272,8 +333,23 @@ public:
 
 	/** Skip the specified amount of bits. */
 	void skip(uint32 n) {
-		while (n-- > 0)
-			getBit();
+		while (n > 0) {
+			const uint32 left = bitsLeft();
+			if (left == 0) {
+				// Read the next value
+				getBit();
+				n--;
+				continue;
+			}
+
+			const uint32 count = MIN(n, left);
+			valueBitsSkip(count);
+			n -= count;
+		}
+	}
+
+	bool isMSBFirst() const {
+		return isMSB2LSB;
 	}
 
 	/** Return the stream position in bits. */
@@ -58,6 +58,17 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 		// And put the pointer to the symbol/code struct into the symbol list.
 		_symbols[i] = &_codes[lengths[i] - 1].back();
 	}
+
+	// The second-level tables grow with the longest code
+	_prefixBits = 0;
+	if (maxLength <= kMaxTableLength) {
+		if (maxLength < kPrefixBits)
+			_prefixBits = maxLength;
+		else
+			_prefixBits = kPrefixBits;
+	}
+
+	buildTables();
 }
 
 Huffman::~Huffman() {
@@ -66,9 +77,120 @@ Huffman::~Huffman() {
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (uint32 i = 0; i < _symbols.size(); i++)
 		_symbols[i]->symbol = symbols ? *symbols++ : i;
+
+	buildTables();
+}
+
+void Huffman::buildTables() {
+	if (_prefixBits == 0)
+		return;
+
+	// The codes only make sense in one of the bit orders, in which they
+	// are a prefix code. In the other one, they overlap.
+	for (int i = 0; i < 2; i++)
+		if (!buildTable(i == 1))
+			_tables[i].clear();
+}
+
+bool Huffman::buildTable(bool msbFirst) {
+	Table &table = _tables[msbFirst ? 1 : 0];
+	table.clear();
+	table.resize(1 << _prefixBits);
+
+	const uint8 subBits = _codes.size() - _prefixBits;
+
+	for (uint32 i = 0; i < _codes.size(); i++) {
+		const uint8 length = i + 1;
+
+		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode) {
+			if (length <= _prefixBits) {
+				if (!fillTable(table, 0, _prefixBits, msbFirst, cCode->code, length, cCode->symbol, length))
+					return false;
+				continue;
+			}
+
+			// The first bits of the code, in the first-level table, and the rest
+			const uint8 restLength = length - _prefixBits;
+			uint32 prefix, rest;
+			if (msbFirst) {
+				prefix = cCode->code >> restLength;
+				rest   = cCode->code & ((1 << restLength) - 1);
+			} else {
+				prefix = cCode->code & ((1 << _prefixBits) - 1);
+				rest   = cCode->code >> _prefixBits;
+			}
+
+			if (table[prefix].length != 0)
+				return false;
+
+			if (table[prefix].symbol == 0) {
+				table[prefix].symbol = table.size();
+				table.resize(table.size() + (1 << subBits));
+			}
+
+			if (!fillTable(table, table[prefix].symbol, subBits, msbFirst, rest, restLength, cCode->symbol, length))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool Huffman::fillTable(Table &table, uint32 offset, uint8 tableBits, bool msbFirst,
+                        uint32 code, uint8 codeLength, uint32 symbol, uint8 length) {
+	// The bits after the code can be anything
+	const uint32 count = 1 << (tableBits - codeLength);
+	for (uint32 i = 0; i < count; i++) {
+		uint32 index = msbFirst ? ((code << (tableBits - codeLength)) | i) : (code | (i << codeLength));
+		if (table[offset + index].length != 0)
+			return false;
+
+		table[offset + index].symbol = symbol;
+		table[offset + index].length = length;
+	}
+
+	return true;
+}
+
+uint32 Huffman::getSymbol(uint32 bits, bool msbFirst, uint8 &length) const {
+	const Table &table = _tables[msbFirst ? 1 : 0];
+	assert(!table.empty());
+
+	const uint8 subBits = _codes.size() - _prefixBits;
+
+	const TableEntry *entry;
+	if (msbFirst)
+		entry = &table[bits >> subBits];
+	else
+		entry = &table[bits & ((1 << _prefixBits) - 1)];
+
+	if (entry->length == 0 && entry->symbol != 0) {
+		if (msbFirst)
+			entry = &table[entry->symbol + (bits & ((1 << subBits) - 1))];
+		else
+			entry = &table[entry->symbol + (bits >> _prefixBits)];
+	}
+
+	if (entry->length == 0)
+		error("Unknown Huffman code");
+
+	length = entry->length;
+	return entry->symbol;
 }
 
 uint32 Huffman::getSymbol(BitStream &bits) const {
+	if (_tables[bits.isMSBFirst() ? 1 : 0].empty())
+		return getSymbolSlow(bits);
+
+	// Near the end of the stream, the bits after the code may be past it
+	uint8 length;
+	uint32 symbol = getSymbol(bits.peekBits(_codes.size()), bits.isMSBFirst(), length);
+	bits.skip(length);
+
+	return symbol;
+}
+
+uint32 Huffman::getSymbolSlow(BitStream &bits) const {
 	uint32 code = 0;
 
 	for (uint32 i = 0; i < _codes.size(); i++) {
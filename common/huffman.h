@@ -58,7 +58,24 @@ public:
 	/** Return the next symbol in the bitstream. */
 	uint32 getSymbol(BitStream &bits) const;
 
+	/**
+	 * Return the symbol whose code starts the given bits, for a decoder
+	 * which has its own bit reader. bits holds the next getMaxLength()
+	 * bits of the stream, in the order in which BitStream::peekBits()
+	 * would return them. The length of the code, for the decoder to skip,
+	 * is returned in length.
+	 */
+	uint32 getSymbol(uint32 bits, bool msbFirst, uint8 &length) const;
+
+	/** The length of the longest code. */
+	uint8 getMaxLength() const { return _codes.size(); }
+
 private:
+	/** Codes up to this length are resolved by the first table lookup. */
+	static const uint8 kPrefixBits = 9;
+	/** Longer codes than this are not put into tables. */
+	static const uint8 kMaxTableLength = 20;
+
 	struct Symbol {
 		uint32 code;
 		uint32 symbol;
@@ -66,6 +83,20 @@ private:
 		Symbol(uint32 c, uint32 s);
 	};
 
+	/**
+	 * An entry of the lookup tables. An entry without a length either
+	 * points to the second-level table of the codes longer than
+	 * kPrefixBits which start with it, or is not the start of any code.
+	 */
+	struct TableEntry {
+		uint32 symbol; ///< The symbol, or the offset of the second-level table
+		uint8 length;  ///< The length of the code
+
+		TableEntry() : symbol(0), length(0) {}
+	};
+
+	typedef Array<TableEntry> Table;
+
 	typedef List<Symbol> CodeList;
 	typedef Array<CodeList> CodeLists;
 	typedef Array<Symbol *> SymbolList;
@@ -75,6 +106,26 @@ private:
 
 	/** Sorted list of pointers to the symbols. */
 	SymbolList _symbols;
+
+	/** Bits indexing the first-level tables, or 0 without tables. */
+	uint8 _prefixBits;
+	/**
+	 * The first and second-level lookup tables, for the LSB first and the
+	 * MSB first bit orders, one after the other. The table of a bit order
+	 * in which the codes are not a prefix code stays empty.
+	 */
+	Table _tables[2];
+
+	/** Fill the lookup tables from the codes. */
+	void buildTables();
+	/** Fill the lookup table of a bit order, or return false if the codes overlap in it. */
+	bool buildTable(bool msbFirst);
+	/** Store a symbol into all the entries which start with its code, unless one is already taken. */
+	static bool fillTable(Table &table, uint32 offset, uint8 tableBits, bool msbFirst,
+	                      uint32 code, uint8 codeLength, uint32 symbol, uint8 length);
+
+	/** Return the next symbol, walking the codes a bit at a time. */
+	uint32 getSymbolSlow(BitStream &bits) const;
 };
 
 } // End of namespace Common
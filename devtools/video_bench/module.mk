@@ -0,0 +1,21 @@
+
+MODULE := devtools/video_bench
+
+MODULE_OBJS := \
+	video_bench.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := video_bench
+
+# The SMUSH decoder is part of the Grim engine, so it is only there when the
+# engine is linked in statically
+ifeq ($(ENABLE_GRIM), STATIC_PLUGIN)
+TOOL_DEPS := engines/grim/libgrim.a
+devtools/video_bench/video_bench.o: CPPFLAGS += -DVIDEO_BENCH_SMUSH
+endif
+
+TOOL_DEPS += video/libvideo.a audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+TOOL_LIBS := $(LIBS) -lpthread
+
+# Include common rules
+include $(srcdir)/rules.mk
@@ -0,0 +1,747 @@
+/* Residual - A 3D game interpreter
+ *
+ * Residual is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ * A headless benchmark of the video decoders. It decodes Bink and SMUSH
+ * videos, and JPEG images, as fast as it can, and reports the time spent
+ * loading, decoding and converting the frames for the renderer, with the
+ * peak memory use of the process.
+ *
+ * The SIMD kernels are picked by the compiler flags, so the scalar code is
+ * measured with a build for a target without them.
+ */
+
+// Disable symbol overrides so that we can use system headers
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/scummsys.h"
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/zlib.h"
+
+#include "audio/mixer_intern.h"
+
+#include "graphics/jpeg.h"
+#include "graphics/pixelbuffer.h"
+#include "graphics/surface.h"
+
+#ifdef USE_BINK
+#include "video/bink_decoder.h"
+#include "video/threaded_video_decoder.h"
+#endif
+
+#ifdef VIDEO_BENCH_SMUSH
+#include "engines/grim/movie/codecs/smush_decoder.h"
+#endif
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static uint64 getMicros() {
+	timeval tv;
+	gettimeofday(&tv, 0);
+	return (uint64)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/** The peak resident memory of the process, in KB. */
+static long getPeakMemory() {
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * Runs the timer procs from a thread of their own, as the backends do, so
+ * that the decoders which decode ahead from a timer do so here as well.
+ */
+class BenchTimerManager : public Common::TimerManager {
+public:
+	BenchTimerManager();
+	~BenchTimerManager();
+
+	bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
+	void removeTimerProc(TimerProc proc);
+
+private:
+	struct TimerSlot {
+		TimerProc proc;
+		int32 interval;
+		void *refCon;
+		uint64 nextTime;
+	};
+
+	Common::Array<TimerSlot> _slots;
+	pthread_mutex_t _mutex; ///< Held while the procs run
+	pthread_t _thread;
+	bool _threadStarted;
+	bool _quit;
+
+	static void *threadProc(void *timerManager);
+	void run();
+};
+
+BenchTimerManager::BenchTimerManager() : _threadStarted(false), _quit(false) {
+	pthread_mutex_init(&_mutex, 0);
+}
+
+BenchTimerManager::~BenchTimerManager() {
+	pthread_mutex_lock(&_mutex);
+	_quit = true;
+	pthread_mutex_unlock(&_mutex);
+
+	if (_threadStarted)
+		pthread_join(_thread, 0);
+
+	pthread_mutex_destroy(&_mutex);
+}
+
+bool BenchTimerManager::installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id) {
+	pthread_mutex_lock(&_mutex);
+
+	TimerSlot slot;
+	slot.proc = proc;
+	slot.interval = interval;
+	slot.refCon = refCon;
+	slot.nextTime = getMicros() + interval;
+	_slots.push_back(slot);
+
+	// The thread is only needed once something uses a timer
+	if (!_threadStarted)
+		_threadStarted = pthread_create(&_thread, 0, &threadProc, this) == 0;
+
+	pthread_mutex_unlock(&_mutex);
+	return _threadStarted;
+}
+
+void BenchTimerManager::removeTimerProc(TimerProc proc) {
+	pthread_mutex_lock(&_mutex);
+	for (uint i = 0; i < _slots.size(); ) {
+		if (_slots[i].proc == proc)
+			_slots.remove_at(i);
+		else
+			i++;
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+void *BenchTimerManager::threadProc(void *timerManager) {
+	((BenchTimerManager *)timerManager)->run();
+	return 0;
+}
+
+void BenchTimerManager::run() {
+	pthread_mutex_lock(&_mutex);
+	while (!_quit) {
+		const uint64 now = getMicros();
+		for (uint i = 0; i < _slots.size(); i++) {
+			if (now >= _slots[i].nextTime) {
+				_slots[i].nextTime = now + _slots[i].interval;
+				_slots[i].proc(_slots[i].refCon);
+			}
+		}
+
+		pthread_mutex_unlock(&_mutex);
+		usleep(1000);
+		pthread_mutex_lock(&_mutex);
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+/**
+ * A backend without a screen. The sound the decoders queue is mixed away
+ * between the frames, so that it does not pile up in memory.
+ */
+class BenchSystem : public OSystem {
+public:
+	BenchSystem(const Graphics::PixelFormat &format);
+	~BenchSystem();
+
+	void initBackend();
+
+	/** Mix and throw away the queued sound. */
+	void drainAudio();
+
+	const GraphicsMode *getSupportedGraphicsModes() const { return _graphicsModes; }
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return mode == 0; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return _format; }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const;
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	void launcherInitSize(uint width, uint height) {}
+	Graphics::PixelBuffer setupScreen(int screenW, int screenH, bool fullscreen, bool accel3d) { return Graphics::PixelBuffer(); }
+	int16 getHeight() { return 480; }
+	int16 getWidth() { return 640; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const byte *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return _format; }
+	void clearOverlay() {}
+	void grabOverlay(OverlayColor *buf, int pitch) {}
+	void copyRectToOverlay(const OverlayColor *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 480; }
+	int16 getOverlayWidth() { return 640; }
+
+	bool showMouse(bool visible) { return false; }
+	bool lockMouse(bool lock) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const byte *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, int cursorTargetScale, const Graphics::PixelFormat *format) {}
+
+	uint32 getMillis() { return (uint32)((getMicros() - _startTime) / 1000); }
+	void delayMillis(uint msecs) { usleep(msecs * 1000); }
+	void getTimeAndDate(TimeDate &t) const;
+
+	MutexRef createMutex();
+	void lockMutex(MutexRef mutex) { pthread_mutex_lock((pthread_mutex_t *)mutex); }
+	void unlockMutex(MutexRef mutex) { pthread_mutex_unlock((pthread_mutex_t *)mutex); }
+	void deleteMutex(MutexRef mutex);
+
+	Audio::Mixer *getMixer() { return _mixer; }
+
+	void quit() { exit(0); }
+	void displayMessageOnOSD(const char *msg) {}
+	void logMessage(LogMessageType::Type type, const char *message);
+
+private:
+	static const GraphicsMode _graphicsModes[];
+
+	Graphics::PixelFormat _format;
+	Audio::MixerImpl *_mixer;
+	uint64 _startTime;
+};
+
+const OSystem::GraphicsMode BenchSystem::_graphicsModes[] = {
+	{ "headless", "Headless", 0 },
+	{ 0, 0, 0 }
+};
+
+BenchSystem::BenchSystem(const Graphics::PixelFormat &format) : _format(format), _mixer(0) {
+	_startTime = getMicros();
+}
+
+BenchSystem::~BenchSystem() {
+	delete _mixer;
+}
+
+void BenchSystem::initBackend() {
+	// The mutexes of both need g_system
+	_timerManager = new BenchTimerManager();
+
+	_mixer = new Audio::MixerImpl(this, 44100);
+	_mixer->setReady(true);
+}
+
+void BenchSystem::drainAudio() {
+	byte samples[4096];
+	while (_mixer->mixCallback(samples, sizeof(samples)) > 0)
+		;
+}
+
+Common::List<Graphics::PixelFormat> BenchSystem::getSupportedFormats() const {
+	Common::List<Graphics::PixelFormat> formats;
+	formats.push_back(_format);
+	return formats;
+}
+
+void BenchSystem::getTimeAndDate(TimeDate &t) const {
+	memset(&t, 0, sizeof(t));
+}
+
+OSystem::MutexRef BenchSystem::createMutex() {
+	// The mutexes of the backends are recursive
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+	pthread_mutex_t *mutex = new pthread_mutex_t;
+	pthread_mutex_init(mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	return (MutexRef)mutex;
+}
+
+void BenchSystem::deleteMutex(MutexRef mutex) {
+	pthread_mutex_destroy((pthread_mutex_t *)mutex);
+	delete (pthread_mutex_t *)mutex;
+}
+
+void BenchSystem::logMessage(LogMessageType::Type type, const char *message) {
+	fputs(message, stderr);
+}
+
+struct BenchOptions {
+	Graphics::PixelFormat format; ///< The format the renderer takes the frames in
+	const char *formatName;
+	bool threaded;                ///< Decode Bink videos ahead from a timer
+	int runs;                     ///< Only the fastest run of each file is reported
+	uint32 maxFrames;             ///< 0 for all of them
+};
+
+/** Times in microseconds, and memory in KB. */
+struct BenchResult {
+	const char *codec;
+	uint16 width, height;
+	uint32 frames;
+	uint64 loadTime;
+	uint64 decodeTime;
+	uint64 convertTime;
+	uint64 maxFrameTime;
+	long processPeakMemory;       ///< of the whole process, up to the end of this file
+};
+
+static void resetResult(BenchResult &result, const char *codec) {
+	memset(&result, 0, sizeof(result));
+	result.codec = codec;
+}
+
+/**
+ * Convert a frame into the format of the renderer, the way the movie
+ * player does it for the renderer, if the decoder did not do so already.
+ */
+static void convertFrame(const Graphics::Surface &frame, Graphics::Surface &dst, const Graphics::PixelFormat &format) {
+	if (frame.format == format)
+		return;
+
+	if (dst.w != frame.w || dst.h != frame.h) {
+		dst.free();
+		dst.create(frame.w, frame.h, format);
+	}
+
+	for (int y = 0; y < frame.h; y++) {
+		Graphics::PixelBuffer src(frame.format, (byte *)const_cast<void *>(frame.getBasePtr(0, y)));
+		Graphics::PixelBuffer dstRow(format, (byte *)dst.getBasePtr(0, y));
+		dstRow.copyBuffer(0, frame.w, src);
+	}
+}
+
+static void decodeFrames(Video::VideoDecoder &decoder, const BenchOptions &options, BenchResult &result) {
+	result.width = decoder.getWidth();
+	result.height = decoder.getHeight();
+
+	Graphics::Surface converted;
+	while (!decoder.endOfVideo() && (!options.maxFrames || result.frames < options.maxFrames)) {
+		const uint64 start = getMicros();
+		const Graphics::Surface *frame = decoder.decodeNextFrame();
+		const uint64 decoded = getMicros();
+
+		if (!frame)
+			break;
+
+		convertFrame(*frame, converted, options.format);
+		const uint64 end = getMicros();
+
+		result.decodeTime += decoded - start;
+		result.convertTime += end - decoded;
+		result.maxFrameTime = MAX(result.maxFrameTime, end - start);
+		result.frames++;
+
+		((BenchSystem *)g_system)->drainAudio();
+	}
+
+	converted.free();
+}
+
+#ifdef USE_BINK
+static bool benchBink(Common::SeekableReadStream *stream, const BenchOptions &options, BenchResult &result) {
+	resetResult(result, options.threaded ? "Bink/MT" : "Bink");
+
+	// The decoder may own the stream already when loading fails, so it is
+	// not deleted here
+	const uint64 start = getMicros();
+	if (options.threaded) {
+		Video::ThreadedVideoDecoder decoder(new Video::BinkDecoder());
+		if (!decoder.loadStream(stream, options.format))
+			return false;
+
+		result.loadTime = getMicros() - start;
+		decodeFrames(decoder, options, result);
+	} else {
+		Video::BinkDecoder decoder;
+		if (!decoder.loadStream(stream, options.format))
+			return false;
+
+		result.loadTime = getMicros() - start;
+		decodeFrames(decoder, options, result);
+	}
+
+	return true;
+}
+#endif
+
+#ifdef VIDEO_BENCH_SMUSH
+static bool benchSmush(Common::SeekableReadStream *stream, bool demo, const BenchOptions &options, BenchResult &result) {
+	resetResult(result, demo ? "SMUSH/8" : "SMUSH/16");
+
+	Grim::SmushDecoder decoder;
+	decoder.setDemo(demo);
+
+	const uint64 start = getMicros();
+	if (!decoder.loadStream(stream))
+		return false;
+
+	result.loadTime = getMicros() - start;
+	decodeFrames(decoder, options, result);
+	return true;
+}
+#endif
+
+static bool benchJPEG(Common::SeekableReadStream *stream, const BenchOptions &options, BenchResult &result) {
+	resetResult(result, "JPEG");
+
+	Graphics::JPEG jpeg;
+
+	const uint64 start = getMicros();
+	bool loaded = jpeg.read(stream);
+	const uint64 decoded = getMicros();
+
+	Graphics::Surface *surface = loaded ? jpeg.getSurface(options.format) : 0;
+	const uint64 end = getMicros();
+
+	delete stream;
+	if (!surface)
+		return false;
+
+	result.width = jpeg.getWidth();
+	result.height = jpeg.getHeight();
+	result.frames = 1;
+	result.decodeTime = decoded - start;
+	result.convertTime = end - decoded;
+	result.maxFrameTime = end - start;
+
+	surface->free();
+	delete surface;
+	return true;
+}
+
+enum FileType {
+	kFileUnknown,
+	kFileBink,
+	kFileSmush,
+	kFileSmushDemo,
+	kFileJPEG
+};
+
+static FileType detectFileType(const byte *data, uint32 size) {
+	if (size < 4)
+		return kFileUnknown;
+
+	// The SMUSH videos of the full game are compressed
+	if (data[0] == 0x1F && data[1] == 0x8B) {
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(new Common::MemoryReadStream(data, size));
+		uint32 tag = stream->readUint32BE();
+		delete stream;
+
+		return (tag == MKTAG('S','A','N','M')) ? kFileSmush : kFileUnknown;
+	}
+
+	const uint32 tag = READ_BE_UINT32(data);
+	if (tag == MKTAG('B','I','K','f') || tag == MKTAG('B','I','K','g') || tag == MKTAG('B','I','K','h') || tag == MKTAG('B','I','K','i'))
+		return kFileBink;
+	if (tag == MKTAG('S','A','N','M'))
+		return kFileSmush;
+	if (tag == MKTAG('A','N','I','M'))
+		return kFileSmushDemo;
+	if (data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF)
+		return kFileJPEG;
+
+	return kFileUnknown;
+}
+
+/** Returns the reason when the file could not be decoded, or 0. */
+static const char *benchData(const byte *data, uint32 size, const BenchOptions &options, BenchResult &result) {
+	const FileType type = detectFileType(data, size);
+	if (type == kFileUnknown)
+		return "unknown format";
+
+	for (int run = 0; run < options.runs; run++) {
+		// Compressed files are decompressed while decoding, as in the engine
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(new Common::MemoryReadStream(data, size));
+
+		BenchResult current;
+		bool decoded = false;
+		switch (type) {
+		case kFileBink:
+#ifdef USE_BINK
+			decoded = benchBink(stream, options, current);
+			break;
+#else
+			delete stream;
+			return "Bink support is disabled";
+#endif
+		case kFileSmush:
+		case kFileSmushDemo:
+#ifdef VIDEO_BENCH_SMUSH
+			decoded = benchSmush(stream, type == kFileSmushDemo, options, current);
+			break;
+#else
+			delete stream;
+			return "SMUSH needs the Grim engine built in";
+#endif
+		case kFileJPEG:
+			decoded = benchJPEG(stream, options, current);
+			break;
+		default:
+			break;
+		}
+
+		if (!decoded)
+			return "failed to decode";
+
+		const uint64 total = current.decodeTime + current.convertTime;
+		if (run == 0 || total < result.decodeTime + result.convertTime)
+			result = current;
+	}
+
+	result.processPeakMemory = getPeakMemory();
+	return 0;
+}
+
+static bool readFile(const char *path, byte *&data, uint32 &size) {
+	FILE *file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (length <= 0) {
+		fclose(file);
+		return false;
+	}
+
+	size = (uint32)length;
+	data = (byte *)malloc(size);
+	bool success = data && fread(data, 1, size, file) == size;
+	fclose(file);
+
+	if (!success) {
+		free(data);
+		data = 0;
+	}
+
+	return success;
+}
+
+static void collectFiles(const Common::String &path, Common::Array<Common::String> &files) {
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0) {
+		fprintf(stderr, "Cannot open %s\n", path.c_str());
+		return;
+	}
+
+	if (!S_ISDIR(st.st_mode)) {
+		files.push_back(path);
+		return;
+	}
+
+	DIR *dir = opendir(path.c_str());
+	if (!dir)
+		return;
+
+	Common::Array<Common::String> entries;
+	while (dirent *entry = readdir(dir)) {
+		if (entry->d_name[0] != '.')
+			entries.push_back(path + "/" + entry->d_name);
+	}
+	closedir(dir);
+
+	// Sorted, so that the reports of two builds line up
+	Common::sort(entries.begin(), entries.end());
+	for (uint i = 0; i < entries.size(); i++)
+		collectFiles(entries[i], files);
+}
+
+static double toMillis(uint64 micros) {
+	return micros / 1000.0;
+}
+
+static void printResult(const char *name, const BenchResult &result) {
+	const uint64 total = result.decodeTime + result.convertTime;
+	const double fps = total ? result.frames * 1000000.0 / total : 0.0;
+
+	printf("%-28s %-8s %4dx%-4d %7u %9.1f %9.2f %9.2f %10.2f %10.2f %10.2f %15ld\n",
+		name, result.codec, result.width, result.height, result.frames, fps,
+		result.frames ? toMillis(total) / result.frames : 0.0, toMillis(result.maxFrameTime),
+		toMillis(result.loadTime), toMillis(result.decodeTime), toMillis(result.convertTime),
+		result.processPeakMemory);
+}
+
+static const char *getSIMDName() {
+	// The same checks as the decoders do to pick their kernels
+#if defined(__SSE2__)
+	return "SSE2";
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+static void printUsage(const char *name) {
+	printf("Usage: %s [options] <file or directory>...\n"
+		"\n"
+		"Decodes Bink and SMUSH videos, and JPEG images, as fast as possible and\n"
+		"reports the time spent in each stage, per file:\n"
+		"  load     parsing the headers of the container\n"
+		"  decode   decoding the frames, including the sound and, for Bink, the\n"
+		"           YUV conversion into the output format\n"
+		"  convert  converting the frames into the output format\n"
+		"The process peak is the peak memory of the whole process up to the end\n"
+		"of the file, so it only ever grows.\n"
+		"\n"
+		"Options:\n"
+		"  -f, --format <fmt>  output format: rgb565 (default), rgb555 or rgba8888\n"
+		"  -t, --threaded      decode Bink videos ahead from a timer thread\n"
+		"  -r, --runs <n>      decode each file n times and report the fastest run\n"
+		"  -n, --frames <n>    decode at most n frames of each video\n"
+		"  -h, --help          show this help\n",
+		name);
+}
+
+static bool parseFormat(const char *name, BenchOptions &options) {
+	if (!strcmp(name, "rgb565"))
+		options.format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	else if (!strcmp(name, "rgb555"))
+		options.format = Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0);
+	else if (!strcmp(name, "rgba8888"))
+		options.format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+	else
+		return false;
+
+	options.formatName = name;
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	BenchOptions options;
+	parseFormat("rgb565", options);
+	options.threaded = false;
+	options.runs = 1;
+	options.maxFrames = 0;
+
+	Common::Array<Common::String> files;
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+
+		if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+			printUsage(argv[0]);
+			return 0;
+		} else if (!strcmp(arg, "-t") || !strcmp(arg, "--threaded")) {
+			options.threaded = true;
+		} else if ((!strcmp(arg, "-f") || !strcmp(arg, "--format")) && hasValue) {
+			if (!parseFormat(argv[++i], options)) {
+				fprintf(stderr, "Unknown format %s\n", argv[i]);
+				return 1;
+			}
+		} else if ((!strcmp(arg, "-r") || !strcmp(arg, "--runs")) && hasValue) {
+			options.runs = MAX(atoi(argv[++i]), 1);
+		} else if ((!strcmp(arg, "-n") || !strcmp(arg, "--frames")) && hasValue) {
+			options.maxFrames = MAX(atoi(argv[++i]), 0);
+		} else if (arg[0] == '-') {
+			printUsage(argv[0]);
+			return 1;
+		} else {
+			collectFiles(arg, files);
+		}
+	}
+
+	if (files.empty()) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	BenchSystem *system = new BenchSystem(options.format);
+	g_system = system;
+	system->initBackend();
+
+	printf("Output format %s, %s kernels, %s decoding, best of %d run(s)\n\n",
+		options.formatName, getSIMDName(), options.threaded ? "threaded" : "synchronous", options.runs);
+	printf("%-28s %-8s %9s %7s %9s %9s %9s %10s %10s %10s %15s\n",
+		"file", "codec", "size", "frames", "fps", "avg ms", "max ms", "load ms", "decode ms", "convert ms", "process peak KB");
+
+	uint32 totalFrames = 0;
+	uint64 totalTime = 0;
+	int failures = 0;
+
+	for (uint i = 0; i < files.size(); i++) {
+		byte *data;
+		uint32 size;
+		if (!readFile(files[i].c_str(), data, size)) {
+			fprintf(stderr, "%s: cannot read\n", files[i].c_str());
+			failures++;
+			continue;
+		}
+
+		BenchResult result = BenchResult();
+		const char *error = benchData(data, size, options, result);
+		free(data);
+
+		// Only the file name fits into the table
+		const char *name = strrchr(files[i].c_str(), '/');
+		name = name ? name + 1 : files[i].c_str();
+
+		if (error) {
+			fprintf(stderr, "%s: %s\n", files[i].c_str(), error);
+			failures++;
+			continue;
+		}
+
+		printResult(name, result);
+		totalFrames += result.frames;
+		totalTime += result.decodeTime + result.convertTime;
+	}
+
+	if (totalTime)
+		printf("\n%u frames in %.2f ms, %.1f frames/s, peak memory %ld KB\n",
+			totalFrames, toMillis(totalTime), totalFrames * 1000000.0 / totalTime, getPeakMemory());
+
+	delete system;
+	g_system = 0;
+
+	return failures ? 1 : 0;
+}
@@ -141,6 +141,29 @@ void BitmapData::load() {
 	_loaded = true;
 }
 
+void BitmapData::releaseTexture() {
+	if (!_loaded) {
+		return;
+	}
+	g_driver->destroyBitmap(this);
+	_texIds = NULL;
+	_numTex = 0;
+
+	// The drivers convert the image data in place while creating the
+	// textures, so it can't be handed to a different one.
+	if (_bitmaps && _bitmaps->contains(_fname) && (*_bitmaps)[_fname] == this) {
+		delete[] _data;
+		_data = NULL;
+		_loaded = false;
+	}
+}
+
+void BitmapData::restoreTexture() {
+	if (_loaded && _data && !_texIds) {
+		g_driver->createBitmap(this);
+	}
+}
+
 bool BitmapData::loadGrimBm(Common::SeekableReadStream *data) {
 	uint32 tag2 = data->readUint32BE();
 	if(tag2 != (MKTAG('F','\0','\0','\0')))
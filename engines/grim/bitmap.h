@@ -51,6 +51,14 @@ public:
 
 	void load();
 
+	/**
+	 * Destroys the driver-side copy of the bitmap, before switching renderer.
+	 * Bitmaps read from a file are read again the next time they are drawn,
+	 * the other ones are uploaded again by restoreTexture().
+	 */
+	void releaseTexture();
+	void restoreTexture();
+
 	/**
 	 * Loads an EMI TILE-bitmap.
 	 *
@@ -138,6 +146,9 @@ public:
 	int getNumTex() const { return _data->_numTex; }
 	const Graphics::PixelFormat &getPixelFormat(int num) const;
 
+	void releaseTexture() { _data->releaseTexture(); }
+	void restoreTexture() { _data->restoreTexture(); }
+
 	void saveState(SaveGame *state) const;
 	void restoreState(SaveGame *state);
 
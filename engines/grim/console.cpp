@@ -0,0 +1,218 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
+#define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+#include "audio/audiostats.h"
+#include "audio/decodeahead.h"
+
+#include "engines/grim/console.h"
+#include "engines/grim/grim.h"
+
+#include "engines/grim/imuse/imuse.h"
+
+#include "engines/grim/lua/lmem.h"
+#include "engines/grim/lua/lprofile.h"
+
+namespace Grim {
+
+Console::Console(GrimEngine *vm) : GUI::Debugger(), _vm(vm), _audioStatsLogging(false) {
+	DCmd_Register("luaMemory",			WRAP_METHOD(Console, Cmd_LuaMemory));
+	DCmd_Register("luaProfile",			WRAP_METHOD(Console, Cmd_LuaProfile));
+	DCmd_Register("audioStats",			WRAP_METHOD(Console, Cmd_AudioStats));
+}
+
+Console::~Console() {
+	stopAudioStats();
+}
+
+static const char *const soundTypeNames[] = { "plain", "music", "sfx", "speech" };
+
+/*
+** The report of the audio statistics, one line each, for both the console
+** and the log. Times come from getMillis(): a single mixer callback is
+** often measured as 0 ms, but the sums over many are right on average.
+*/
+static void audioStatsReport(Common::Array<Common::String> &lines) {
+	Audio::MixerStats stats;
+	g_system->getMixer()->getStats(stats);
+
+	uint32 period = stats.bufferSamples * 1000 / stats.outputRate;
+	lines.push_back(Common::String::format("Output: %u Hz, %u frames (%u ms) buffered, %u underruns",
+	                                       stats.outputRate, stats.bufferSamples, period, stats.underruns));
+	lines.push_back("Mixer callback ms: " + stats.callbackTime.format());
+	if (period && stats.callbackTime.count) {
+		double average = (double)stats.callbackTime.total / stats.callbackTime.count;
+		lines.push_back(Common::String::format("Mixer load: %.1f%% average, %u%% peak of the buffer period",
+		                                       average * 100 / period, stats.callbackTime.max * 100 / period));
+	}
+
+	lines.push_back("  handle    id   type    calls  total ms    frames");
+	for (uint i = 0; i < stats.channels.size(); i++) {
+		const Audio::MixerChannelStats &c = stats.channels[i];
+		lines.push_back(Common::String::format("%8u %5d %6s%s %8u %9u %9u", c.handle, c.id, soundTypeNames[c.type],
+		                                       c.paused ? "*" : " ", c.mixCalls, c.mixMillis, c.samples));
+	}
+
+	Common::Array<Audio::QueueStats> queues;
+	Audio::getQueueStats(queues);
+	lines.push_back("   queue   rate ch depth  peak  starved");
+	for (uint i = 0; i < queues.size(); i++) {
+		const Audio::QueueStats &q = queues[i];
+		lines.push_back(Common::String::format("%8u %6d %2d %5u %5u %8u", q.serial, q.rate, q.stereo ? 2 : 1,
+		                                       q.depth, q.peakDepth, q.starved));
+	}
+	lines.push_back(Common::String::format("Decode ahead underruns: %u", Audio::getDecodeAheadUnderruns()));
+
+	if (g_imuse) {
+		lines.push_back("iMUSE lock wait ms: " + g_imuse->getLockWaitTime().format());
+		lines.push_back("iMUSE callback ms: " + g_imuse->getCallbackTime().format());
+	}
+}
+
+static void audioStatsLogger(void *) {
+	Common::Array<Common::String> lines;
+	audioStatsReport(lines);
+	for (uint i = 0; i < lines.size(); i++)
+		debug("%s", lines[i].c_str());
+}
+
+void Console::stopAudioStats() {
+	if (_audioStatsLogging) {
+		g_system->getTimerManager()->removeTimerProc(audioStatsLogger);
+		_audioStatsLogging = false;
+	}
+	for (uint i = 0; i < _loadHandles.size(); i++)
+		g_system->getMixer()->stopHandle(_loadHandles[i]);
+	_loadHandles.clear();
+}
+
+bool Console::Cmd_LuaMemory(int argc, const char **argv) {
+	if (argc >= 2 && !strcmp(argv[1], "compact")) {
+		luaM_compact();
+		DebugPrintf("Released unused pool pages\n");
+		return true;
+	}
+
+	DebugPrintf("class   live   peak      bytes     allocs      frees\n");
+	int32 totalBytes = 0;
+	for (int i = 0; i <= LUAM_NUMCLASSES; i++) {
+		const luaM_ClassStats &s = luaM_classstats[i];
+		if (s.chunkSize)
+			DebugPrintf("%5d", s.chunkSize);
+		else
+			DebugPrintf("  big");
+		DebugPrintf(" %6d %6d %10d %10u %10u\n", s.live, s.peak, s.liveBytes, s.allocs, s.frees);
+		totalBytes += s.liveBytes;
+	}
+	DebugPrintf("Total live bytes: %d\n", totalBytes);
+
+	return true;
+}
+
+bool Console::Cmd_LuaProfile(int argc, const char **argv) {
+	if (argc < 2) {
+		DebugPrintf("Usage: %s start|stop|reset|report [count]|folded <file>\n", argv[0]);
+		DebugPrintf("The profiler is %s\n", lua_profiling ? "running" : "stopped");
+		return true;
+	}
+
+	if (!strcmp(argv[1], "start")) {
+		luaP_start();
+	} else if (!strcmp(argv[1], "stop")) {
+		luaP_stop();
+	} else if (!strcmp(argv[1], "reset")) {
+		luaP_reset();
+	} else if (!strcmp(argv[1], "report")) {
+		uint count = argc >= 3 ? atoi(argv[2]) : 20;
+		Common::Array<luaP_Entry> report;
+		luaP_getreport(report);
+		DebugPrintf("    calls   incl ms   excl ms    alloc  function\n");
+		for (uint i = 0; i < report.size() && i < count; i++) {
+			const luaP_Entry &e = report[i];
+			DebugPrintf("%9u %9u %9u %8u  %s\n", e.calls, e.inclusive, e.exclusive, e.allocBytes, e.name.c_str());
+		}
+	} else if (!strcmp(argv[1], "folded") && argc >= 3) {
+		if (luaP_dumpfolded(argv[2]))
+			DebugPrintf("Folded stacks written to %s\n", argv[2]);
+		else
+			DebugPrintf("Cannot write %s\n", argv[2]);
+	} else {
+		DebugPrintf("Unknown command %s\n", argv[1]);
+	}
+
+	return true;
+}
+
+bool Console::Cmd_AudioStats(int argc, const char **argv) {
+	if (argc < 2 || !strcmp(argv[1], "report")) {
+		Common::Array<Common::String> lines;
+		audioStatsReport(lines);
+		for (uint i = 0; i < lines.size(); i++)
+			DebugPrintf("%s\n", lines[i].c_str());
+		if (argc < 2)
+			DebugPrintf("Usage: %s report|reset|log <seconds>|log off|load <streams>\n", argv[0]);
+	} else if (!strcmp(argv[1], "reset")) {
+		g_system->getMixer()->resetStats();
+		Audio::resetQueueStats();
+		if (g_imuse)
+			g_imuse->resetStats();
+	} else if (!strcmp(argv[1], "log") && argc >= 3) {
+		if (_audioStatsLogging) {
+			g_system->getTimerManager()->removeTimerProc(audioStatsLogger);
+			_audioStatsLogging = false;
+		}
+		int seconds = atoi(argv[2]);
+		if (seconds > 0) {
+			g_system->getTimerManager()->installTimerProc(audioStatsLogger, seconds * 1000000, NULL, "audioStatsLog");
+			_audioStatsLogging = true;
+			DebugPrintf("Logging the audio statistics every %d seconds\n", seconds);
+		}
+	} else if (!strcmp(argv[1], "load") && argc >= 3) {
+		// Triangle waves at a mix of rates, played at volume 0, to see
+		// how much headroom the mixer has left
+		static const int rates[] = { 11025, 22050, 44100, 48000 };
+		for (uint i = 0; i < _loadHandles.size(); i++)
+			g_system->getMixer()->stopHandle(_loadHandles[i]);
+		_loadHandles.clear();
+
+		int streams = atoi(argv[2]);
+		for (int i = 0; i < streams; i++) {
+			Audio::SoundHandle handle;
+			Audio::AudioStream *stream = Audio::makeLoadStream(rates[i % ARRAYSIZE(rates)], (i & 1) != 0);
+			g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, &handle, stream, -1, 0);
+			_loadHandles.push_back(handle);
+		}
+		DebugPrintf("Playing %d load streams\n", streams);
+	} else {
+		DebugPrintf("Unknown command %s\n", argv[1]);
+	}
+
+	return true;
+}
+
+} // end of namespace Grim
@@ -0,0 +1,55 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ */
+
+#ifndef GRIM_CONSOLE_H
+#define GRIM_CONSOLE_H
+
+#include "common/array.h"
+
+#include "audio/mixer.h"
+
+#include "gui/debugger.h"
+
+namespace Grim {
+
+class GrimEngine;
+
+class Console : public GUI::Debugger {
+public:
+	Console(GrimEngine *vm);
+	virtual ~Console();
+
+private:
+	GrimEngine *_vm;
+	bool _audioStatsLogging;
+	Common::Array<Audio::SoundHandle> _loadHandles;
+
+	void stopAudioStats();
+
+	bool Cmd_LuaMemory(int argc, const char **argv);
+	bool Cmd_LuaProfile(int argc, const char **argv);
+	bool Cmd_AudioStats(int argc, const char **argv);
+};
+
+} // end of namespace Grim
+
+#endif
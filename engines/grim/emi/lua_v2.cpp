@@ -426,6 +426,9 @@ struct luaL_reg monkeyMainOpcodes[] = {
 	{ "ImStateHasEnded", LUA_OPCODE(Lua_V2, ImStateHasEnded) },
 	{ "ImPushState", LUA_OPCODE(Lua_V2, ImPushState) },
 	{ "ImPopState", LUA_OPCODE(Lua_V2, ImPopState) },
+	{ "PreloadVoice", LUA_OPCODE(Lua_V2, PreloadVoice) },
+	{ "PreloadMusicState", LUA_OPCODE(Lua_V2, PreloadMusicState) },
+	{ "FlushPreloadedSounds", LUA_OPCODE(Lua_V2, FlushPreloadedSounds) },
 	{ "ImFlushStack", LUA_OPCODE(Lua_V2, ImFlushStack) },
 	{ "ImGetMillisecondPosition", LUA_OPCODE(Lua_V2, ImGetMillisecondPosition) },
 	{ "GetSectorName", LUA_OPCODE(Lua_V2, GetSectorName) },
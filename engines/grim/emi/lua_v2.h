@@ -121,6 +121,9 @@ protected:
 	DECLARE_LUA_OPCODE(ImStateHasEnded);
 	DECLARE_LUA_OPCODE(ImPushState);
 	DECLARE_LUA_OPCODE(ImPopState);
+	DECLARE_LUA_OPCODE(PreloadVoice);
+	DECLARE_LUA_OPCODE(PreloadMusicState);
+	DECLARE_LUA_OPCODE(FlushPreloadedSounds);
 	DECLARE_LUA_OPCODE(GetSectorName);
 	DECLARE_LUA_OPCODE(GetCameraPosition);
 	DECLARE_LUA_OPCODE(GetCameraYaw);
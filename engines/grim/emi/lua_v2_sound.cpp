@@ -325,4 +325,35 @@ void Lua_V2::ImPopState() {
 	warning("Lua_V2::ImPopState: implement opcode");
 }
 
+// ResidualVM specific: takes the messages of the upcoming SayLine calls, and
+// opens their voices ahead of time. Returns whether all of them are preloaded.
+void Lua_V2::PreloadVoice() {
+	bool result = true;
+	for (int i = 1; lua_isstring(lua_getparam(i)); i++) {
+		char msgId[50];
+		LuaBase::instance()->parseMsgText(lua_getstring(lua_getparam(i)), msgId);
+		if (!msgId[0])
+			continue;
+
+		Common::String soundName = msgId;
+		soundName += ".wVC";
+		if (!g_sound->preloadVoice(soundName.c_str()))
+			result = false;
+	}
+	pushbool(result);
+}
+
+// ResidualVM specific: opens the music of a state ahead of ImSetState
+void Lua_V2::PreloadMusicState() {
+	lua_Object stateObj = lua_getparam(1);
+	if (!lua_isnumber(stateObj))
+		return;
+
+	pushbool(g_sound->preloadMusicState((int)lua_getnumber(stateObj)));
+}
+
+void Lua_V2::FlushPreloadedSounds() {
+	g_sound->flushPreloaded();
+}
+
 } // end of namespace Grim
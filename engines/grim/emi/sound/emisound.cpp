@@ -20,8 +20,10 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/stream.h"
 #include "common/mutex.h"
+#include "common/util.h"
 #include "audio/audiostream.h"
 #include "audio/decoders/raw.h"
 #include "audio/mixer.h"
@@ -36,6 +38,10 @@
 #include "engines/grim/emi/sound/vimatrack.h"
 
 #define NUM_CHANNELS 32
+// Bytes of sound files kept in memory by the preloader
+#define PRELOAD_BUDGET (8 * 1024 * 1024)
+// How many of the following lines to preload when a voice starts
+#define PRELOAD_AHEAD 2
 
 namespace Grim {
 
@@ -47,10 +53,13 @@ EMISound::EMISound() {
 		_channels[i] = NULL;
 	}
 	_music = NULL;
+	_preloadSize = 0;
+	_preloadTick = 0;
 	initMusicTable();
 }
 	
 EMISound::~EMISound() {
+	flushPreloaded();
 	for (int i = 0; i < NUM_CHANNELS; i++) {
 		freeChannel(i);
 	}
@@ -84,6 +93,14 @@ bool EMISound::startVoice(const char *soundName, int volume, int pan) {
 	int channel = getFreeChannel();
 	assert(channel != -1);
 	
+	queueNextVoices(soundName);
+
+	_channels[channel] = takePreloaded(soundName);
+	if (_channels[channel]) {
+		_channels[channel]->play();
+		return true;
+	}
+
 	_channels[channel] = new VimaTrack(soundName);
 	
 	Common::SeekableReadStream *str = g_resourceloader->openNewStreamFile(soundName);
@@ -95,6 +112,44 @@ bool EMISound::startVoice(const char *soundName, int volume, int pan) {
 	return false;
 }
 
+void EMISound::queueNextVoices(const Common::String &soundName) {
+	// The lines of a dialog have consecutive message ids, like "mot012"
+	// and "mot013", which are the names of their voice files
+	const char *name = soundName.c_str();
+	const char *ext = strrchr(name, '.');
+	if (!ext)
+		return;
+
+	const char *digits = ext;
+	while (digits > name && Common::isDigit(digits[-1]))
+		digits--;
+	const int width = ext - digits;
+	if (width == 0 || width > 6)
+		return;
+
+	const Common::String prefix(name, digits);
+	const int number = atoi(digits);
+	for (int i = 1; i <= PRELOAD_AHEAD; i++) {
+		Common::String next = prefix + Common::String::format("%0*d", width, number + i) + ext;
+		// Keep what is preloaded already from being dropped first
+		if (touchPreloaded(next))
+			continue;
+		if (Common::find(_preloadQueue.begin(), _preloadQueue.end(), next) == _preloadQueue.end())
+			_preloadQueue.push_back(next);
+	}
+}
+
+void EMISound::preloadQueued() {
+	if (_preloadQueue.empty())
+		return;
+
+	Common::String soundName = _preloadQueue.front();
+	_preloadQueue.pop_front();
+	// A missing file just means that the dialog does not go on
+	if (getChannelByName(soundName) == -1)
+		preloadVoice(soundName.c_str());
+}
+
 bool EMISound::getSoundStatus(const char *soundName) {
 	int32 channel = getChannelByName(soundName);
 	
@@ -114,7 +169,11 @@ void EMISound::stopSound(const char *soundName) {
 int32 EMISound::getPosIn60HzTicks(const char *soundName) {	
 	int32 channel = getChannelByName(soundName);
 	assert(channel != -1);
-	return g_system->getMixer()->getSoundElapsedTime(*_channels[channel]->getHandle());
+	// The mixer counts what it has mixed, which is only heard once the
+	// output buffer of the backend has been played
+	uint32 elapsed = g_system->getMixer()->getSoundElapsedTime(*_channels[channel]->getHandle());
+	uint32 latency = g_system->getMixer()->getOutputLatency();
+	return elapsed > latency ? elapsed - latency : 0;
 }
 	
 void EMISound::setVolume(const char *soundName, int volume) {
@@ -135,20 +194,145 @@ void EMISound::setMusicState(int stateId) {
 	if (stateId == 0 || (_musicTable != NULL && _musicTable[stateId]._id != stateId)) {
 		return;
 	}
-	Common::String filename;
+	Common::String filename = getMusicFilename(stateId);
+	_music = takePreloaded(_musicPrefix + filename);
+	if (_music) {
+		_music->play();
+		return;
+	}
+
+	_music = createMusicTrack();
+	Common::SeekableReadStream *str = g_resourceloader->openNewStreamFile(_musicPrefix + filename);
+
+	if (_music->openSound(filename, str))
+		_music->play();
+}
+
+Common::String EMISound::getMusicFilename(int stateId) {
 	if (g_grim->getGamePlatform() == Common::kPlatformPS2) {
 		warning("PS2 doesn't have musictable yet %d ignored, just playing 1195.SCX", stateId);
 		// So, we just rig up the menu-song hardcoded for now, as a test of the SCX-code.
-		filename = "1195.SCX";
-		_music = new SCXTrack(Audio::Mixer::kMusicSoundType);
+		return "1195.SCX";
 	} else {
-		filename = _musicTable[stateId]._filename;
-		_music = new MP3Track(Audio::Mixer::kMusicSoundType);	
+		return _musicTable[stateId]._filename;
 	}
-	Common::SeekableReadStream *str = g_resourceloader->openNewStreamFile(_musicPrefix + filename);
+}
 
-	if (_music->openSound(filename, str))
-		_music->play();
+SoundTrack *EMISound::createMusicTrack() {
+	if (g_grim->getGamePlatform() == Common::kPlatformPS2)
+		return new SCXTrack(Audio::Mixer::kMusicSoundType);
+	else
+		return new MP3Track(Audio::Mixer::kMusicSoundType);
+}
+
+Common::SeekableReadStream *EMISound::readSoundFile(const Common::String &filename) {
+	Common::SeekableReadStream *file = g_resourceloader->openNewStreamFile(filename);
+	if (!file)
+		return NULL;
+
+	// The voice and music files are read in pieces while playing, so
+	// reading them from memory saves seeking around in the archives too
+	Common::SeekableReadStream *data = file->readStream(file->size());
+	delete file;
+	return data;
+}
+
+bool EMISound::addPreloaded(const Common::String &name, SoundTrack *track, uint32 size) {
+	if (size > PRELOAD_BUDGET) {
+		delete track;
+		return false;
+	}
+
+	// Make room, least recently used first
+	while (_preloadSize + size > PRELOAD_BUDGET) {
+		PreloadMap::iterator oldest = _preloaded.begin();
+		for (PreloadMap::iterator i = _preloaded.begin(); i != _preloaded.end(); ++i) {
+			if (i->_value.lastUse < oldest->_value.lastUse)
+				oldest = i;
+		}
+		_preloadSize -= oldest->_value.size;
+		delete oldest->_value.track;
+		_preloaded.erase(oldest);
+	}
+
+	PreloadedTrack &entry = _preloaded[name];
+	entry.track = track;
+	entry.size = size;
+	entry.lastUse = _preloadTick++;
+	_preloadSize += size;
+	return true;
+}
+
+bool EMISound::touchPreloaded(const Common::String &name) {
+	PreloadMap::iterator i = _preloaded.find(name);
+	if (i == _preloaded.end())
+		return false;
+
+	i->_value.lastUse = _preloadTick++;
+	return true;
+}
+
+SoundTrack *EMISound::takePreloaded(const Common::String &name) {
+	PreloadMap::iterator i = _preloaded.find(name);
+	if (i == _preloaded.end())
+		return NULL;
+
+	SoundTrack *track = i->_value.track;
+	_preloadSize -= i->_value.size;
+	_preloaded.erase(i);
+	return track;
+}
+
+bool EMISound::preloadVoice(const char *soundName) {
+	if (touchPreloaded(soundName))
+		return true;
+
+	Common::SeekableReadStream *str = readSoundFile(soundName);
+	if (!str)
+		return false;
+
+	uint32 size = str->size();
+	SoundTrack *track = new VimaTrack(soundName);
+	if (!track->openSound(soundName, str)) {
+		delete track;
+		return false;
+	}
+	return addPreloaded(soundName, track, size);
+}
+
+bool EMISound::preloadMusicState(int stateId) {
+	if (stateId == 0 || (_musicTable != NULL && _musicTable[stateId]._id != stateId))
+		return false;
+
+#ifndef USE_MAD
+	// The MP3 music can not be played anyway
+	if (g_grim->getGamePlatform() != Common::kPlatformPS2)
+		return false;
+#endif
+
+	Common::String filename = getMusicFilename(stateId);
+	if (touchPreloaded(_musicPrefix + filename))
+		return true;
+
+	Common::SeekableReadStream *str = readSoundFile(_musicPrefix + filename);
+	if (!str)
+		return false;
+
+	uint32 size = str->size();
+	SoundTrack *track = createMusicTrack();
+	if (!track->openSound(filename, str)) {
+		delete track;
+		return false;
+	}
+	return addPreloaded(_musicPrefix + filename, track, size);
+}
+
+void EMISound::flushPreloaded() {
+	for (PreloadMap::iterator i = _preloaded.begin(); i != _preloaded.end(); ++i)
+		delete i->_value.track;
+	_preloaded.clear();
+	_preloadSize = 0;
+	_preloadQueue.clear();
 }
 
 uint32 EMISound::getMsPos(int stateId) {
@@ -24,6 +24,13 @@
 #define GRIM_MSS_H
 
 #include "common/str.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+
+namespace Common {
+class SeekableReadStream;
+}
 
 namespace Grim {
 
@@ -44,16 +51,38 @@ struct MusicEntry {
 // from Actor, to allow for splitting that into EMI-sound and iMuse without
 // changing iMuse.
 class EMISound {
+	// A track opened ahead of time, waiting to be played
+	struct PreloadedTrack {
+		SoundTrack *track;
+		uint32 size;
+		uint32 lastUse;
+	};
+	typedef Common::HashMap<Common::String, PreloadedTrack> PreloadMap;
+
 	SoundTrack **_channels;
 	SoundTrack *_music;
 	MusicEntry *_musicTable;
 	Common::String _musicPrefix;
 
+	PreloadMap _preloaded;
+	uint32 _preloadSize;
+	uint32 _preloadTick;
+	// Voices likely to be asked for next, to be preloaded one per frame
+	Common::List<Common::String> _preloadQueue;
+
 	void removeItem(SoundTrack* item);
 	int32 getFreeChannel();
 	int32 getChannelByName(Common::String name);
 	void freeChannel(int32 channel);
 	void initMusicTable();
+
+	Common::String getMusicFilename(int stateId);
+	SoundTrack *createMusicTrack();
+	Common::SeekableReadStream *readSoundFile(const Common::String &filename);
+	bool addPreloaded(const Common::String &name, SoundTrack *track, uint32 size);
+	SoundTrack *takePreloaded(const Common::String &name);
+	bool touchPreloaded(const Common::String &name);
+	void queueNextVoices(const Common::String &soundName);
 public:
 	EMISound();
 	~EMISound();
@@ -67,6 +96,23 @@ public:
 
 	void setMusicState(int stateId);
 	uint32 getMsPos(int stateId);
+
+	/**
+	 * Read a voice or the music of a state into memory and open it, so that
+	 * startVoice() or setMusicState() can start it right away. The preloaded
+	 * tracks are kept within a byte budget, dropping the least recently used
+	 * ones first. Asking for a track which is preloaded already counts as
+	 * using it.
+	 */
+	bool preloadVoice(const char *soundName);
+	bool preloadMusicState(int stateId);
+	void flushPreloaded();
+
+	/**
+	 * Preload the next voice queued by startVoice(), which queues the lines
+	 * following the one it starts. Called once per frame.
+	 */
+	void preloadQueued();
 };
 	
 }
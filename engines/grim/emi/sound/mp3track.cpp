@@ -24,6 +24,7 @@
 #include "common/textconsole.h"
 #include "audio/mixer.h"
 #include "audio/audiostream.h"
+#include "audio/decodeahead.h"
 #include "audio/decoders/mp3.h"
 #include "engines/grim/resource.h"
 #include "engines/grim/emi/sound/mp3track.h"
@@ -67,7 +68,7 @@ bool MP3Track::openSound(Common::String soundName, Common::SeekableReadStream *f
 	}
 	_soundName = soundName;
 	parseRIFFHeader(file);
-	_stream = Audio::makeLoopingAudioStream(Audio::makeMP3Stream(file, DisposeAfterUse::YES), 0);
+	_stream = Audio::makeDecodeAheadStream(Audio::makeMP3Stream(file, DisposeAfterUse::YES), DisposeAfterUse::YES, 0);
 	_handle = new Audio::SoundHandle();
 	return true;
 #endif
@@ -24,6 +24,7 @@
 #include "common/str.h"
 #include "common/stream.h"
 #include "audio/mixer.h"
+#include "audio/audiostream.h"
 #include "engines/grim/emi/sound/track.h"
 
 namespace Grim {
@@ -31,6 +32,13 @@ namespace Grim {
 SoundTrack::SoundTrack() {
 	_stream = NULL;
 	_handle = NULL;
+	_played = false;
+}
+
+SoundTrack::~SoundTrack() {
+	// A preloaded track may be thrown away without ever being played
+	if (!_played)
+		delete _stream;
 }
 	
 Common::String SoundTrack::getSoundName() {
@@ -44,6 +52,7 @@ void SoundTrack::setSoundName(Common::String name) {
 bool SoundTrack::play() {
 	if (_stream) {
 		g_system->getMixer()->playStream(_soundType, _handle, _stream);
+		_played = true;
 		return true;
 	}
 	return false;
@@ -45,9 +45,11 @@ protected:
 	Audio::AudioStream *_stream;
 	Audio::SoundHandle *_handle;
 	Audio::Mixer::SoundType _soundType;
+	// Once played, the mixer owns the stream
+	bool _played;
 public:
 	SoundTrack();
-	virtual ~SoundTrack() { };
+	virtual ~SoundTrack();
 	virtual bool openSound(Common::String voiceName, Common::SeekableReadStream *file) = 0;
 	virtual bool isPlaying() = 0;
 	virtual bool play();
@@ -121,10 +121,10 @@ int32 VimaTrack::getDataFromRegion(SoundDesc *sound, int region, byte **buf, int
 		sound->endFlag = false;
 	}
 	
+	*buf = (byte *)malloc(sizeof(byte) * size);
 	if (sound->mcmpData) {
-		size = sound->mcmpMgr->decompressSample(region_offset + offset, size, buf);
+		size = sound->mcmpMgr->decompressSample(region_offset + offset, size, *buf);
 	} else {
-		*buf = (byte *)malloc(sizeof(byte) * size);
 		sound->inStream->seek(region_offset + offset + sound->headerSize, SEEK_SET);
 		sound->inStream->read(*buf, size);
 	}
@@ -99,6 +99,16 @@ void Font::load(const Common::String &filename, Common::SeekableReadStream *data
 	g_driver->createFont(this);
 }
 
+void Font::releaseTexture() {
+	g_driver->destroyFont(this);
+	_userData = NULL;
+}
+
+void Font::restoreTexture() {
+	if (_charIndex)
+		g_driver->createFont(this);
+}
+
 uint16 Font::getCharIndex(unsigned char c) const {
 	uint16 c2 = uint16(c);
 
@@ -59,6 +59,10 @@ public:
 	void *getUserData() { return _userData; }
 	void setUserData(void *data) { _userData = data; }
 
+	// Recreate the driver-side data when switching renderer
+	void releaseTexture();
+	void restoreTexture();
+
 	void saveState(SaveGame *state) const;
 	void restoreState(SaveGame *state);
 
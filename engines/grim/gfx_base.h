@@ -225,6 +225,12 @@ public:
 	 */
 	virtual void releaseMovieFrame() = 0;
 
+	/**
+	 * The pixel format of the movie-frames which prepareMovieFrame()
+	 * takes without converting them.
+	 */
+	virtual Graphics::PixelFormat getMovieFramePixelFormat() const = 0;
+
 	virtual const char *getVideoDeviceName() = 0;
 
 	virtual void saveState(SaveGame *state);
@@ -1101,25 +1101,25 @@ void GfxOpenGL::prepareMovieFrame(Graphics::Surface* frame) {
 	int width = frame->w;
 	byte *bitmap = (byte *)frame->pixels;
 
-	// remove if already exist
-	if (_smushNumTex > 0) {
-		glDeleteTextures(_smushNumTex, _smushTexIds);
-		delete[] _smushTexIds;
-		_smushNumTex = 0;
-	}
-
-	// create texture
-	_smushNumTex = ((width + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE) *
-		((height + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE);
-	_smushTexIds = new GLuint[_smushNumTex];
-	glGenTextures(_smushNumTex, _smushTexIds);
-	for (int i = 0; i < _smushNumTex; i++) {
-		glBindTexture(GL_TEXTURE_2D, _smushTexIds[i]);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, BITMAP_TEXTURE_SIZE, BITMAP_TEXTURE_SIZE, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, NULL);
+	// The textures of the previous frame are reused if the size is the same
+	if (_smushNumTex == 0 || width != _smushTexWidth || height != _smushTexHeight) {
+		releaseMovieFrame();
+
+		// create texture
+		_smushNumTex = ((width + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE) *
+			((height + (BITMAP_TEXTURE_SIZE - 1)) / BITMAP_TEXTURE_SIZE);
+		_smushTexIds = new GLuint[_smushNumTex];
+		glGenTextures(_smushNumTex, _smushTexIds);
+		for (int i = 0; i < _smushNumTex; i++) {
+			glBindTexture(GL_TEXTURE_2D, _smushTexIds[i]);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, BITMAP_TEXTURE_SIZE, BITMAP_TEXTURE_SIZE, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, NULL);
+		}
+		_smushTexWidth = width;
+		_smushTexHeight = height;
 	}
 
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
@@ -1198,6 +1198,11 @@ void GfxOpenGL::releaseMovieFrame() {
 	}
 }
 
+Graphics::PixelFormat GfxOpenGL::getMovieFramePixelFormat() const {
+	// The textures are uploaded as they are
+	return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+}
+
 void GfxOpenGL::loadEmergFont() {
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
@@ -119,6 +119,7 @@ public:
 	void prepareMovieFrame(Graphics::Surface* frame);
 	void drawMovieFrame(int offsetX, int offsetY);
 	void releaseMovieFrame();
+	Graphics::PixelFormat getMovieFramePixelFormat() const;
 
 protected:
 	void drawDepthBitmap(int x, int y, int w, int h, char *data);
@@ -128,6 +129,8 @@ private:
 	GLuint *_smushTexIds;
 	int _smushWidth;
 	int _smushHeight;
+	int _smushTexWidth;
+	int _smushTexHeight;
 	byte *_storedDisplay;
 	bool _useDepthShader;
 	GLuint _fragmentProgram;
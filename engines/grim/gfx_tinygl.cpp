@@ -1026,12 +1026,21 @@ void GfxTinyGL::prepareMovieFrame(Graphics::Surface* frame) {
 	_smushWidth = frame->w;
 	_smushHeight = frame->h;
 
-	Graphics::PixelBuffer srcBuf(frame->format, (byte *)frame->pixels);
-	_smushBitmap.create(_pixelFormat, frame->w * frame->h, DisposeAfterUse::YES);
-	_smushBitmap.copyBuffer(0, frame->w * frame->h, srcBuf);
+	if (frame->format == _pixelFormat) {
+		// The movie player keeps the frame until the next one is prepared
+		_smushBitmap = Graphics::PixelBuffer(_pixelFormat, (byte *)frame->pixels);
+	} else {
+		Graphics::PixelBuffer srcBuf(frame->format, (byte *)frame->pixels);
+		_smushBuffer.create(_pixelFormat, frame->w * frame->h, DisposeAfterUse::YES);
+		_smushBuffer.copyBuffer(0, frame->w * frame->h, srcBuf);
+		_smushBitmap = _smushBuffer;
+	}
 }
 
 void GfxTinyGL::drawMovieFrame(int offsetX, int offsetY) {
+	if (!_smushBitmap)
+		return;
+
 	if (_smushWidth == _gameWidth && _smushHeight == _gameHeight) {
 		_zb->pbuf.copyBuffer(0, _gameWidth * _gameHeight, _smushBitmap);
 	} else {
@@ -1040,6 +1049,13 @@ void GfxTinyGL::drawMovieFrame(int offsetX, int offsetY) {
 }
 
 void GfxTinyGL::releaseMovieFrame() {
+	// _smushBitmap may point into a frame of the movie player
+	_smushBitmap = Graphics::PixelBuffer();
+	_smushBuffer.free();
+}
+
+Graphics::PixelFormat GfxTinyGL::getMovieFramePixelFormat() const {
+	return _pixelFormat;
 }
 
 void GfxTinyGL::loadEmergFont() {
@@ -112,6 +112,7 @@ public:
 	void prepareMovieFrame(Graphics::Surface* frame);
 	void drawMovieFrame(int offsetX, int offsetY);
 	void releaseMovieFrame();
+	Graphics::PixelFormat getMovieFramePixelFormat() const;
 
 	void selectScreenBuffer();
 	void selectCleanBuffer();
@@ -122,6 +123,7 @@ protected:
 private:
 	TinyGL::ZBuffer *_zb;
 	Graphics::PixelBuffer _smushBitmap;
+	Graphics::PixelBuffer _smushBuffer; // Movie-frames converted to the screen format
 	int _smushWidth;
 	int _smushHeight;
 	Graphics::PixelBuffer _storedDisplay;
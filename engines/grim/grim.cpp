@@ -42,6 +42,7 @@
 #include "common/events.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/memstream.h"
 #include "common/config-manager.h"
 
 #include "graphics/pixelbuffer.h"
@@ -52,6 +53,7 @@
 #include "engines/engine.h"
 
 #include "engines/grim/debug.h"
+#include "engines/grim/console.h"
 #include "engines/grim/grim.h"
 #include "engines/grim/lua.h"
 #include "engines/grim/lua_v1.h"
@@ -65,6 +67,7 @@
 #include "engines/grim/gfx_base.h"
 #include "engines/grim/bitmap.h"
 #include "engines/grim/font.h"
+#include "engines/grim/material.h"
 #include "engines/grim/primitives.h"
 #include "engines/grim/objectstate.h"
 #include "engines/grim/set.h"
@@ -135,6 +138,7 @@ GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, C
 	_savedState = NULL;
 	_fps[0] = 0;
 	_iris = new Iris();
+	_console = new Console(this);
 
 	Color c(0, 0, 0);
 
@@ -194,6 +198,7 @@ GrimEngine::~GrimEngine() {
 	delete g_driver;
 	g_driver = NULL;
 	delete _iris;
+	delete _console;
 
 	DebugMan.clearAllDebugChannels();
 }
@@ -440,10 +445,8 @@ void GrimEngine::updateDisplayScene() {
 	if (_mode == SmushMode) {
 		if (g_movie->isPlaying()) {
 			_movieTime = g_movie->getMovieTime();
-			if (g_movie->isUpdateNeeded()) {
+			if (g_movie->isUpdateNeeded())
 				g_driver->prepareMovieFrame(g_movie->getDstSurface());
-				g_movie->clearUpdateNeeded();
-			}
 			int frame = g_movie->getFrame();
 			if (frame >= 0) {
 				if (frame != _prevSmushFrame) {
@@ -492,10 +495,8 @@ void GrimEngine::updateDisplayScene() {
 		// up when he's next to Glottis's service room
 		if (g_movie->isPlaying()) {
 			_movieTime = g_movie->getMovieTime();
-			if (g_movie->isUpdateNeeded()) {
+			if (g_movie->isUpdateNeeded())
 				g_driver->prepareMovieFrame(g_movie->getDstSurface());
-				g_movie->clearUpdateNeeded();
-			}
 			if (g_movie->getFrame() >= 0)
 				g_driver->drawMovieFrame(g_movie->getX(), g_movie->getY());
 			else
@@ -608,9 +609,13 @@ void GrimEngine::mainLoop() {
 
 			EngineMode mode = getMode();
 
-			_savegameFileName = "";
-			savegameSave();
-			clearPools();
+			// Keep the game state as it is and only hand the driver side
+			// data over to the new renderer
+			Common::MemoryWriteStreamDynamic driverState(DisposeAfterUse::YES);
+			SaveGame *state = SaveGame::openForSaving(&driverState, DisposeAfterUse::NO);
+			g_driver->saveState(state);
+			delete state;
+			releaseDriverData();
 
 			delete g_driver;
 			if (tolower(g_registry->get("soft_renderer", "false")[0]) == 't') {
@@ -620,7 +625,12 @@ void GrimEngine::mainLoop() {
 			}
 
 			g_driver->setupScreen(screenWidth, screenHeight, fullscreen);
-			savegameRestore();
+
+			Common::MemoryReadStream driverStateReader(driverState.getData(), driverState.size());
+			state = SaveGame::openForLoading(&driverStateReader, DisposeAfterUse::NO);
+			g_driver->restoreState(state);
+			delete state;
+			restoreDriverData();
 
 			if (mode == DrawMode) {
 				setMode(GrimEngine::NormalMode);
@@ -645,6 +655,10 @@ void GrimEngine::mainLoop() {
 					if (_mode != DrawMode && _mode != SmushMode && (event.kbd.ascii == 'q')) {
 						handleExit();
 						break;
+					} else if (event.kbd.keycode == Common::KEYCODE_d && (event.kbd.flags & Common::KBD_CTRL)) {
+						_console->attach();
+						_console->onFrame();
+						continue;
 					} else {
 						handleChars(type, event.kbd.keycode, event.kbd.flags, event.kbd.ascii);
 					}
@@ -675,6 +689,9 @@ void GrimEngine::mainLoop() {
 			g_imuseState = -1;
 		}
 
+		// The frame limiter below makes up for the time this takes
+		g_sound->preloadQueued();
+
 		uint32 endTime = g_system->getMillis();
 		if (startTime > endTime)
 			continue;
@@ -702,6 +719,40 @@ void GrimEngine::loadGame(const Common::String &file) {
 	_savegameLoadRequest = true;
 }
 
+void GrimEngine::releaseDriverData() {
+	foreach (Bitmap *b, Bitmap::getPool()) {
+		b->releaseTexture();
+	}
+	foreach (Font *f, Font::getPool()) {
+		f->releaseTexture();
+	}
+	foreach (TextObject *t, TextObject::getPool()) {
+		t->destroy();
+	}
+	if (MaterialData::_materials) {
+		for (Common::List<MaterialData *>::iterator i = MaterialData::_materials->begin(); i != MaterialData::_materials->end(); ++i) {
+			(*i)->releaseTextures();
+		}
+	}
+	g_driver->releaseMovieFrame();
+}
+
+void GrimEngine::restoreDriverData() {
+	// Text objects and materials are created again when they are drawn,
+	// and bitmaps read from a file when they are loaded again.
+	foreach (Bitmap *b, Bitmap::getPool()) {
+		b->restoreTexture();
+	}
+	foreach (Font *f, Font::getPool()) {
+		f->restoreTexture();
+	}
+	if (g_movie->isPlaying() && g_movie->getFrame() >= 0) {
+		g_driver->prepareMovieFrame(g_movie->getDstSurface());
+		_prevSmushFrame = -1;
+	}
+	_shortFrame = true;
+}
+
 void GrimEngine::savegameRestore() {
 	debug("GrimEngine::savegameRestore() started.");
 	_savegameLoadRequest = false;
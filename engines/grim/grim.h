@@ -36,6 +36,7 @@
 namespace Grim {
 
 class Actor;
+class Console;
 class SaveGame;
 class Bitmap;
 class Font;
@@ -155,6 +156,7 @@ public:
 
 	// Engine APIs
 	bool hasFeature(EngineFeature f) const;
+	virtual GUI::Debugger *getDebugger() { return (GUI::Debugger *)_console; }
 
 	Common::StringArray _listFiles;
 	Common::StringArray::const_iterator _listFilesIter;
@@ -179,11 +181,16 @@ private:
 
 	void storeSaveGameImage(SaveGame *savedState);
 
+	void releaseDriverData();
+	void restoreDriverData();
+
 	bool _savegameLoadRequest;
 	bool _savegameSaveRequest;
 	Common::String _savegameFileName;
 	SaveGame *_savedState;
 
+	Console *_console;
+
 	Set *_currSet;
 	EngineMode _mode, _previousMode;
 	SpeechMode _speechMode;
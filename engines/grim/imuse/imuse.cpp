@@ -39,7 +39,6 @@ namespace Grim {
 
 Imuse *g_imuse = NULL;
 
-extern uint16 imuseDestTable[];
 extern ImuseTable grimStateMusicTable[];
 extern ImuseTable grimSeqMusicTable[];
 extern ImuseTable grimDemoStateMusicTable[];
@@ -50,12 +49,23 @@ void Imuse::timerHandler(void *refCon) {
 	imuse->callback();
 }
 
+void Imuse::decodeAheadHandler(void *refCon) {
+	Imuse *imuse = (Imuse *)refCon;
+	// Runs outside of the iMUSE lock, so the callback only copies samples
+	imuse->_sound->decodeAhead();
+}
+
 Imuse::Imuse(int fps, bool demo) {
 	_demo = demo;
 	_pause = false;
 	_sound = new ImuseSndMgr(_demo);
 	assert(_sound);
 	_callbackFps = fps;
+	_commandHead = _commandTail = 0;
+	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
+		_status[l].soundName[0] = 0;
+		_status[l].used = false;
+	}
 	resetState();
 	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
 		_track[l] = new Track;
@@ -63,7 +73,7 @@ Imuse::Imuse(int fps, bool demo) {
 		memset(_track[l], 0, sizeof(Track));
 		_track[l]->trackId = l;
 	}
-	vimaInit(imuseDestTable);
+	vimaInit();
 	if (_demo) {
 		_stateMusicTable = grimDemoStateMusicTable;
 		_seqMusicTable = grimDemoSeqMusicTable;
@@ -72,10 +82,12 @@ Imuse::Imuse(int fps, bool demo) {
 		_seqMusicTable = grimSeqMusicTable;
 	}
 	g_system->getTimerManager()->installTimerProc(timerHandler, 1000000 / _callbackFps, this, "imuseCallback");
+	g_system->getTimerManager()->installTimerProc(decodeAheadHandler, 1000000 / _callbackFps, this, "imuseDecodeAhead");
 }
 
 Imuse::~Imuse() {
 	g_system->getTimerManager()->removeTimerProc(timerHandler);
+	g_system->getTimerManager()->removeTimerProc(decodeAheadHandler);
 	stopAllSounds();
 	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
 		delete _track[l];
@@ -91,6 +103,8 @@ void Imuse::resetState() {
 
 void Imuse::restoreState(SaveGame *savedState) {
 	Common::StackLock lock(_mutex);
+	// The pending changes were meant for the tracks being replaced
+	discardCommands();
 
 	savedState->beginSection('IMUS');
 	_curMusicState = savedState->readLESint32();
@@ -151,11 +165,13 @@ void Imuse::restoreState(SaveGame *savedState) {
 		g_system->getMixer()->pauseHandle(track->handle, true);
 	}
 	savedState->endSection();
+	publishStatus();
 	g_system->getMixer()->pauseAll(false);
 }
 
 void Imuse::saveState(SaveGame *savedState) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	savedState->beginSection('IMUS');
 	savedState->writeLESint32(_curMusicState);
@@ -203,7 +219,12 @@ int32 Imuse::makeMixerFlags(int32 flags) {
 }
 
 void Imuse::callback() {
+	uint32 start = g_system->getMillis();
 	Common::StackLock lock(_mutex);
+	uint32 locked = g_system->getMillis();
+	_lockWaitTime.add(locked - start);
+
+	processCommands();
 
 	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
 		Track *track = _track[l];
@@ -217,7 +238,7 @@ void Imuse::callback() {
 			}
 
 			if (_pause)
-				return;
+				break;
 
 			if (track->volFadeUsed) {
 				if (track->volFadeStep < 0) {
@@ -304,10 +325,10 @@ void Imuse::callback() {
 					result = mixer_size;
 
 				if (g_system->getMixer()->isReady()) {
-					track->stream->queueBuffer(data, result, DisposeAfterUse::YES, makeMixerFlags(track->mixerFlags));
+					track->stream->queueAudioStream(_sound->makeBufferStream(data, result, track->stream->getRate(), makeMixerFlags(track->mixerFlags)));
 					track->regionOffset += result;
 				} else
-					delete[] data;
+					_sound->releaseBuffer(data, result);
 
 				if (_sound->isEndOfRegion(track->soundDesc, track->curRegion)) {
 					switchToNextRegion(track);
@@ -323,6 +344,16 @@ void Imuse::callback() {
 			}
 		}
 	}
+
+	publishStatus();
+	_callbackTime.add(g_system->getMillis() - locked);
+}
+
+void Imuse::resetStats() {
+	// Only the callback adds to the histograms
+	Common::StackLock lock(_mutex);
+	_lockWaitTime.reset();
+	_callbackTime.reset();
 }
 
 void Imuse::switchToNextRegion(Track *track) {
@@ -25,12 +25,15 @@
 
 #include "common/mutex.h"
 
+#include "audio/audiostats.h"
+
 #include "engines/grim/imuse/imuse_track.h"
 
 namespace Grim {
 
 #define MAX_IMUSE_TRACKS 16
 #define MAX_IMUSE_FADETRACKS 16
+#define IMUSE_COMMAND_QUEUE_SIZE 64
 
 struct ImuseTable;
 class SaveGame;
@@ -38,6 +41,38 @@ class SaveGame;
 class Imuse {
 private:
 
+	// A change requested by the scripts, applied by the callback
+	struct Command {
+		enum Type {
+			kSetPriority,
+			kSetVolume,
+			kSetPan,
+			kSetFadeVolume,
+			kSetFadePan,
+			kSetHookId,
+			kStopSound,
+			kFlushTracks,
+			kRefreshScripts
+		};
+
+		Type type;
+		char soundName[32];
+		int32 param1;
+		int32 param2;
+	};
+
+	// What the scripts can see of a track, published by the callback
+	struct TrackStatus {
+		char soundName[32];
+		bool used;
+		bool toBeRemoved;
+		int32 vol;
+		int32 volGroupId;
+		int32 position;
+		int32 feedSize;
+		Audio::SoundHandle handle;
+	};
+
 	int _callbackFps;
 
 	Track *_track[MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS];
@@ -45,6 +80,22 @@ private:
 	Common::Mutex _mutex;
 	ImuseSndMgr *_sound;
 
+	// How long the callback waited for _mutex, and how long it then ran
+	Audio::DurationHistogram _lockWaitTime;
+	Audio::DurationHistogram _callbackTime;
+
+	/**
+	 * The scripts post their changes to a queue instead of waiting for the
+	 * callback, and read the track status from a copy the callback
+	 * publishes. Both are guarded by _commandMutex, which is only held
+	 * briefly and never while waiting for _mutex.
+	 */
+	Common::Mutex _commandMutex;
+	Command _commands[IMUSE_COMMAND_QUEUE_SIZE];
+	uint32 _commandHead;
+	uint32 _commandTail;
+	TrackStatus _status[MAX_IMUSE_TRACKS];
+
 	bool _pause;
 	bool _demo;
 
@@ -57,6 +108,7 @@ private:
 
 	int32 makeMixerFlags(int32 flags);
 	static void timerHandler(void *refConf);
+	static void decodeAheadHandler(void *refConf);
 	void callback();
 	void switchToNextRegion(Track *track);
 	int allocSlot(int priority);
@@ -71,6 +123,15 @@ private:
 
 	void flushTrack(Track *track);
 
+	void postCommand(Command::Type type, const char *soundName, int32 param1 = 0, int32 param2 = 0);
+	void processCommands();
+	bool hasPendingCommands();
+	void discardCommands();
+	void processCommand(const Command &cmd);
+	void publishStatus();
+	void readStatus(TrackStatus *status);
+	const TrackStatus *findStatus(const TrackStatus *status, const char *soundName);
+
 public:
 	Imuse(int fps, bool demo);
 	~Imuse();
@@ -107,6 +168,10 @@ public:
 	int getCurMusicVol();
 	bool getSoundStatus(const char *soundName);
 	int32 getPosIn60HzTicks(const char *soundName);
+
+	const Audio::DurationHistogram &getLockWaitTime() const { return _lockWaitTime; }
+	const Audio::DurationHistogram &getCallbackTime() const { return _callbackTime; }
+	void resetStats();
 };
 
 extern Imuse *g_imuse;
@@ -29,22 +29,21 @@
 
 namespace Grim {
 
-uint16 imuseDestTable[5786];
-
 McmpMgr::McmpMgr() {
 	_compTable = NULL;
 	_numCompItems = 0;
 	_curSample = -1;
 	_compInput = NULL;
-	_outputSize = 0;
+	_decoded = NULL;
 	_file = NULL;
 	_numCompItems = 0;
-	_lastBlock = -1;
+	_playBlock = 0;
 }
 
 McmpMgr::~McmpMgr() {
 	delete[] _compTable;
 	delete[] _compInput;
+	delete[] _decoded;
 }
 
 bool McmpMgr::openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData) {
@@ -82,14 +81,66 @@ bool McmpMgr::openSound(const char *filename, Common::SeekableReadStream *data,
 		_compTable[i].offset += sizeCodecs;
 	}
 	_file->seek(sizeCodecs, SEEK_CUR);
-	// hack: two more bytes at the end of input buffer
-	_compInput = new byte[maxSize + 2];
+	_compInput = new byte[maxSize];
 	offsetData = headerSize;
 
+	_decoded = new DecodedBlock[MCMP_DECODE_AHEAD_BLOCKS];
+	for (i = 0; i < MCMP_DECODE_AHEAD_BLOCKS; i++) {
+		_decoded[i].block = -1;
+		_decoded[i].size = 0;
+	}
+
 	return true;
 }
 
-int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
+McmpMgr::DecodedBlock *McmpMgr::findBlock(int block) {
+	for (int i = 0; i < MCMP_DECODE_AHEAD_BLOCKS; i++) {
+		if (_decoded[i].block == block)
+			return &_decoded[i];
+	}
+	return NULL;
+}
+
+McmpMgr::DecodedBlock *McmpMgr::decodeBlock(int block) {
+	// Reuse a slot that is not needed anymore, i.e. behind the play
+	// position or too far ahead of it
+	DecodedBlock *slot = NULL;
+	for (int i = 0; i < MCMP_DECODE_AHEAD_BLOCKS; i++) {
+		int32 b = _decoded[i].block;
+		if (b < _playBlock || b >= _playBlock + MCMP_DECODE_AHEAD_BLOCKS) {
+			slot = &_decoded[i];
+			break;
+		}
+	}
+	if (!slot)
+		slot = &_decoded[block % MCMP_DECODE_AHEAD_BLOCKS];
+
+	_file->seek(_compTable[block].offset, SEEK_SET);
+	_file->read(_compInput, _compTable[block].compSize);
+	slot->size = _compTable[block].decompSize;
+	if (slot->size > 0x2000) {
+		error("McmpMgr::decodeBlock() _outputSize: %d", slot->size);
+	}
+	decompressVima(_compInput, _compTable[block].compSize, (int16 *)slot->data, slot->size);
+	slot->block = block;
+
+	return slot;
+}
+
+void McmpMgr::decodeAhead() {
+	Common::StackLock lock(_mutex);
+
+	if (!_file)
+		return;
+
+	int last = MIN<int>(_playBlock + MCMP_DECODE_AHEAD_BLOCKS, _numCompItems);
+	for (int i = _playBlock; i < last; i++) {
+		if (!findBlock(i))
+			decodeBlock(i);
+	}
+}
+
+int32 McmpMgr::decompressSample(int32 offset, int32 size, byte *comp_final) {
 	int32 i, final_size, output_size;
 	int skip, first_block, last_block;
 
@@ -98,6 +149,8 @@ int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
 		return 0;
 	}
 
+	Common::StackLock lock(_mutex);
+
 	first_block = offset / 0x2000;
 	last_block = (offset + size - 1) / 0x2000;
 	skip = offset % 0x2000;
@@ -107,25 +160,17 @@ int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
 		last_block = _numCompItems - 1;
 
 	int32 blocks_final_size = 0x2000 * (1 + last_block - first_block);
-	*comp_final = (byte *)malloc(blocks_final_size * sizeof(byte));
 	final_size = 0;
 
+	// The blocks are normally decoded already by decodeAhead()
+	_playBlock = first_block;
+
 	for (i = first_block; i <= last_block; i++) {
-		if (_lastBlock != i) {
-			// hack: two more zero bytes at the end of input buffer
-			_compInput[_compTable[i].compSize] = 0;
-			_compInput[_compTable[i].compSize + 1] = 0;
-			_file->seek(_compTable[i].offset, SEEK_SET);
-			_file->read(_compInput, _compTable[i].compSize);
-			decompressVima(_compInput, (int16 *)_compOutput, _compTable[i].decompSize, imuseDestTable);
-			_outputSize = _compTable[i].decompSize;
-			if (_outputSize > 0x2000) {
-				error("McmpMgr::decompressSample() _outputSize: %d", _outputSize);
-			}
-			_lastBlock = i;
-		}
+		DecodedBlock *decoded = findBlock(i);
+		if (!decoded)
+			decoded = decodeBlock(i);
 
-		output_size = _outputSize - skip;
+		output_size = decoded->size - skip;
 
 		if ((output_size + skip) > 0x2000) // workaround
 			output_size -= (output_size + skip) - 0x2000;
@@ -135,7 +180,7 @@ int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
 
 		assert(final_size + output_size <= blocks_final_size);
 
-		memcpy(*comp_final + final_size, _compOutput + skip, output_size);
+		memcpy(comp_final + final_size, decoded->data + skip, output_size);
 		final_size += output_size;
 
 		size -= output_size;
@@ -23,8 +23,13 @@
 #ifndef GRIM_MCMP_MGR_H
 #define GRIM_MCMP_MGR_H
 
+#include "common/mutex.h"
+
 namespace Grim {
 
+// Number of decoded blocks kept ahead of the play position
+#define MCMP_DECODE_AHEAD_BLOCKS 8
+
 class McmpMgr {
 private:
 
@@ -35,14 +40,23 @@ private:
 		int32 offset;
 	};
 
+	struct DecodedBlock {
+		int32 block;
+		int32 size;
+		byte data[0x2000];
+	};
+
 	CompTable *_compTable;
 	int16 _numCompItems;
 	int _curSample;
 	Common::SeekableReadStream *_file;
-	byte _compOutput[0x2000];
 	byte *_compInput;
-	int _outputSize;
-	int _lastBlock;
+	DecodedBlock *_decoded;
+	int _playBlock;
+	Common::Mutex _mutex;
+
+	DecodedBlock *findBlock(int block);
+	DecodedBlock *decodeBlock(int block);
 
 public:
 
@@ -50,7 +64,8 @@ public:
 	~McmpMgr();
 
 	bool openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData);
-	int32 decompressSample(int32 offset, int32 size, byte **comp_final);
+	int32 decompressSample(int32 offset, int32 size, byte *comp_final);
+	void decodeAhead();
 };
 
 } // end of namespace Grim
@@ -28,6 +28,9 @@
 namespace Grim {
 
 void Imuse::setMusicState(int stateId) {
+	Common::StackLock lock(_mutex);
+	processCommands();
+
 	int l, num = -1;
 
 	if (stateId == 0)
@@ -54,6 +57,9 @@ void Imuse::setMusicState(int stateId) {
 }
 
 int Imuse::setMusicSequence(int seqId) {
+	Common::StackLock lock(_mutex);
+	processCommands();
+
 	int l, num = -1;
 
 	if (seqId == -1)
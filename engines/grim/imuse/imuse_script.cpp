@@ -50,29 +50,169 @@ void Imuse::flushTrack(Track *track) {
 }
 
 void Imuse::flushTracks() {
+	postCommand(Command::kFlushTracks, "");
+}
+
+void Imuse::refreshScripts() {
+	postCommand(Command::kRefreshScripts, "");
+}
+
+void Imuse::postCommand(Command::Type type, const char *soundName, int32 param1, int32 param2) {
+	Command cmd;
+	cmd.type = type;
+	Common::strlcpy(cmd.soundName, soundName, sizeof(cmd.soundName));
+	cmd.param1 = param1;
+	cmd.param2 = param2;
+
+	{
+		Common::StackLock lock(_commandMutex);
+		if (_commandHead - _commandTail < IMUSE_COMMAND_QUEUE_SIZE) {
+			_commands[_commandHead % IMUSE_COMMAND_QUEUE_SIZE] = cmd;
+			_commandHead++;
+			return;
+		}
+	}
+
+	// The callback is not keeping up, apply it ourselves
 	Common::StackLock lock(_mutex);
-	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
-		Track *track = _track[l];
-		if (track->used && track->toBeRemoved && !g_system->getMixer()->isSoundHandleActive(track->handle)) {
-			memset(track, 0, sizeof(Track));
+	processCommands();
+	processCommand(cmd);
+}
+
+void Imuse::processCommands() {
+	// _mutex must be held. The commands may post further ones, for instance
+	// when a music sequence starts, which are handled in the same loop.
+	for (;;) {
+		Command cmd;
+		{
+			Common::StackLock lock(_commandMutex);
+			if (_commandTail == _commandHead)
+				return;
+			cmd = _commands[_commandTail % IMUSE_COMMAND_QUEUE_SIZE];
+			_commandTail++;
 		}
+		processCommand(cmd);
 	}
 }
 
-void Imuse::refreshScripts() {
-	Common::StackLock lock(_mutex);
-	bool found = false;
+bool Imuse::hasPendingCommands() {
+	Common::StackLock lock(_commandMutex);
+	return _commandTail != _commandHead;
+}
+
+void Imuse::discardCommands() {
+	Common::StackLock lock(_commandMutex);
+	_commandTail = _commandHead;
+}
+
+void Imuse::processCommand(const Command &cmd) {
+	if (cmd.type == Command::kFlushTracks) {
+		for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
+			Track *track = _track[l];
+			if (track->used && track->toBeRemoved && !g_system->getMixer()->isSoundHandleActive(track->handle)) {
+				memset(track, 0, sizeof(Track));
+			}
+		}
+		return;
+	} else if (cmd.type == Command::kRefreshScripts) {
+		bool found = false;
+
+		for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
+			Track *track = _track[l];
+			if (track->used && !track->toBeRemoved && (track->volGroupId == IMUSE_VOLGRP_MUSIC)) {
+				found = true;
+			}
+		}
+
+		if (!found && _curMusicState) {
+			setMusicSequence(0);
+		}
+		return;
+	}
+
+	Track *changeTrack = findTrack(cmd.soundName);
+	if (changeTrack == NULL) {
+		if (cmd.type == Command::kStopSound)
+			Debug::warning(Debug::Imuse, "Sound track '%s' could not be found to stop", cmd.soundName);
+		else
+			warning("Unable to find track '%s' to change it", cmd.soundName);
+		return;
+	}
 
+	switch (cmd.type) {
+	case Command::kSetPriority:
+		changeTrack->priority = cmd.param1;
+		break;
+	case Command::kSetVolume:
+		changeTrack->vol = cmd.param1 * 1000;
+		break;
+	case Command::kSetPan:
+		changeTrack->pan = cmd.param1 * 1000;
+		break;
+	case Command::kSetFadeVolume:
+		changeTrack->volFadeDelay = cmd.param2;
+		changeTrack->volFadeDest = cmd.param1 * 1000;
+		changeTrack->volFadeStep = (changeTrack->volFadeDest - changeTrack->vol) * 60 * (1000 / _callbackFps) / (1000 * cmd.param2);
+		changeTrack->volFadeUsed = true;
+		break;
+	case Command::kSetFadePan:
+		changeTrack->panFadeDelay = cmd.param2;
+		changeTrack->panFadeDest = cmd.param1 * 1000;
+		changeTrack->panFadeStep = (changeTrack->panFadeDest - changeTrack->pan) * 60 * (1000 / _callbackFps) / (1000 * cmd.param2);
+		changeTrack->panFadeUsed = true;
+		break;
+	case Command::kSetHookId:
+		changeTrack->curHookId = cmd.param1;
+		break;
+	case Command::kStopSound:
+		Debug::debug(Debug::Imuse, "Imuse::stopSound(): SoundName %s", cmd.soundName);
+		flushTrack(changeTrack);
+		break;
+	default:
+		break;
+	}
+}
+
+void Imuse::publishStatus() {
+	// _mutex must be held
+	Common::StackLock lock(_commandMutex);
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
 		Track *track = _track[l];
-		if (track->used && !track->toBeRemoved && (track->volGroupId == IMUSE_VOLGRP_MUSIC)) {
-			found = true;
-		}
+		TrackStatus *status = &_status[l];
+		memcpy(status->soundName, track->soundName, sizeof(status->soundName));
+		status->used = track->used;
+		status->toBeRemoved = track->toBeRemoved;
+		status->vol = track->vol;
+		status->volGroupId = track->volGroupId;
+		status->position = track->dataOffset + track->regionOffset;
+		status->feedSize = track->feedSize;
+		status->handle = track->handle;
 	}
+}
 
-	if (!found && _curMusicState) {
-		setMusicSequence(0);
+void Imuse::readStatus(TrackStatus *status) {
+	// The scripts expect to see the changes they just made
+	if (hasPendingCommands()) {
+		Common::StackLock lock(_mutex);
+		processCommands();
+		publishStatus();
 	}
+
+	Common::StackLock lock(_commandMutex);
+	memcpy(status, _status, sizeof(_status));
+}
+
+const Imuse::TrackStatus *Imuse::findStatus(const TrackStatus *status, const char *soundName) {
+	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
+		const TrackStatus *track = &status[l];
+
+		// See findTrack
+		if (track->used && !track->toBeRemoved
+				&& strlen(track->soundName) != 0 && scumm_stricmp(track->soundName, soundName) == 0) {
+			return track;
+		}
+	}
+	return NULL;
 }
 
 bool Imuse::startVoice(const char *soundName, int volume, int pan) {
@@ -96,24 +236,29 @@ void Imuse::startSfx(const char *soundName, int priority) {
 }
 
 int32 Imuse::getPosIn60HzTicks(const char *soundName) {
-	Common::StackLock lock(_mutex);
-	Track *getTrack = NULL;
+	TrackStatus status[MAX_IMUSE_TRACKS];
+	readStatus(status);
 
-	getTrack = findTrack(soundName);
+	const TrackStatus *getTrack = findStatus(status, soundName);
 	// Warn the user if the track was not found
 	if (getTrack == NULL) {
 		Debug::warning(Debug::Imuse, "Sound '%s' could not be found to get ticks", soundName);
 		return false;
 	}
 
-	int32 pos = (5 * (getTrack->dataOffset + getTrack->regionOffset)) / (getTrack->feedSize / 12);
-	return pos;
+	int32 pos = (5 * getTrack->position) / (getTrack->feedSize / 12);
+	// What has been fed to the mixer is only heard once the output
+	// buffer of the backend has been played
+	pos -= g_system->getMixer()->getOutputLatency() * 60 / 1000;
+	return MAX<int32>(pos, 0);
 }
 
 bool Imuse::isVoicePlaying() {
-	Common::StackLock lock(_mutex);
+	TrackStatus status[MAX_IMUSE_TRACKS];
+	readStatus(status);
+
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
-		Track *track = _track[l];
+		const TrackStatus *track = &status[l];
 		if (track->used && track->volGroupId == IMUSE_VOLGRP_VOICE) {
 			if (g_system->getMixer()->isSoundHandleActive(track->handle))
 				return true;
@@ -124,14 +269,14 @@ bool Imuse::isVoicePlaying() {
 }
 
 bool Imuse::getSoundStatus(const char *soundName) {
-	Common::StackLock lock(_mutex);
-	Track *track = NULL;
-
 	// If there's no name then don't try to get the status!
 	if (strlen(soundName) == 0)
 		return false;
 
-	track = findTrack(soundName);
+	TrackStatus status[MAX_IMUSE_TRACKS];
+	readStatus(status);
+
+	const TrackStatus *track = findStatus(status, soundName);
 	// Warn the user if the track was not found
 	if (track == NULL || !g_system->getMixer()->isSoundHandleActive(track->handle)) {
 		// This debug warning should be "light" since this function gets called
@@ -143,23 +288,16 @@ bool Imuse::getSoundStatus(const char *soundName) {
 }
 
 void Imuse::stopSound(const char *soundName) {
-	Common::StackLock lock(_mutex);
-	Debug::debug(Debug::Imuse, "Imuse::stopSound(): SoundName %s", soundName);
-	Track *removeTrack = NULL;
-
-	removeTrack = findTrack(soundName);
-	// Warn the user if the track was not found
-	if (removeTrack == NULL) {
-		Debug::warning(Debug::Imuse, "Sound track '%s' could not be found to stop", soundName);
-		return;
-	}
-	flushTrack(removeTrack);
+	postCommand(Command::kStopSound, soundName);
 }
 
 void Imuse::stopAllSounds() {
 	Common::StackLock lock(_mutex);
 	Debug::debug(Debug::Imuse, "Imuse::stopAllSounds()");
 
+	// Nothing is left for the pending changes to act on
+	discardCommands();
+
 	for (int l = 0; l < MAX_IMUSE_TRACKS + MAX_IMUSE_FADETRACKS; l++) {
 		Track *track = _track[l];
 		if (track->used) {
@@ -170,6 +308,7 @@ void Imuse::stopAllSounds() {
 			memset(track, 0, sizeof(Track));
 		}
 	}
+	publishStatus();
 }
 
 void Imuse::pause(bool p) {
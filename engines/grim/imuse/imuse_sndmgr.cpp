@@ -22,6 +22,8 @@
 
 #include "common/endian.h"
 
+#include "audio/decoders/raw.h"
+
 #include "engines/grim/resource.h"
 #include "engines/grim/colormap.h"
 
@@ -30,8 +32,104 @@
 
 namespace Grim {
 
+// Size of the pooled output buffers; larger requests are not pooled
+#define IMUSE_BUFFER_SIZE    0x4000
+#define IMUSE_MAX_FREE_BUFFERS 32
+
+/**
+ * The mixer deletes the buffer streams whenever it is done with them, which
+ * may be after the sound manager is gone. So the manager and each stream
+ * hold a reference to the pool, and the last one to let go deletes it.
+ */
+class ImuseBufferPool {
+public:
+	ImuseBufferPool() : _refCount(1) {}
+
+	byte *allocBuffer(int32 size);
+	void releaseBuffer(byte *buf, int32 size);
+
+	void incRef();
+	void decRef();
+
+private:
+	~ImuseBufferPool();
+
+	Common::Array<byte *> _freeBuffers;
+	int _refCount;
+	Common::Mutex _mutex;
+};
+
+ImuseBufferPool::~ImuseBufferPool() {
+	for (uint i = 0; i < _freeBuffers.size(); i++) {
+		free(_freeBuffers[i]);
+	}
+}
+
+byte *ImuseBufferPool::allocBuffer(int32 size) {
+	if (size > IMUSE_BUFFER_SIZE)
+		return (byte *)malloc(size);
+
+	Common::StackLock lock(_mutex);
+	if (_freeBuffers.empty())
+		return (byte *)malloc(IMUSE_BUFFER_SIZE);
+
+	byte *buf = _freeBuffers.back();
+	_freeBuffers.pop_back();
+	return buf;
+}
+
+void ImuseBufferPool::releaseBuffer(byte *buf, int32 size) {
+	Common::StackLock lock(_mutex);
+	if (size > IMUSE_BUFFER_SIZE || _freeBuffers.size() >= IMUSE_MAX_FREE_BUFFERS) {
+		free(buf);
+	} else {
+		_freeBuffers.push_back(buf);
+	}
+}
+
+void ImuseBufferPool::incRef() {
+	Common::StackLock lock(_mutex);
+	_refCount++;
+}
+
+void ImuseBufferPool::decRef() {
+	bool last;
+	{
+		Common::StackLock lock(_mutex);
+		last = --_refCount == 0;
+	}
+	if (last)
+		delete this;
+}
+
+class PooledBufferStream : public Audio::AudioStream {
+public:
+	PooledBufferStream(ImuseBufferPool *pool, byte *buf, int32 size, int rate, byte flags) :
+		_pool(pool), _buf(buf), _size(size) {
+		_pool->incRef();
+		_stream = Audio::makeRawStream(buf, size, rate, flags, DisposeAfterUse::NO);
+	}
+	~PooledBufferStream() {
+		delete _stream;
+		_pool->releaseBuffer(_buf, _size);
+		_pool->decRef();
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) { return _stream->readBuffer(buffer, numSamples); }
+	bool isStereo() const { return _stream->isStereo(); }
+	int getRate() const { return _stream->getRate(); }
+	bool endOfData() const { return _stream->endOfData(); }
+
+private:
+	ImuseBufferPool *_pool;
+	Audio::AudioStream *_stream;
+	byte *_buf;
+	int32 _size;
+};
+
 ImuseSndMgr::ImuseSndMgr(bool demo) {
 	_demo = demo;
+	_bufferPool = new ImuseBufferPool();
 	for (int l = 0; l < MAX_IMUSE_SOUNDS; l++) {
 		memset(&_sounds[l], 0, sizeof(SoundDesc));
 	}
@@ -41,6 +139,7 @@ ImuseSndMgr::~ImuseSndMgr() {
 	for (int l = 0; l < MAX_IMUSE_SOUNDS; l++) {
 		closeSound(&_sounds[l]);
 	}
+	_bufferPool->decRef();
 }
 
 void ImuseSndMgr::countElements(SoundDesc *sound) {
@@ -171,6 +270,7 @@ ImuseSndMgr::SoundDesc *ImuseSndMgr::allocSlot() {
 }
 
 ImuseSndMgr::SoundDesc *ImuseSndMgr::openSound(const char *soundName, int volGroupId) {
+	Common::StackLock lock(_mutex);
 	Common::String s = soundName;
 	s.toLowercase();
 	soundName = s.c_str();
@@ -214,6 +314,7 @@ ImuseSndMgr::SoundDesc *ImuseSndMgr::openSound(const char *soundName, int volGro
 
 void ImuseSndMgr::closeSound(SoundDesc *sound) {
 	assert(checkForProperHandle(sound));
+	Common::StackLock lock(_mutex);
 
 	if (sound->mcmpMgr) {
 		delete sound->mcmpMgr;
@@ -353,10 +454,10 @@ int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte **buf, i
 		sound->endFlag = false;
 	}
 
+	*buf = _bufferPool->allocBuffer(size);
 	if (sound->mcmpData) {
-		size = sound->mcmpMgr->decompressSample(region_offset + offset, size, buf);
+		size = sound->mcmpMgr->decompressSample(region_offset + offset, size, *buf);
 	} else {
-		*buf = (byte *)malloc(sizeof(byte) * size);
 		sound->inStream->seek(region_offset + offset + sound->headerSize, SEEK_SET);
 		sound->inStream->read(*buf, size);
 	}
@@ -364,4 +465,22 @@ int32 ImuseSndMgr::getDataFromRegion(SoundDesc *sound, int region, byte **buf, i
 	return size;
 }
 
+void ImuseSndMgr::decodeAhead() {
+	Common::StackLock lock(_mutex);
+
+	for (int l = 0; l < MAX_IMUSE_SOUNDS; l++) {
+		SoundDesc *sound = &_sounds[l];
+		if (sound->inUse && sound->mcmpData)
+			sound->mcmpMgr->decodeAhead();
+	}
+}
+
+void ImuseSndMgr::releaseBuffer(byte *buf, int32 size) {
+	_bufferPool->releaseBuffer(buf, size);
+}
+
+Audio::AudioStream *ImuseSndMgr::makeBufferStream(byte *buf, int32 size, int rate, byte flags) {
+	return new PooledBufferStream(_bufferPool, buf, size, rate, flags);
+}
+
 } // end of namespace Grim
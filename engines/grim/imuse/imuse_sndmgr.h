@@ -23,12 +23,16 @@
 #ifndef GRIM_IMUSE_SNDMGR_H
 #define GRIM_IMUSE_SNDMGR_H
 
+#include "common/array.h"
+#include "common/mutex.h"
+
 #include "audio/mixer.h"
 #include "audio/audiostream.h"
 
 namespace Grim {
 
 class McmpMgr;
+class ImuseBufferPool;
 
 class ImuseSndMgr {
 public:
@@ -83,6 +87,11 @@ private:
 
 	SoundDesc _sounds[MAX_IMUSE_SOUNDS];
 	bool _demo;
+	// Guards the sound slots against decodeAhead()
+	Common::Mutex _mutex;
+
+	// Output buffers handed to the mixer, reused once they are played
+	ImuseBufferPool *_bufferPool;
 
 	bool checkForProperHandle(SoundDesc *soundDesc);
 	SoundDesc *allocSlot();
@@ -112,6 +121,20 @@ public:
 	int getJumpFade(SoundDesc *sound, int number);
 
 	int32 getDataFromRegion(SoundDesc *sound, int region, byte **buf, int32 offset, int32 size);
+
+	/**
+	 * Decodes the compressed sounds ahead of their play position, so that
+	 * getDataFromRegion() only has to copy the samples.
+	 * Called from its own timer, without the iMUSE lock.
+	 */
+	void decodeAhead();
+
+	/**
+	 * Wraps a buffer returned by getDataFromRegion() in a raw stream,
+	 * which gives the buffer back when it is destroyed.
+	 */
+	Audio::AudioStream *makeBufferStream(byte *buf, int32 size, int rate, byte flags);
+	void releaseBuffer(byte *buf, int32 size);
 };
 
 } // end of namespace Grim
@@ -75,6 +75,9 @@ bool Imuse::startSound(const char *soundName, int volGroupId, int hookId, int vo
 	Track *track = NULL;
 	int i;
 
+	// Apply the pending changes first, one of them may stop this sound
+	processCommands();
+
 	// If the track is already playing then there is absolutely no
 	// reason to start it again, the existing track should be modified
 	// instead of starting a new copy of the track
@@ -143,6 +146,9 @@ bool Imuse::startSound(const char *soundName, int volGroupId, int hookId, int vo
 											false, (track->mixerFlags & kFlagReverseStereo) != 0);
 	track->used = true;
 
+	// Let getSoundStatus() see the new sound right away
+	publishStatus();
+
 	return true;
 }
 
@@ -162,48 +168,23 @@ Track *Imuse::findTrack(const char *soundName) {
 }
 
 void Imuse::setPriority(const char *soundName, int priority) {
-	Common::StackLock lock(_mutex);
-	Track *changeTrack = NULL;
 	assert ((priority >= 0) && (priority <= 127));
-
-	changeTrack = findTrack(soundName);
-	// Check to make sure we found the track
-	if (changeTrack == NULL) {
-		warning("Unable to find track '%s' to change priority", soundName);
-		return;
-	}
-	changeTrack->priority = priority;
+	postCommand(Command::kSetPriority, soundName, priority);
 }
 
 void Imuse::setVolume(const char *soundName, int volume) {
-	Common::StackLock lock(_mutex);
-	Track *changeTrack;
-
-	changeTrack = findTrack(soundName);
-	if (changeTrack == NULL) {
-		warning("Unable to find track '%s' to change volume", soundName);
-		return;
-	}
-	changeTrack->vol = volume * 1000;
+	postCommand(Command::kSetVolume, soundName, volume);
 }
 
 void Imuse::setPan(const char *soundName, int pan) {
-	Common::StackLock lock(_mutex);
-	Track *changeTrack;
-
-	changeTrack = findTrack(soundName);
-	if (changeTrack == NULL) {
-		warning("Unable to find track '%s' to change pan", soundName);
-		return;
-	}
-	changeTrack->pan = pan * 1000;
+	postCommand(Command::kSetPan, soundName, pan);
 }
 
 int Imuse::getVolume(const char *soundName) {
-	Common::StackLock lock(_mutex);
-	Track *getTrack;
+	TrackStatus status[MAX_IMUSE_TRACKS];
+	readStatus(status);
 
-	getTrack = findTrack(soundName);
+	const TrackStatus *getTrack = findStatus(status, soundName);
 	if (getTrack == NULL) {
 		warning("Unable to find track '%s' to get volume", soundName);
 		return 0;
@@ -212,23 +193,16 @@ int Imuse::getVolume(const char *soundName) {
 }
 
 void Imuse::setHookId(const char *soundName, int hookId) {
-	Common::StackLock lock(_mutex);
-	Track *changeTrack;
-
-	changeTrack = findTrack(soundName);
-	if (changeTrack == NULL) {
-		warning("Unable to find track '%s' to change hook id", soundName);
-		return;
-	}
-	changeTrack->curHookId = hookId;
+	postCommand(Command::kSetHookId, soundName, hookId);
 }
 
 int Imuse::getCountPlayedTracks(const char *soundName) {
-	Common::StackLock lock(_mutex);
+	TrackStatus status[MAX_IMUSE_TRACKS];
+	readStatus(status);
 	int count = 0;
 
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
-		Track *track = _track[l];
+		const TrackStatus *track = &status[l];
 		if (track->used && !track->toBeRemoved && (scumm_stricmp(track->soundName, soundName) == 0)) {
 			count++;
 		}
@@ -239,6 +213,7 @@ int Imuse::getCountPlayedTracks(const char *soundName) {
 
 void Imuse::selectVolumeGroup(const char *soundName, int volGroupId) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	Track *changeTrack;
 	assert((volGroupId >= 1) && (volGroupId <= 4));
 
@@ -251,40 +226,20 @@ void Imuse::selectVolumeGroup(const char *soundName, int volGroupId) {
 		return;
 	}
 	changeTrack->volGroupId = volGroupId;
+	publishStatus();
 }
 
 void Imuse::setFadeVolume(const char *soundName, int destVolume, int duration) {
-	Common::StackLock lock(_mutex);
-	Track *changeTrack;
-
-	changeTrack = findTrack(soundName);
-	if (changeTrack == NULL) {
-		warning("Unable to find track '%s' to change fade volume", soundName);
-		return;
-	}
-	changeTrack->volFadeDelay = duration;
-	changeTrack->volFadeDest = destVolume * 1000;
-	changeTrack->volFadeStep = (changeTrack->volFadeDest - changeTrack->vol) * 60 * (1000 / _callbackFps) / (1000 * duration);
-	changeTrack->volFadeUsed = true;
+	postCommand(Command::kSetFadeVolume, soundName, destVolume, duration);
 }
 
 void Imuse::setFadePan(const char *soundName, int destPan, int duration) {
-	Common::StackLock lock(_mutex);
-	Track *changeTrack;
-
-	changeTrack = findTrack(soundName);
-	if (changeTrack == NULL) {
-		warning("Unable to find track '%s' to change fade pan", soundName);
-		return;
-	}
-	changeTrack->panFadeDelay = duration;
-	changeTrack->panFadeDest = destPan * 1000;
-	changeTrack->panFadeStep = (changeTrack->panFadeDest - changeTrack->pan) * 60 * (1000 / _callbackFps) / (1000 * duration);
-	changeTrack->panFadeUsed = true;
+	postCommand(Command::kSetFadePan, soundName, destPan, duration);
 }
 
 char *Imuse::getCurMusicSoundName() {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
 		Track *track = _track[l];
 		if (track->used && !track->toBeRemoved && (track->volGroupId == IMUSE_VOLGRP_MUSIC)) {
@@ -296,6 +251,7 @@ char *Imuse::getCurMusicSoundName() {
 
 int Imuse::getCurMusicPan() {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
 		Track *track = _track[l];
 		if (track->used && !track->toBeRemoved && (track->volGroupId == IMUSE_VOLGRP_MUSIC)) {
@@ -307,6 +263,7 @@ int Imuse::getCurMusicPan() {
 
 int Imuse::getCurMusicVol() {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
 		Track *track = _track[l];
 		if (track->used && !track->toBeRemoved && (track->volGroupId == IMUSE_VOLGRP_MUSIC)) {
@@ -318,10 +275,12 @@ int Imuse::getCurMusicVol() {
 
 void Imuse::fadeOutMusic(int duration) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
 		Track *track = _track[l];
 		if (track->used && !track->toBeRemoved && (track->volGroupId == IMUSE_VOLGRP_MUSIC)) {
 			moveToFadeOutTrack(track, duration);
+			publishStatus();
 			return;
 		}
 	}
@@ -329,12 +288,14 @@ void Imuse::fadeOutMusic(int duration) {
 
 void Imuse::fadeOutMusicAndStartNew(int fadeDelay, const char *filename, int hookId, int vol, int pan) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	for (int l = 0; l < MAX_IMUSE_TRACKS; l++) {
 		Track *track = _track[l];
 		if (track->used && !track->toBeRemoved && (track->volGroupId == IMUSE_VOLGRP_MUSIC)) {
 			startMusicWithOtherPos(filename, 0, vol, pan, track);
 			moveToFadeOutTrack(track, fadeDelay);
+			publishStatus();
 			break;
 		}
 	}
@@ -20,6 +20,7 @@
 #include "engines/grim/lua/lobject.h"
 #include "engines/grim/lua/lopcodes.h"
 #include "engines/grim/lua/lparser.h"
+#include "engines/grim/lua/lprofile.h"
 #include "engines/grim/lua/lstate.h"
 #include "engines/grim/lua/ltask.h"
 #include "engines/grim/lua/ltm.h"
@@ -30,6 +31,8 @@
 #include "engines/grim/lua/lzio.h"
 
 #include "common/file.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/textconsole.h"
 
 namespace Grim {
@@ -194,9 +197,13 @@ int32 luaD_call(StkId base, int32 nResults) {
 			ttype(funcObj) = LUA_T_CLMARK;
 			if (ttype(proto) == LUA_T_CPROTO) {
 				function = fvalue(funcObj);
+				if (lua_profiling)
+					luaP_enter(lua_state->task, NULL, fvalue(proto));
 				firstResult = callCclosure(c, fvalue(proto), base);
 			} else {
 				lua_taskresume(lua_state->task, c, tfvalue(proto), base);
+				if (lua_profiling)
+					luaP_enter(lua_state->task, tfvalue(proto), NULL);
 				firstResult = luaV_execute(lua_state->task);
 			}
 		} else if (ttype(funcObj) == LUA_T_PMARK) {
@@ -231,10 +238,14 @@ int32 luaD_call(StkId base, int32 nResults) {
 		} else if (ttype(funcObj) == LUA_T_PROTO) {
 			ttype(funcObj) = LUA_T_PMARK;
 			lua_taskresume(lua_state->task, NULL, tfvalue(funcObj), base);
+			if (lua_profiling)
+				luaP_enter(lua_state->task, tfvalue(funcObj), NULL);
 			firstResult = luaV_execute(lua_state->task);
 		} else if (ttype(funcObj) == LUA_T_CPROTO) {
 			ttype(funcObj) = LUA_T_CMARK;
 			function = fvalue(funcObj);
+			if (lua_profiling)
+				luaP_enter(lua_state->task, NULL, function);
 			firstResult = callC(fvalue(funcObj), base);
 		} else {
 			TObject *im = luaT_getimbyObj(funcObj, IM_FUNCTION);
@@ -274,6 +285,8 @@ int32 luaD_call(StkId base, int32 nResults) {
 			lua_state->stack.top -= firstResult - base;
 
 			lua_Task *tmp = lua_state->task;
+			if (lua_profiling)
+				luaP_leave(tmp);
 			lua_state->task = lua_state->task->next;
 			luaM_free(tmp);
 			if (lua_state->task) {
@@ -376,10 +389,110 @@ int32 luaD_protectedrun(int32 nResults) {
 	return status;
 }
 
+/*
+** Chunks loaded from named buffers (i.e. script files) are remembered by
+** name and content hash, so that running the same file again reuses the
+** prototypes instead of undumping or parsing it once more. The cached
+** prototypes are kept alive by the garbage collector through
+** luaD_travchunkcache and dropped when the Lua state is closed, or when
+** the least recently run file makes room for another one.
+*/
+struct ChunkCacheEntry {
+	uint32 id;  // tells an entry from a later one with the same name
+	uint32 hash;
+	int32 size;
+	bool complete;  // set once all the chunks of the buffer were loaded
+	int32 users;  // number of runs of this entry in progress
+	uint32 lastUse;
+	Common::Array<TProtoFunc *> chunks;
+	Common::Array<int32> chunkBlocks;  // blocks created by loading each chunk
+};
+
+#define MAXCACHEDFILES 256
+
+typedef Common::HashMap<Common::String, ChunkCacheEntry *> ChunkCache;
+static ChunkCache *chunkCache = NULL;
+static uint32 chunkCacheClock = 0;
+
+static uint32 hashbuffer(const char *buff, int32 size) {
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	for (int32 i = 0; i < size; i++) {
+		hash ^= (byte)buff[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+void luaD_travchunkcache(int32 (*fn)(TObject *)) {
+	if (!chunkCache)
+		return;
+	for (ChunkCache::iterator i = chunkCache->begin(); i != chunkCache->end(); ++i) {
+		Common::Array<TProtoFunc *> &chunks = i->_value->chunks;
+		for (uint j = 0; j < chunks.size(); j++) {
+			TObject o;
+			ttype(&o) = LUA_T_PROTO;
+			o.value.tf = chunks[j];
+			fn(&o);
+		}
+	}
+}
+
+void luaD_clearchunkcache() {
+	if (!chunkCache)
+		return;
+	for (ChunkCache::iterator i = chunkCache->begin(); i != chunkCache->end(); ++i)
+		delete i->_value;
+	delete chunkCache;
+	chunkCache = NULL;
+}
+
+/*
+** A run may close the Lua state, and the cache with it, so the entry is
+** looked up again by name after every run rather than kept across it.
+*/
+static ChunkCacheEntry *findcache(const char *name, uint32 id) {
+	if (!name || !chunkCache)
+		return NULL;
+	ChunkCache::iterator i = chunkCache->find(name);
+	if (i == chunkCache->end() || i->_value->id != id)
+		return NULL;
+	return i->_value;
+}
+
+static void releasecache(const char *name, uint32 id) {
+	ChunkCacheEntry *cache = findcache(name, id);
+	if (cache)
+		cache->users--;
+}
+
+// Drop the least recently run file which is complete and not running.
+static void evictchunkcache() {
+	ChunkCache::iterator oldest = chunkCache->end();
+	for (ChunkCache::iterator i = chunkCache->begin(); i != chunkCache->end(); ++i) {
+		ChunkCacheEntry *cache = i->_value;
+		if (!cache->complete || cache->users > 0)
+			continue;
+		if (oldest == chunkCache->end() || cache->lastUse < oldest->_value->lastUse)
+			oldest = i;
+	}
+	if (oldest != chunkCache->end()) {
+		delete oldest->_value;
+		chunkCache->erase(oldest);
+	}
+}
+
+static void pushchunk(TProtoFunc *tf) {
+	luaD_adjusttop(lua_state->Cstack.base + 1);  // one slot for the pseudo-function
+	lua_state->stack.stack[lua_state->Cstack.base].ttype = LUA_T_PROTO;
+	lua_state->stack.stack[lua_state->Cstack.base].value.tf = tf;
+	luaV_closure(0);
+}
+
 /*
 ** returns 0 = chunk loaded; 1 = error; 2 = no more chunks to load
 */
-static int32 protectedparser(ZIO *z, int32 bin) {
+static int32 protectedparser(ZIO *z, int32 bin, TProtoFunc **loaded) {
 	int32 status;
 	TProtoFunc *tf;
 	jmp_buf myErrorJmp;
@@ -397,24 +510,39 @@ static int32 protectedparser(ZIO *z, int32 bin) {
 		return 1;  // error code
 	if (tf == NULL)
 		return 2;  // 'natural' end
-	luaD_adjusttop(lua_state->Cstack.base + 1);  // one slot for the pseudo-function
-	lua_state->stack.stack[lua_state->Cstack.base].ttype = LUA_T_PROTO;
-	lua_state->stack.stack[lua_state->Cstack.base].value.tf = tf;
-	luaV_closure(0);
+	*loaded = tf;
+	pushchunk(tf);
 	return 0;
 }
 
-static int32 do_main(ZIO *z, int32 bin) {
+/*
+** Loads and runs all the chunks in z. If 'name' is not NULL, the loaded
+** prototypes are appended to its cache entry, which is flagged as complete
+** once every chunk has been loaded successfully.
+*/
+static int32 do_main(ZIO *z, int32 bin, const char *name, uint32 id) {
 	int32 status;
 	do {
 		int32 old_blocks = (luaC_checkGC(), nblocks);
-		status = protectedparser(z, bin);
+		TProtoFunc *tf = NULL;
+		status = protectedparser(z, bin, &tf);
 		if (status == 1)
 			return 1;  // error
-		else if (status == 2)
+		else if (status == 2) {
+			ChunkCacheEntry *cache = findcache(name, id);
+			if (cache)
+				cache->complete = true;
 			return 0;  // 'natural' end
-		else {
+		} else {
 			int32 newelems2 = 2 * (nblocks - old_blocks);
+			ChunkCacheEntry *cache = findcache(name, id);
+			if (cache) {
+				cache->chunks.push_back(tf);
+				cache->chunkBlocks.push_back(nblocks - old_blocks);
+				// A source file is parsed in one go
+				if (!bin)
+					cache->complete = true;
+			}
 			GCthreshold += newelems2;
 			status = luaD_protectedrun(MULT_RET);
 			GCthreshold -= newelems2;
@@ -423,6 +551,23 @@ static int32 do_main(ZIO *z, int32 bin) {
 	return status;
 }
 
+static int32 do_cached(const char *name, uint32 id) {
+	int32 status = 0;
+	for (uint i = 0; status == 0; i++) {
+		ChunkCacheEntry *cache = findcache(name, id);
+		if (!cache || i >= cache->chunks.size())
+			break;
+		luaC_checkGC();
+		pushchunk(cache->chunks[i]);
+		// The same allowance as when the chunk was loaded
+		int32 newelems2 = 2 * cache->chunkBlocks[i];
+		GCthreshold += newelems2;
+		status = luaD_protectedrun(MULT_RET);
+		GCthreshold -= newelems2;
+	}
+	return status;
+}
+
 void luaD_gcIM(TObject *o) {
 	TObject *im = luaT_getimbyObj(o, IM_GC);
 	if (ttype(im) != LUA_T_NIL) {
@@ -460,10 +605,60 @@ int32 lua_dobuffer(const char *buff, int32 size, const char *name) {
 
 	if (!name) {
 		build_name(buff, newname);
-		name = newname;
+		luaZ_mopen(&z, buff, size, newname);
+		return do_main(&z, buff[0] == ID_CHUNK, NULL, 0);
+	}
+
+	if (!chunkCache)
+		chunkCache = new ChunkCache();
+
+	uint32 hash = hashbuffer(buff, size);
+	ChunkCache::iterator i = chunkCache->find(name);
+	if (i != chunkCache->end()) {
+		ChunkCacheEntry *cache = i->_value;
+		if (cache->complete && cache->hash == hash && cache->size == size) {
+			uint32 id = cache->id;
+			cache->lastUse = ++chunkCacheClock;
+			cache->users++;
+			status = do_cached(name, id);
+			releasecache(name, id);
+			return status;
+		}
+		// The file changed or is still being loaded further up, start over
+		if (cache->complete && cache->users == 0) {
+			delete cache;
+			chunkCache->erase(i);
+		} else {
+			luaZ_mopen(&z, buff, size, name);
+			return do_main(&z, buff[0] == ID_CHUNK, NULL, 0);
+		}
 	}
+
+	if (chunkCache->size() >= MAXCACHEDFILES)
+		evictchunkcache();
+
+	// The entry is added right away, so that the garbage collector sees
+	// the chunks that already ran while the next ones are loaded
+	ChunkCacheEntry *cache = new ChunkCacheEntry();
+	uint32 id = ++chunkCacheClock;
+	cache->id = id;
+	cache->hash = hash;
+	cache->size = size;
+	cache->complete = false;
+	cache->users = 1;
+	cache->lastUse = id;
+	(*chunkCache)[name] = cache;
+
 	luaZ_mopen(&z, buff, size, name);
-	status = do_main(&z, buff[0] == ID_CHUNK);
+	status = do_main(&z, buff[0] == ID_CHUNK, name, id);
+	cache = findcache(name, id);
+	if (cache) {
+		cache->users--;
+		if (!cache->complete) {
+			chunkCache->erase(name);
+			delete cache;
+		}
+	}
 	return status;
 }
 
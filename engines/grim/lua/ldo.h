@@ -39,6 +39,8 @@ int32 luaD_protectedrun(int32 nResults);
 void luaD_gcIM(TObject *o);
 void luaD_travstack(int32 (*fn)(TObject *));
 void luaD_checkstack(int32 n);
+void luaD_travchunkcache(int32 (*fn)(TObject *));
+void luaD_clearchunkcache();
 
 } // end of namespace Grim
 
@@ -8,6 +8,7 @@
 
 #include "engines/grim/lua/lfunc.h"
 #include "engines/grim/lua/lmem.h"
+#include "engines/grim/lua/lprofile.h"
 #include "engines/grim/lua/lstate.h"
 
 namespace Grim {
@@ -39,6 +40,7 @@ TProtoFunc *luaF_newproto() {
 }
 
 static void freefunc(TProtoFunc *f) {
+	luaP_freeproto(f);
 	luaM_free(f->code);
 	luaM_free(f->locvars);
 	luaM_free(f->consts);
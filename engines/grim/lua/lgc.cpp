@@ -225,6 +225,7 @@ static int32 markobject(TObject *o) {
 
 static void markall() {
 	luaD_travstack(markobject); // mark stack objects
+	luaD_travchunkcache(markobject); // mark cached chunks
 	globalmark();  // mark global variable values and names
 	travlock(); // mark locked objects
 	luaT_travtagmethods(markobject);  // mark fallbacks
@@ -6,7 +6,11 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
 #define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
 
+#include "common/memorypool.h"
+#include "common/util.h"
+
 #include "engines/grim/lua/lmem.h"
+#include "engines/grim/lua/lprofile.h"
 #include "engines/grim/lua/lstate.h"
 #include "engines/grim/lua/lua.h"
 
@@ -22,23 +26,164 @@ int32 luaM_growaux(void **block, int32 nelems, int32 size, const char *errormsg,
 	return (int32)nelems;
 }
 
+luaM_ClassStats luaM_classstats[LUAM_NUMCLASSES + 1];
+
 #ifndef LUA_DEBUG
 
+/*
+** Every block carries a small header remembering its size class, so that
+** luaM_realloc can find the pool it came from without being told the old size.
+** The header is 8 bytes long to keep the user part suitably aligned.
+*/
+struct BlockHeader {
+	int32 size;
+	int32 sizeClass;
+};
+
+#define BIGBLOCK	LUAM_NUMCLASSES
+
+static const int32 classSizes[LUAM_NUMCLASSES] = { 16, 32, 48, 64, 96, 128, 192, 256, 384 };
+#define MAXCLASSSIZE	384
+
+// size class for each block size, in steps of 8 bytes
+static byte sizeToClass[(MAXCLASSSIZE >> 3) + 1];
+static Common::MemoryPool *pools[LUAM_NUMCLASSES];
+
+static bool poolsInitialized = false;
+
+// pool bytes freed since the last compaction
+static int32 freedPoolBytes = 0;
+#define TRIMTHRESHOLD	(64 * 1024)
+
+static void initPools() {
+	int32 c = 0;
+	for (int32 i = 0; i <= (MAXCLASSSIZE >> 3); i++) {
+		if ((i << 3) > classSizes[c])
+			c++;
+		sizeToClass[i] = c;
+	}
+	for (c = 0; c < LUAM_NUMCLASSES; c++)
+		luaM_classstats[c].chunkSize = classSizes[c];
+	luaM_classstats[BIGBLOCK].chunkSize = 0;
+	poolsInitialized = true;
+}
+
+static inline void countAlloc(int32 sizeClass, int32 size) {
+	luaM_ClassStats &s = luaM_classstats[sizeClass];
+	s.allocs++;
+	s.liveBytes += size;
+	if (++s.live > s.peak)
+		s.peak = s.live;
+}
+
+static inline void countFree(int32 sizeClass, int32 size) {
+	luaM_ClassStats &s = luaM_classstats[sizeClass];
+	s.frees++;
+	s.liveBytes -= size;
+	s.live--;
+}
+
+static void *allocBlock(int32 size) {
+	BlockHeader *h;
+	int32 sizeClass;
+	if (size <= MAXCLASSSIZE) {
+		if (!poolsInitialized)
+			initPools();
+		sizeClass = sizeToClass[(size + 7) >> 3];
+		if (!pools[sizeClass])
+			pools[sizeClass] = new Common::MemoryPool(sizeof(BlockHeader) + classSizes[sizeClass]);
+		h = (BlockHeader *)pools[sizeClass]->allocChunk();
+	} else {
+		sizeClass = BIGBLOCK;
+		h = (BlockHeader *)malloc(sizeof(BlockHeader) + size);
+		if (!h)
+			lua_error(memEM);
+	}
+	h->size = size;
+	h->sizeClass = sizeClass;
+	countAlloc(sizeClass, size);
+	if (lua_profiling)
+		luaP_countalloc(size);
+	return h + 1;
+}
+
+static void freeBlock(BlockHeader *h) {
+	countFree(h->sizeClass, h->size);
+	if (h->sizeClass == BIGBLOCK) {
+		free(h);
+	} else {
+		freedPoolBytes += classSizes[h->sizeClass];
+		pools[h->sizeClass]->freeChunk(h);
+	}
+}
+
 /*
 ** generic allocation routine.
-** real ANSI systems do not need some of these tests,
-** since realloc(NULL, s)==malloc(s) and realloc(b, 0)==free(b).
-** But some systems (e.g. Sun OS) are not that ANSI...
+** Small blocks that still fit their chunk are resized in place, big blocks
+** are handed to realloc, and anything moving between classes is copied.
 */
 void *luaM_realloc(void *block, int32 size) {
+	if (!block)
+		return size == 0 ? NULL : allocBlock(size);
+
+	BlockHeader *h = (BlockHeader *)block - 1;
 	if (size == 0) {
-		free(block);
+		freeBlock(h);
 		return NULL;
 	}
-	block = block ? realloc(block, size) : malloc(size);
-	if (!block)
-		lua_error(memEM);
-	return block;
+
+	if (h->sizeClass == BIGBLOCK) {
+		if (size > MAXCLASSSIZE) {
+			int32 oldSize = h->size;
+			h = (BlockHeader *)realloc(h, sizeof(BlockHeader) + size);
+			if (!h)
+				lua_error(memEM);
+			luaM_classstats[BIGBLOCK].liveBytes += size - oldSize;
+			if (lua_profiling && size > oldSize)
+				luaP_countalloc(size - oldSize);
+			h->size = size;
+			return h + 1;
+		}
+	} else if (size <= classSizes[h->sizeClass] && (h->sizeClass == 0 || size > classSizes[h->sizeClass - 1])) {
+		luaM_classstats[h->sizeClass].liveBytes += size - h->size;
+		h->size = size;
+		return block;
+	}
+
+	void *newBlock = allocBlock(size);
+	memcpy(newBlock, block, MIN(size, h->size));
+	freeBlock(h);
+	return newBlock;
+}
+
+/*
+** Give back to the system the pool pages that have no live block left.
+** Called when the Lua states are torn down, which is when most of them
+** become empty at once.
+*/
+void luaM_compact() {
+	for (int32 c = 0; c < LUAM_NUMCLASSES; c++) {
+		if (!pools[c])
+			continue;
+		if (luaM_classstats[c].live == 0) {
+			// nothing references this pool anymore, drop it altogether
+			delete pools[c];
+			pools[c] = NULL;
+		} else {
+			pools[c]->freeUnusedPages();
+		}
+	}
+	freedPoolBytes = 0;
+}
+
+/*
+** Called whenever a state goes away. Compacting walks the free lists, so it
+** is only done once enough has been given back to the pools since the last
+** time.
+*/
+void luaM_trim() {
+	if (freedPoolBytes >= TRIMTHRESHOLD)
+		luaM_compact();
 }
 
 #else
@@ -85,6 +230,12 @@ void *luaM_realloc(void *block, int32 size) {
 	return (int32 *)block+1;
 }
 
+void luaM_compact() {
+}
+
+void luaM_trim() {
+}
+
 #endif
 
 } // end of namespace Grim
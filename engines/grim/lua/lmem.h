@@ -4,7 +4,7 @@
 */
 
 #ifndef GRIM_LMEM_H
-#define GRIM_LEME_H
+#define GRIM_LMEM_H
 
 #include "common/scummsys.h"
 
@@ -19,13 +19,31 @@ namespace Grim {
 
 void *luaM_realloc (void *oldblock, int32 size);
 int32 luaM_growaux (void **block, int32 nelems, int32 size, const char *errormsg, int32 limit);
+void luaM_compact();
+void luaM_trim();
 
-#define luaM_free(b)						free((b))
-#define luaM_malloc(t)						malloc((t))
-#define luaM_new(t)							((t *)malloc(sizeof(t)))
-#define luaM_newvector(n, t)				((t *)malloc((n) * sizeof(t)))
+#define luaM_free(b)						luaM_realloc((b), 0)
+#define luaM_malloc(t)						luaM_realloc(NULL, (t))
+#define luaM_new(t)							((t *)luaM_malloc(sizeof(t)))
+#define luaM_newvector(n, t)				((t *)luaM_malloc((n) * sizeof(t)))
 #define luaM_growvector(old, n, t, e, l)	(luaM_growaux((void**)old, n, sizeof(t), e, l))
-#define luaM_reallocvector(v, n, t)			((t *)realloc(v,(n) * sizeof(t)))
+#define luaM_reallocvector(v, n, t)			((t *)luaM_realloc(v, (n) * sizeof(t)))
+
+// Small blocks are served from per size class pools, everything bigger than
+// the last class goes straight to malloc. The extra entry at the end of
+// luaM_classstats[] accounts for those big blocks.
+#define LUAM_NUMCLASSES		9
+
+struct luaM_ClassStats {
+	int32 chunkSize;  // 0 for the big blocks entry
+	int32 live;
+	int32 peak;
+	int32 liveBytes;
+	uint32 allocs;
+	uint32 frees;
+};
+
+extern luaM_ClassStats luaM_classstats[LUAM_NUMCLASSES + 1];
 
 #ifdef LUA_DEBUG
 extern int32 numblocks;
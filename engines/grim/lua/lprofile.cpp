@@ -0,0 +1,275 @@
+/*
+** Per function profiler
+** See Copyright Notice in lua.h
+*/
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
+#define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
+
+#include "common/algorithm.h"
+#include "common/file.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/system.h"
+#include "common/util.h"
+
+#include "engines/grim/lua/lprofile.h"
+#include "engines/grim/lua/lstring.h"
+#include "engines/grim/lua/ltask.h"
+
+namespace Grim {
+
+/*
+** Every Lua or C function activation is a lua_Task, so the profiler keeps its
+** bookkeeping in there: the entry of the running function, the call path
+** leading to it, when it started and how much of that went to its callees.
+** Times come from getMillis(): a single call is often measured as 0 or 1 ms,
+** but the sums over many calls are right on average.
+** While a script task sleeps in break_here its frames are kept on hold, so
+** the time spent in the other tasks is not charged to them.
+*/
+
+bool lua_profiling = false;
+
+struct PointerHash {
+	uint operator()(const void *p) const {
+		size_t v = (size_t)p;
+		return (uint)(v ^ (v >> 16));
+	}
+};
+
+// one node for each distinct call stack, for the folded output
+struct ProfilePath {
+	int32 parent;
+	int32 entry;
+	uint32 exclusive;
+};
+
+typedef Common::HashMap<const void *, int32, PointerHash> EntryIndex;
+typedef Common::HashMap<Common::String, int32> NameIndex;
+typedef Common::HashMap<uint64, int32> PathIndex;
+
+static Common::Array<luaP_Entry> *entries = NULL;
+static Common::Array<ProfilePath> *paths = NULL;
+static EntryIndex *protoIndex = NULL;
+static EntryIndex *cfuncIndex = NULL;
+static NameIndex *nameIndex = NULL;
+static PathIndex *pathIndex = NULL;
+
+static void forgetframes() {
+	for (LState *state = lua_rootState; state != NULL; state = state->next) {
+		for (lua_Task *t = state->task; t != NULL; t = t->next)
+			t->profEntry = -1;
+		state->profSuspendTime = 0;
+	}
+}
+
+void luaP_start() {
+	if (lua_profiling)
+		return;
+	if (!protoIndex) {
+		entries = new Common::Array<luaP_Entry>();
+		paths = new Common::Array<ProfilePath>();
+		protoIndex = new EntryIndex();
+		cfuncIndex = new EntryIndex();
+		nameIndex = new NameIndex();
+		pathIndex = new PathIndex();
+	}
+	// Frames entered before now have no start time
+	forgetframes();
+	lua_profiling = true;
+}
+
+void luaP_stop() {
+	lua_profiling = false;
+}
+
+void luaP_reset() {
+	forgetframes();
+	if (protoIndex) {
+		entries->clear();
+		paths->clear();
+		protoIndex->clear();
+		cfuncIndex->clear();
+		nameIndex->clear();
+		pathIndex->clear();
+	}
+}
+
+static int32 newentry(const Common::String &name, lua_CFunction f) {
+	luaP_Entry e;
+	e.name = name;
+	e.cfunc = f;
+	e.calls = 0;
+	e.inclusive = 0;
+	e.exclusive = 0;
+	e.allocBytes = 0;
+	entries->push_back(e);
+	return entries->size() - 1;
+}
+
+static int32 protoentry(TProtoFunc *tf) {
+	EntryIndex::iterator i = protoIndex->find(tf);
+	if (i != protoIndex->end())
+		return i->_value;
+
+	// The same function loaded again shares its entry with the old one
+	Common::String name = Common::String::format("%s:%d", tf->fileName ? tf->fileName->str : "?", tf->lineDefined);
+	int32 entry;
+	NameIndex::iterator n = nameIndex->find(name);
+	if (n != nameIndex->end()) {
+		entry = n->_value;
+	} else {
+		entry = newentry(name, NULL);
+		(*nameIndex)[name] = entry;
+	}
+	(*protoIndex)[tf] = entry;
+	return entry;
+}
+
+static int32 cfuncentry(lua_CFunction f) {
+	const void *key = (const void *)f;
+	EntryIndex::iterator i = cfuncIndex->find(key);
+	if (i != cfuncIndex->end())
+		return i->_value;
+
+	// the name is looked up when making the report
+	int32 entry = newentry("", f);
+	(*cfuncIndex)[key] = entry;
+	return entry;
+}
+
+static int32 pathnode(int32 parent, int32 entry) {
+	uint64 key = ((uint64)(uint32)(parent + 1) << 32) | (uint32)entry;
+	PathIndex::iterator i = pathIndex->find(key);
+	if (i != pathIndex->end())
+		return i->_value;
+
+	ProfilePath p;
+	p.parent = parent;
+	p.entry = entry;
+	p.exclusive = 0;
+	paths->push_back(p);
+	(*pathIndex)[key] = paths->size() - 1;
+	return paths->size() - 1;
+}
+
+void luaP_enter(lua_Task *task, TProtoFunc *tf, lua_CFunction f) {
+	int32 entry = tf ? protoentry(tf) : cfuncentry(f);
+	lua_Task *parent = task->next;
+	int32 parentPath = (parent && parent->profEntry >= 0) ? parent->profPath : -1;
+
+	(*entries)[entry].calls++;
+	task->profEntry = entry;
+	task->profPath = pathnode(parentPath, entry);
+	task->profStart = g_system->getMillis();
+	task->profChild = 0;
+}
+
+void luaP_leave(lua_Task *task) {
+	if (task->profEntry < 0)
+		return;
+
+	uint32 inclusive = g_system->getMillis() - task->profStart;
+	uint32 exclusive = inclusive - MIN(inclusive, task->profChild);
+	luaP_Entry &e = (*entries)[task->profEntry];
+	e.inclusive += inclusive;
+	e.exclusive += exclusive;
+	(*paths)[task->profPath].exclusive += exclusive;
+	task->profEntry = -1;
+
+	lua_Task *parent = task->next;
+	if (parent && parent->profEntry >= 0)
+		parent->profChild += inclusive;
+}
+
+void luaP_suspend(LState *state) {
+	state->profSuspendTime = g_system->getMillis();
+}
+
+void luaP_resume(LState *state) {
+	if (!state->profSuspendTime)
+		return;
+
+	uint32 suspended = g_system->getMillis() - state->profSuspendTime;
+	for (lua_Task *t = state->task; t != NULL; t = t->next) {
+		if (t->profEntry >= 0)
+			t->profStart += suspended;
+	}
+	state->profSuspendTime = 0;
+}
+
+void luaP_countalloc(int32 size) {
+	if (lua_state && lua_state->task && lua_state->task->profEntry >= 0)
+		(*entries)[lua_state->task->profEntry].allocBytes += size;
+}
+
+void luaP_freeproto(TProtoFunc *tf) {
+	// the address may be reused by a different function
+	if (protoIndex)
+		protoIndex->erase(tf);
+}
+
+static Common::String entryname(const luaP_Entry &e) {
+	if (!e.cfunc)
+		return e.name;
+
+	for (TaggedString *g = (TaggedString *)rootglobal.next; g; g = (TaggedString *)g->head.next) {
+		if (ttype(&g->globalval) == LUA_T_CPROTO && fvalue(&g->globalval) == e.cfunc)
+			return g->str;
+	}
+	return Common::String::format("(C) %p", (const void *)e.cfunc);
+}
+
+static bool compareexclusive(const luaP_Entry &a, const luaP_Entry &b) {
+	return a.exclusive > b.exclusive || (a.exclusive == b.exclusive && a.calls > b.calls);
+}
+
+void luaP_getreport(Common::Array<luaP_Entry> &report) {
+	if (!entries)
+		return;
+	report = *entries;
+	for (uint i = 0; i < report.size(); i++)
+		report[i].name = entryname(report[i]);
+	Common::sort(report.begin(), report.end(), compareexclusive);
+}
+
+/*
+** Writes one "caller;...;callee milliseconds" line for each call stack, the
+** format expected by flamegraph.pl and similar tools.
+*/
+bool luaP_dumpfolded(const char *filename) {
+	Common::DumpFile out;
+	if (!entries || !out.open(filename))
+		return false;
+
+	Common::Array<Common::String> names;
+	for (uint i = 0; i < entries->size(); i++) {
+		Common::String name = entryname((*entries)[i]);
+		// ';' separates the frames
+		for (uint j = 0; j < name.size(); j++) {
+			if (name[j] == ';')
+				name.setChar(':', j);
+		}
+		names.push_back(name);
+	}
+
+	for (uint i = 0; i < paths->size(); i++) {
+		const ProfilePath &path = (*paths)[i];
+		if (!path.exclusive)
+			continue;
+		Common::String line = Common::String::format(" %u\n", path.exclusive);
+		for (int32 p = i; p >= 0; p = (*paths)[p].parent) {
+			line = names[(*paths)[p].entry] + line;
+			if ((*paths)[p].parent >= 0)
+				line = ";" + line;
+		}
+		out.writeString(line);
+	}
+
+	out.flush();
+	out.close();
+	return true;
+}
+
+} // end of namespace Grim
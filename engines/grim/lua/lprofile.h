@@ -0,0 +1,49 @@
+/*
+** Per function profiler
+** See Copyright Notice in lua.h
+*/
+
+#ifndef GRIM_LPROFILE_H
+#define GRIM_LPROFILE_H
+
+#include "common/array.h"
+#include "common/str.h"
+
+#include "engines/grim/lua/lua.h"
+#include "engines/grim/lua/lobject.h"
+#include "engines/grim/lua/lstate.h"
+
+namespace Grim {
+
+struct lua_Task;
+
+struct luaP_Entry {
+	Common::String name;
+	lua_CFunction cfunc;  // NULL for Lua functions
+	uint32 calls;
+	uint32 inclusive;  // milliseconds, callees included
+	uint32 exclusive;  // milliseconds spent in the function itself
+	uint32 allocBytes;
+};
+
+extern bool lua_profiling;
+
+void luaP_start();
+void luaP_stop();
+void luaP_reset();
+
+// hooks, only to be called while lua_profiling is set
+void luaP_enter(lua_Task *task, TProtoFunc *tf, lua_CFunction f);
+void luaP_leave(lua_Task *task);
+void luaP_suspend(LState *state);
+void luaP_resume(LState *state);
+void luaP_countalloc(int32 size);
+
+void luaP_freeproto(TProtoFunc *tf);
+
+void luaP_getreport(Common::Array<luaP_Entry> &report);
+bool luaP_dumpfolded(const char *filename);
+
+} // end of namespace Grim
+
+#endif
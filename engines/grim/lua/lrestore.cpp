@@ -586,6 +586,9 @@ void lua_Restore(SaveGame *savedState) {
 			recreateObj(&state->taskFunc);
 	}
 
+	for (state = lua_rootState->next; state != NULL; state = state->next)
+		lua_registerstate(state);
+
 	for (; currentState; currentState--)
 		lua_state = lua_state->next;
 
@@ -93,6 +93,14 @@ void lua_stateinit(LState *state) {
 	state->some_task = NULL;
 	state->taskFunc.ttype = LUA_T_NIL;
 	state->sleepFor = 0;
+	state->runPrev = NULL;
+	state->runNext = NULL;
+	state->sleepNext = NULL;
+	state->queued = false;
+	state->sleeping = false;
+	state->wakeTime = 0;
+	state->updateFrame = 0;
+	state->profSuspendTime = 0;
 
 	state->stack.stack = luaM_newvector(STACK_UNIT, TObject);
 	state->stack.top = state->stack.stack;
@@ -100,6 +108,8 @@ void lua_stateinit(LState *state) {
 }
 
 void lua_statedeinit(LState *state) {
+	lua_unregisterstate(state);
+
 	if (state->prev)
 		state->prev->next = state->next;
 	if (state->next)
@@ -116,7 +126,8 @@ void lua_statedeinit(LState *state) {
 		}
 	}
 
-	free(state->stack.stack);
+	luaM_free(state->stack.stack);
+	luaM_trim();
 }
 
 void lua_resetglobals() {
@@ -213,6 +224,8 @@ void lua_open() {
 }
 
 void lua_close() {
+	luaD_clearchunkcache();
+
 	TaggedString *alludata = luaS_collectudata();
 	GCthreshold = MAX_INT;  // to avoid GC during GC
 	luaC_hashcallIM((Hash *)roottable.next);  // GC t.methods for tables
@@ -240,6 +253,9 @@ void lua_close() {
 	refArray = NULL;
 	lua_rootState = lua_state = NULL;
 
+	lua_resettasks();
+	luaM_compact();
+
 #ifdef LUA_DEBUG
 	printf("total de blocos: %ld\n", numblocks);
 	printf("total de memoria: %ld\n", totalmem);
@@ -91,6 +91,14 @@ struct LState {
 	struct C_Lua_Stack Cblocks[MAX_C_BLOCKS];
 	int numCblocks; // number of nested Cblocks
 	int sleepFor;
+	LState *runPrev; // handle to previous state in the run queue
+	LState *runNext; // handle to next state in the run queue
+	LState *sleepNext; // handle to next state in the sleeping list
+	bool queued; // flag mean if task is in the run queue
+	bool sleeping; // flag mean if task is in the sleeping list
+	uint32 wakeTime; // task clock time when a sleeping task runs again
+	uint32 updateFrame; // task frame in which the task last ran
+	uint32 profSuspendTime; // time at which the profiler saw the task yield
 };
 
 extern LState *lua_state, *lua_rootState;
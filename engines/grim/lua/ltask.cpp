@@ -9,19 +9,130 @@
 #include "engines/grim/lua/lapi.h"
 #include "engines/grim/lua/lauxlib.h"
 #include "engines/grim/lua/lmem.h"
+#include "engines/grim/lua/lprofile.h"
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/lvm.h"
 #include "engines/grim/grim.h"
 
+#include "common/hashmap.h"
 #include "common/textconsole.h"
 
 namespace Grim {
 
+/*
+** Tasks are kept in the lua_rootState list, in creation order, which is also
+** the order they are run in. On top of that an id index makes the lookups
+** done by the script functions cheap, a run queue holds only the tasks that
+** are neither paused nor sleeping, and the sleeping ones are kept sorted by
+** wake up time, so that lua_runtasks never has to look at idle tasks.
+*/
+static Common::HashMap<uint32, LState *> *stateIndex = NULL;
+static LState *runQueue = NULL;
+static LState *sleepList = NULL;
+static uint32 taskClock = 0;
+static uint32 taskFrame = 0;
+
+static void enqueueState(LState *state) {
+	// Keep the run queue in the same order as the task list
+	LState *prev = state->prev;
+	while (prev && !prev->queued)
+		prev = prev->prev;
+
+	state->runPrev = prev;
+	state->runNext = prev ? prev->runNext : runQueue;
+	if (state->runNext)
+		state->runNext->runPrev = state;
+	if (prev)
+		prev->runNext = state;
+	else
+		runQueue = state;
+	state->queued = true;
+
+	// A task that did not run yet in this frame is due for an update
+	if (state->updateFrame != taskFrame)
+		state->updated = false;
+}
+
+static void dequeueState(LState *state) {
+	if (state->runPrev)
+		state->runPrev->runNext = state->runNext;
+	else
+		runQueue = state->runNext;
+	if (state->runNext)
+		state->runNext->runPrev = state->runPrev;
+	state->runPrev = NULL;
+	state->runNext = NULL;
+	state->queued = false;
+}
+
+static void removeSleepingState(LState *state) {
+	LState **s = &sleepList;
+	while (*s != state)
+		s = &(*s)->sleepNext;
+	*s = state->sleepNext;
+	state->sleepNext = NULL;
+	state->sleeping = false;
+}
+
+static void sleepState(LState *state) {
+	state->wakeTime = taskClock + state->sleepFor;
+	state->sleepFor = 0;
+	state->sleeping = true;
+
+	LState **s = &sleepList;
+	while (*s && (int32)((*s)->wakeTime - state->wakeTime) <= 0)
+		s = &(*s)->sleepNext;
+	state->sleepNext = *s;
+	*s = state;
+}
+
+void lua_schedulestate(LState *state) {
+	bool runnable = !state->paused && !state->sleeping;
+	if (runnable && !state->queued)
+		enqueueState(state);
+	else if (!runnable && state->queued)
+		dequeueState(state);
+}
+
+void lua_registerstate(LState *state) {
+	if (!stateIndex)
+		stateIndex = new Common::HashMap<uint32, LState *>();
+	(*stateIndex)[state->id] = state;
+	lua_schedulestate(state);
+}
+
+void lua_unregisterstate(LState *state) {
+	if (state->queued)
+		dequeueState(state);
+	if (state->sleeping)
+		removeSleepingState(state);
+	if (stateIndex) {
+		Common::HashMap<uint32, LState *>::iterator i = stateIndex->find(state->id);
+		if (i != stateIndex->end() && i->_value == state)
+			stateIndex->erase(i);
+	}
+}
+
+void lua_resettasks() {
+	delete stateIndex;
+	stateIndex = NULL;
+	runQueue = NULL;
+	sleepList = NULL;
+}
+
+LState *lua_findstate(uint32 id) {
+	if (!stateIndex)
+		return NULL;
+	Common::HashMap<uint32, LState *>::iterator i = stateIndex->find(id);
+	return i != stateIndex->end() ? i->_value : NULL;
+}
+
 void lua_taskinit(lua_Task *task, lua_Task *next, StkId tbase, int results) {
 	task->some_flag = 0;
 	task->next = next;
 	task->some_base = tbase;
 	task->some_results = results;
+	task->profEntry = -1;
 }
 
 void lua_taskresume(lua_Task *task, Closure *closure, TProtoFunc *protofunc, StkId tbase) {
@@ -59,6 +170,7 @@ void start_script() {
 
 	state->taskFunc.ttype = type;
 	state->taskFunc.value = Address(paramObj)->value;
+	lua_registerstate(state);
 
 	int l = 2;
 	for (lua_Object object = lua_getparam(l++); object != LUA_NOOBJECT; object = lua_getparam(l++)) {
@@ -85,17 +197,15 @@ void next_script() {
 
 	if (type == LUA_T_TASK) {
 		uint32 task = (uint32)nvalue(Address(paramObj));
-		LState *state;
-		for (state = lua_rootState->next; state != NULL; state = state->next) {
-			if (state->id == task) {
-				if (state->next) {
-					ttype(lua_state->stack.top) = LUA_T_TASK;
-					nvalue(lua_state->stack.top) = (float)state->next->id;
-					incr_top;
-				} else
-					lua_pushnil();
-				return;
-			}
+		LState *state = lua_findstate(task);
+		if (state) {
+			if (state->next) {
+				ttype(lua_state->stack.top) = LUA_T_TASK;
+				nvalue(lua_state->stack.top) = (float)state->next->id;
+				incr_top;
+			} else
+				lua_pushnil();
+			return;
 		}
 	}
 
@@ -117,10 +227,7 @@ void stop_script() {
 
 	if (type == LUA_T_TASK) {
 		uint32 task = (uint32)nvalue(Address(paramObj));
-		for (state = lua_rootState->next; state != NULL; state = state->next) {
-			if (state->id == task)
-				break;
-		}
+		state = lua_findstate(task);
 		if (state) {
 			if (state != lua_state) {
 				lua_statedeinit(state);
@@ -155,12 +262,10 @@ void identify_script() {
 		lua_error("Bad argument to identify_script");
 
 	uint32 task = (uint32)nvalue(Address(paramObj));
-	LState *state;
-	for (state = lua_rootState->next; state != NULL; state = state->next) {
-		if (state->id == task) {
-			luaA_pushobject(&state->taskFunc);
-			return;
-		}
+	LState *state = lua_findstate(task);
+	if (state) {
+		luaA_pushobject(&state->taskFunc);
+		return;
 	}
 
 	lua_pushnil();
@@ -180,13 +285,10 @@ void find_script() {
 
 	if (type == LUA_T_TASK) {
 		uint32 task = (uint32)nvalue(Address(paramObj));
-		LState *state;
-		for (state = lua_rootState->next; state != NULL; state = state->next) {
-			if (state->id == task) {
-				lua_pushobject(paramObj);
-				lua_pushnumber(1.0f);
-				return;
-			}
+		if (lua_findstate(task)) {
+			lua_pushobject(paramObj);
+			lua_pushnumber(1.0f);
+			return;
 		}
 	} else if (type == LUA_T_PROTO || type == LUA_T_CPROTO) {
 		int task = -1, countTasks = 0;
@@ -221,8 +323,10 @@ void pause_scripts() {
 	LState *t;
 
 	for (t = lua_rootState->next; t != NULL; t = t->next) {
-		if (lua_state != t)
+		if (lua_state != t) {
 			t->paused = true;
+			lua_schedulestate(t);
+		}
 	}
 }
 
@@ -230,8 +334,10 @@ void unpause_scripts() {
 	LState *t;
 
 	for (t = lua_rootState->next; t != NULL; t = t->next) {
-		if (lua_state != t)
+		if (lua_state != t) {
 			t->paused = false;
+			lua_schedulestate(t);
+		}
 	}
 }
 
@@ -257,29 +363,36 @@ void lua_runtasks() {
 		return;
 	}
 
-	// Mark all the states to be updated
-	LState *state = lua_state->next;
-	do {
-		if (state->sleepFor > 0) {
-			state->sleepFor -= g_grim->getFrameTime();
-		} else {
-			state->updated = false;
-		}
-		state = state->next;
-	} while	(state);
+	taskFrame++;
+
+	// Wake up the sleeping states whose time is over
+	while (sleepList && (int32)(taskClock - sleepList->wakeTime) >= 0) {
+		LState *state = sleepList;
+		sleepList = state->sleepNext;
+		state->sleepNext = NULL;
+		state->sleeping = false;
+		lua_schedulestate(state);
+	}
+	taskClock += g_grim->getFrameTime();
+
+	// Mark all the runnable states to be updated
+	for (LState *state = runQueue; state; state = state->runNext)
+		state->updated = false;
 
 	// And run them
 	runtasks(lua_state);
 }
 
 void runtasks(LState *const rootState) {
-	lua_state = lua_state->next;
+	lua_state = runQueue;
 	while (lua_state) {
 		LState *nextState = NULL;
 		bool stillRunning;
-		if (!lua_state->updated && !lua_state->paused) {
+		if (!lua_state->updated) {
 			jmp_buf	errorJmp;
 			lua_state->errorJmp = &errorJmp;
+			if (lua_profiling)
+				luaP_resume(lua_state);
 			if (setjmp(errorJmp)) {
 				lua_Task *t, *m;
 				for (t = lua_state->task; t != NULL;) {
@@ -299,16 +412,23 @@ void runtasks(LState *const rootState) {
 					stillRunning = luaD_call(base + 1, 255);
 				}
 			}
-			nextState = lua_state->next;
+			nextState = lua_state->runNext;
 			// The state returned. Delete it
 			if (!stillRunning) {
 				lua_statedeinit(lua_state);
 				luaM_free(lua_state);
 			} else {
+				if (lua_profiling)
+					luaP_suspend(lua_state);
 				lua_state->updated = true;
+				lua_state->updateFrame = taskFrame;
+				if (lua_state->sleepFor > 0) {
+					sleepState(lua_state);
+					lua_schedulestate(lua_state);
+				}
 			}
 		} else {
-			nextState = lua_state->next;
+			nextState = lua_state->runNext;
 		}
 		lua_state = nextState;
 	}
@@ -316,14 +436,12 @@ void runtasks(LState *const rootState) {
 	// Restore the value of lua_state to the main script
 	lua_state = rootState;
 	// Check for states that may have been created in this run.
-	LState *state = lua_state->next;
-	while (state) {
-		if (!state->paused && !state->updated) {
+	for (LState *state = runQueue; state; state = state->runNext) {
+		if (!state->updated) {
 			// New state! Run a new pass.
 			runtasks(rootState);
 			return;
 		}
-		state = state->next;
 	}
 }
 
@@ -18,6 +18,10 @@ struct lua_Task {
 	bool some_flag;
 	StkId some_base;
 	int32 some_results;
+	int32 profEntry; // profiler entry of the running function, -1 if none
+	int32 profPath; // profiler call path of the running function
+	uint32 profStart; // time at which the function was entered
+	uint32 profChild; // time spent in called functions
 };
 
 void lua_taskinit(lua_Task *task, lua_Task *next, StkId tbase, int results);
@@ -36,6 +40,12 @@ void sleep_for();
 
 void runtasks(LState *const rootState);
 
+void lua_registerstate(LState *state);
+void lua_unregisterstate(LState *state);
+void lua_schedulestate(LState *state);
+LState *lua_findstate(uint32 id);
+void lua_resettasks();
+
 } // end of namespace Grim
 
 #endif
@@ -211,6 +211,37 @@ MaterialData::~MaterialData() {
 	delete[] _textures;
 }
 
+void MaterialData::releaseTextures() {
+	bool dataFreed = false;
+	for (int i = 0; i < _numImages; ++i) {
+		Texture *t = _textures + i;
+		if (t->_width && t->_height && t->_texture) {
+			g_driver->destroyMaterial(t);
+			t->_texture = NULL;
+			if (!t->_data)
+				dataFreed = true;
+		}
+	}
+	if (!dataFreed)
+		return;
+
+	// The image data is thrown away once uploaded, so read it again
+	Common::SeekableReadStream *data = g_resourceloader->openNewStreamFile(_fname.c_str(), true);
+	if (!data)
+		error("Could not find material %s", _fname.c_str());
+
+	for (int i = 0; i < _numImages; ++i)
+		delete[] _textures[i]._data;
+	delete[] _textures;
+
+	if (g_grim->getGameType() == GType_MONKEY4) {
+		initEMI(data);
+	} else {
+		initGrim(data, _cmap.object());
+	}
+	delete data;
+}
+
 MaterialData *MaterialData::getMaterialData(const Common::String &filename, Common::SeekableReadStream *data, CMap *cmap) {
 	if (!_materials) {
 		_materials = new Common::List<MaterialData *>();
@@ -46,6 +46,12 @@ public:
 	~MaterialData();
 
 	static MaterialData *getMaterialData(const Common::String &filename, Common::SeekableReadStream *data, CMap *cmap);
+
+	/**
+	 * Destroys the driver-side textures, before switching renderer.
+	 * The textures are created again when the material is next selected.
+	 */
+	void releaseTextures();
 	static Common::List<MaterialData *> *_materials;
 
 	Common::String _fname;
@@ -51,6 +51,7 @@ MODULE_OBJS := \
 	lua/lmathlib.o \
 	lua/lmem.o \
 	lua/lobject.o \
+	lua/lprofile.o \
 	lua/lrestore.o \
 	lua/lsave.o \
 	lua/lstate.o \
@@ -81,6 +82,7 @@ MODULE_OBJS := \
 	costume.o \
 	color.o \
 	colormap.o \
+	console.o \
 	debug.o \
 	detection.o \
 	font.o \
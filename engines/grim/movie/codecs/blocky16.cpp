@@ -28,62 +28,54 @@
 
 namespace Grim {
 
-#if defined(SCUMM_NEED_ALIGNMENT)
-
-#define COPY_4X1_LINE(dst, src)			\
-	do {					\
-		(dst)[0] = (src)[0];	\
-		(dst)[1] = (src)[1];	\
-		(dst)[2] = (src)[2];	\
-		(dst)[3] = (src)[3];	\
-	} while (0)
-
-#if defined(SCUMM_BIG_ENDIAN)
-
-#define WRITE_2X1_LINE(dst, v)		\
-	do {				\
-		(dst)[0] = (byte)((v >> 8) & 0xFF);	\
-		(dst)[1] = (byte)((v >> 0) & 0xFF);	\
-	} while (0)
-
-#define WRITE_4X1_LINE(dst, v)		\
-	do {				\
-		(dst)[0] = (byte)((v >> 24) & 0xFF);	\
-		(dst)[1] = (byte)((v >> 16) & 0XFF);	\
-		(dst)[2] = (byte)((v >>  8) & 0xFF);	\
-		(dst)[3] = (byte)((v >>  0) & 0xFF);	\
-	} while (0)
-
-#else /* SCUMM_BIG_ENDIAN */
-
-#define WRITE_2X1_LINE(dst, v)		\
-	do {				\
-		(dst)[0] = (byte)((v >> 0) & 0xFF);	\
-		(dst)[1] = (byte)((v >> 8) & 0xFF);	\
-	} while (0)
-
-#define WRITE_4X1_LINE(dst, v)		\
-	do {				\
-		(dst)[0] = (byte)((v >>  0) & 0xFF);	\
-		(dst)[1] = (byte)((v >>  8) & 0XFF);	\
-		(dst)[2] = (byte)((v >> 16) & 0xFF);	\
-		(dst)[3] = (byte)((v >> 24) & 0xFF);	\
-	} while (0)
-
-#endif
+/**
+ * Copy a block of kSize x kSize pixels from offset bytes away, a row at a
+ * time. When the source overlaps the row written, the row is copied 4 bytes
+ * at a time instead, which is what the original decoder did.
+ */
+template<int kSize>
+static inline void copyBlock(byte *dst, int32 offset, int pitch) {
+	const int rowSize = kSize * 2;
 
-#else /* SCUMM_NEED_ALIGNMENT */
+	if (offset >= rowSize || offset <= -rowSize) {
+		for (int i = 0; i < kSize; i++) {
+			memcpy(dst, dst + offset, rowSize);
+			dst += pitch;
+		}
+	} else {
+		for (int i = 0; i < kSize; i++) {
+			for (int j = 0; j < rowSize; j += 4)
+				memmove(dst + j, dst + offset + j, 4);
+			dst += pitch;
+		}
+	}
+}
 
-#define COPY_4X1_LINE(dst, src)			\
-	*(uint32 *)(dst) = *(const uint32 *)(src);
+/** Fill a block of kSize x kSize pixels with a colour. */
+template<int kSize>
+static inline void fillBlock(byte *dst, uint16 color, int pitch) {
+	uint16 row[kSize];
+	for (int i = 0; i < kSize; i++)
+		row[i] = color;
 
-#define WRITE_2X1_LINE(dst, v)		\
-	*(uint16 *)(dst) = v;
+	for (int i = 0; i < kSize; i++) {
+		memcpy(dst, row, sizeof(row));
+		dst += pitch;
+	}
+}
 
-#define WRITE_4X1_LINE(dst, v)		\
-	*(uint32 *)(dst) = v;
+/** Fill a block of kSize x kSize pixels with two colours, following a pattern. */
+template<int kSize>
+static inline void patternBlock(byte *dst, const byte *pattern, uint16 color1, uint16 color2, int pitch) {
+	for (int i = 0; i < kSize; i++) {
+		uint16 row[kSize];
+		for (int j = 0; j < kSize; j++)
+			row[j] = (pattern[i] & (1 << j)) ? color1 : color2;
 
-#endif
+		memcpy(dst, row, sizeof(row));
+		dst += pitch;
+	}
+}
 
 static int8 blocky16_table_small1[] = {
 	0, 1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 1, 2, 2, 1,
@@ -162,39 +154,23 @@ void Blocky16::makeTablesInterpolation(int param) {
 	int32 tableSmallBig[64], tmp, s;
 	int8 *table47_1 = 0, *table47_2 = 0;
 	int32 *ptr_small_big;
-	byte *ptr;
+	byte *patterns;
 	int i, x, y;
 
 	if (param == 8) {
 		table47_1 = blocky16_table_big1;
 		table47_2 = blocky16_table_big2;
-		ptr = _tableBig + 384;
-		for (i = 0; i < 256; i++) {
-			*ptr = 0;
-			ptr += 388;
-		}
-		ptr = _tableBig + 385;
-		for (i = 0; i < 256; i++) {
-			*ptr = 0;
-			ptr += 388;
-		}
+		patterns = &_patternsBig[0][0];
 	} else if (param == 4) {
 		table47_1 = blocky16_table_small1;
 		table47_2 = blocky16_table_small2;
-		ptr = _tableSmall + 96;
-		for (i = 0; i < 256; i++) {
-			*ptr = 0;
-			ptr += 128;
-		}
-		ptr = _tableSmall + 97;
-		for (i = 0; i < 256; i++) {
-			*ptr = 0;
-			ptr += 128;
-		}
+		patterns = &_patternsSmall[0][0];
 	} else {
 		error("Blocky16::makeTablesInterpolation: unknown param %d", param);
 	}
 
+	memset(patterns, 0, 256 * param);
+
 	s = 0;
 	for (x = 0; x < 16; x++) {
 		value_table47_1_1 = table47_1[x];
@@ -285,30 +261,11 @@ void Blocky16::makeTablesInterpolation(int param) {
 				}
 			}
 
-			if (param == 8) {
-				for (i = 64 - 1; i >= 0; i--) {
-					if (tableSmallBig[i] != 0) {
-						_tableBig[256 + s + _tableBig[384 + s]] = (byte)i;
-						_tableBig[384 + s]++;
-					} else {
-						_tableBig[320 + s + _tableBig[385 + s]] = (byte)i;
-						_tableBig[385 + s]++;
-					}
-				}
-				s += 388;
-			}
-			if (param == 4) {
-				for (i = 16 - 1; i >= 0; i--) {
-					if (tableSmallBig[i] != 0) {
-						_tableSmall[64 + s + _tableSmall[96 + s]] = (byte)i;
-						_tableSmall[96 + s]++;
-					} else {
-						_tableSmall[80 + s + _tableSmall[97 + s]] = (byte)i;
-						_tableSmall[97 + s]++;
-					}
-				}
-				s += 128;
+			for (i = 0; i < param * param; i++) {
+				if (tableSmallBig[i] != 0)
+					patterns[s + i / param] |= 1 << (i % param);
 			}
+			s += param;
 		}
 	}
 }
@@ -319,133 +276,79 @@ void Blocky16::makeTables47(int width) {
 
 	_lastTableWidth = width;
 
-	int32 a, c, d;
-	int16 tmp;
-
-	for (int l = 0; l < 512; l += 2) {
-		_table[l / 2] = (int16)(blocky16_table[l + 1] * width + blocky16_table[l]);
+	// The offsets were 16 bits wide in the original decoder. The table has
+	// no entry for the last code, which is not a motion vector anyway.
+	memset(_motionOffsets, 0, sizeof(_motionOffsets));
+	for (uint l = 0; l < ARRAYSIZE(blocky16_table); l += 2) {
+		_motionOffsets[l / 2] = (int16)(blocky16_table[l + 1] * width + blocky16_table[l]) * 2;
 	}
+}
 
-	a = 0;
-	c = 0;
-	do {
-		for (d = 0; d < _tableSmall[96 + c]; d++) {
-			tmp = _tableSmall[64 + c + d];
-			tmp = (int16)((byte)(tmp >> 2) * width + (tmp & 3));
-			_tableSmall[c + d * 2] = (byte)tmp;
-			_tableSmall[c + d * 2 + 1] = tmp >> 8;
-		}
-		for (d = 0; d < _tableSmall[97 + c]; d++) {
-			tmp = _tableSmall[80 + c + d];
-			tmp = (int16)((byte)(tmp >> 2) * width + (tmp & 3));
-			_tableSmall[32 + c + d * 2] = (byte)tmp;
-			_tableSmall[32 + c + d * 2 + 1] = tmp >> 8;
-		}
-		for (d = 0; d < _tableBig[384 + a]; d++) {
-			tmp = _tableBig[256 + a + d];
-			tmp = (int16)((byte)(tmp >> 3) * width + (tmp & 7));
-			_tableBig[a + d * 2] = (byte)tmp;
-			_tableBig[a + d * 2 + 1] = tmp >> 8;
-		}
-		for (d = 0; d < _tableBig[385 + a]; d++) {
-			tmp = _tableBig[320 + a + d];
-			tmp = (int16)((byte)(tmp >> 3) * width + (tmp & 7));
-			_tableBig[128 + a + d * 2] = (byte)tmp;
-			_tableBig[128 + a + d * 2 + 1] = tmp >> 8;
-		}
+uint16 Blocky16::readFillColor(byte code) {
+	uint16 color;
 
-		a += 388;
-		c += 128;
-	} while (c < 32768);
+	if (code == 0xFD) {
+		color = READ_LE_UINT16(_param6_7Ptr + *_d_src * 2);
+		_d_src++;
+	} else if (code == 0xFE) {
+		color = READ_LE_UINT16(_d_src);
+		_d_src += 2;
+	} else {
+		color = READ_LE_UINT16(_paramPtr + code * 2);
+	}
+
+	return color;
 }
 
 void Blocky16::level3(byte *d_dst) {
-	int32 tmp2;
-	uint32 t;
 	byte code = *_d_src++;
-	int i;
 
 	if (code <= 0xF5) {
+		int32 offset;
 		if (code == 0xF5) {
-			int16 tmp = READ_LE_UINT16(_d_src);
-			tmp2 = tmp * 2;
+			offset = (int16)READ_LE_UINT16(_d_src) * 2;
 			_d_src += 2;
 		} else {
-			tmp2 = _table[code] * 2;
-		}
-		tmp2 += _offset1;
-		for (i = 0; i < 2; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2 + 0);
-			d_dst += _d_pitch;
+			offset = _motionOffsets[code];
 		}
+		copyBlock<2>(d_dst, _offset1 + offset, _d_pitch);
 	} else if ((code == 0xFF) || (code == 0xF8)) {
-		WRITE_2X1_LINE(d_dst + 0, READ_LE_UINT16(_d_src + 0));
-		WRITE_2X1_LINE(d_dst + 2, READ_LE_UINT16(_d_src + 2));
-		d_dst += _d_pitch;
-		WRITE_2X1_LINE(d_dst + 0, READ_LE_UINT16(_d_src + 4));
-		WRITE_2X1_LINE(d_dst + 2, READ_LE_UINT16(_d_src + 6));
+		uint16 row[2];
+		row[0] = READ_LE_UINT16(_d_src + 0);
+		row[1] = READ_LE_UINT16(_d_src + 2);
+		memcpy(d_dst, row, sizeof(row));
+		row[0] = READ_LE_UINT16(_d_src + 4);
+		row[1] = READ_LE_UINT16(_d_src + 6);
+		memcpy(d_dst + _d_pitch, row, sizeof(row));
 		_d_src += 8;
-	} else if (code == 0xFD) {
-		t = *_d_src++;
-		t = READ_LE_UINT16(_param6_7Ptr + t * 2);
-		t = (t << 16) | t;
-		for (i = 0; i < 2; i++) {
-			WRITE_4X1_LINE(d_dst + 0, t);
-			d_dst += _d_pitch;
-		}
-	} else if (code == 0xFE) {
-		t = READ_LE_UINT16(_d_src);
-		_d_src += 2;
-		t = (t << 16) | t;
-		for (i = 0; i < 2; i++) {
-			WRITE_4X1_LINE(d_dst + 0, t);
-			d_dst += _d_pitch;
-		}
 	} else if (code == 0xF6) {
-		tmp2 = _offset2;
-		for (i = 0; i < 2; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp2 + 0);
-			d_dst += _d_pitch;
-		}
+		copyBlock<2>(d_dst, _offset2, _d_pitch);
 	} else if (code == 0xF7) {
-		tmp2 = READ_LE_UINT32(_d_src);
+		uint16 row[2];
+		row[0] = READ_LE_UINT16(_param6_7Ptr + _d_src[0] * 2);
+		row[1] = READ_LE_UINT16(_param6_7Ptr + _d_src[1] * 2);
+		memcpy(d_dst, row, sizeof(row));
+		row[0] = READ_LE_UINT16(_param6_7Ptr + _d_src[2] * 2);
+		row[1] = READ_LE_UINT16(_param6_7Ptr + _d_src[3] * 2);
+		memcpy(d_dst + _d_pitch, row, sizeof(row));
 		_d_src += 4;
-		WRITE_2X1_LINE(d_dst + 0, READ_LE_UINT16(_param6_7Ptr + (byte)tmp2 * 2));
-		WRITE_2X1_LINE(d_dst + 2, READ_LE_UINT16(_param6_7Ptr + (byte)(tmp2 >> 8) * 2));
-		tmp2 >>= 16;
-		d_dst += _d_pitch;
-		WRITE_2X1_LINE(d_dst + 0, READ_LE_UINT16(_param6_7Ptr + (byte)tmp2 * 2));
-		WRITE_2X1_LINE(d_dst + 2, READ_LE_UINT16(_param6_7Ptr + (byte)(tmp2 >> 8) * 2));
-	} else if ((code >= 0xF9) && (code <= 0xFC))  {
-		t = READ_LE_UINT16(_paramPtr + code * 2);
-		t = (t << 16) | t;
-		for (i = 0; i < 2; i++) {
-			WRITE_4X1_LINE(d_dst + 0, t);
-			d_dst += _d_pitch;
-		}
+	} else {
+		fillBlock<2>(d_dst, readFillColor(code), _d_pitch);
 	}
 }
 
 void Blocky16::level2(byte *d_dst) {
-	int32 tmp2;
-	uint32 t = 0, val;
 	byte code = *_d_src++;
-	int i;
 
 	if (code <= 0xF5) {
+		int32 offset;
 		if (code == 0xF5) {
-			int16 tmp = READ_LE_UINT16(_d_src);
-			tmp2 = tmp * 2;
+			offset = (int16)READ_LE_UINT16(_d_src) * 2;
 			_d_src += 2;
 		} else {
-			tmp2 = _table[code] * 2;
-		}
-		tmp2 += _offset1;
-		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
-			d_dst += _d_pitch;
+			offset = _motionOffsets[code];
 		}
+		copyBlock<4>(d_dst, _offset1 + offset, _d_pitch);
 	} else if (code == 0xFF) {
 		level3(d_dst);
 		d_dst += 4;
@@ -455,80 +358,37 @@ void Blocky16::level2(byte *d_dst) {
 		d_dst += 4;
 		level3(d_dst);
 	} else if (code == 0xF6) {
-		tmp2 = _offset2;
-		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
-			d_dst += _d_pitch;
-		}
+		copyBlock<4>(d_dst, _offset2, _d_pitch);
 	} else if ((code == 0xF7) || (code == 0xF8)) {
-		byte tmp = *_d_src++;
+		const byte *pattern = _patternsSmall[*_d_src++];
+		uint16 color1, color2;
 		if (code == 0xF8) {
-			val = READ_LE_UINT32(_d_src);
+			color1 = READ_LE_UINT16(_d_src);
+			color2 = READ_LE_UINT16(_d_src + 2);
 			_d_src += 4;
 		} else {
-			tmp2 = READ_LE_UINT16(_d_src);
-			val = READ_LE_UINT16(_param6_7Ptr + (byte)(tmp2 >> 8) * 2) << 16;
-			val |= READ_LE_UINT16(_param6_7Ptr + (byte)tmp2 * 2);
+			color1 = READ_LE_UINT16(_param6_7Ptr + _d_src[0] * 2);
+			color2 = READ_LE_UINT16(_param6_7Ptr + _d_src[1] * 2);
 			_d_src += 2;
 		}
-		byte *tmp_ptr = _tableSmall + (tmp * 128);
-		byte l = tmp_ptr[96];
-		int16 *tmp_ptr2 = (int16 *)tmp_ptr;
-		while (l--) {
-			WRITE_2X1_LINE(d_dst + READ_LE_UINT16(tmp_ptr2) * 2, val);
-			tmp_ptr2++;
-		}
-		l = tmp_ptr[97];
-		val >>= 16;
-		tmp_ptr2 = (int16 *)(tmp_ptr + 32);
-		while (l--) {
-			WRITE_2X1_LINE(d_dst + READ_LE_UINT16(tmp_ptr2) * 2, val);
-			tmp_ptr2++;
-		}
-	} else if (code >= 0xF9) {
-		if (code == 0xFD) {
-			t = *_d_src++;
-			t = READ_LE_UINT16(_param6_7Ptr + t * 2);
-			t = (t << 16) | t;
-		} else if (code == 0xFE) {
-			t = READ_LE_UINT16(_d_src);
-			t = (t << 16) | t;
-			_d_src += 2;
-		} else if ((code >= 0xF9) && (code <= 0xFC))  {
-			t = READ_LE_UINT16(_paramPtr + code * 2);
-			t = (t << 16) | t;
-		}
-		for (i = 0; i < 4; i++) {
-			WRITE_4X1_LINE(d_dst + 0, t);
-			WRITE_4X1_LINE(d_dst + 4, t);
-			d_dst += _d_pitch;
-		}
+		patternBlock<4>(d_dst, pattern, color1, color2, _d_pitch);
+	} else {
+		fillBlock<4>(d_dst, readFillColor(code), _d_pitch);
 	}
 }
 
 void Blocky16::level1(byte *d_dst) {
-	int32 tmp2;
-	uint32 t = 0, val;
 	byte code = *_d_src++;
-	int i;
 
 	if (code <= 0xF5) {
+		int32 offset;
 		if (code == 0xF5) {
-			int16 tmp = READ_LE_UINT16(_d_src);
-			tmp2 = tmp * 2;
+			offset = (int16)READ_LE_UINT16(_d_src) * 2;
 			_d_src += 2;
 		} else {
-			tmp2 = _table[code] * 2;
-		}
-		tmp2 += _offset1;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
-			COPY_4X1_LINE(d_dst +  8, d_dst + tmp2 +  8);
-			COPY_4X1_LINE(d_dst + 12, d_dst + tmp2 + 12);
-			d_dst += _d_pitch;
+			offset = _motionOffsets[code];
 		}
+		copyBlock<8>(d_dst, _offset1 + offset, _d_pitch);
 	} else if (code == 0xFF) {
 		level2(d_dst);
 		d_dst += 8;
@@ -538,59 +398,22 @@ void Blocky16::level1(byte *d_dst) {
 		d_dst += 8;
 		level2(d_dst);
 	} else if (code == 0xF6) {
-		tmp2 = _offset2;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
-			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
-			COPY_4X1_LINE(d_dst +  8, d_dst + tmp2 +  8);
-			COPY_4X1_LINE(d_dst + 12, d_dst + tmp2 + 12);
-			d_dst += _d_pitch;
-		}
+		copyBlock<8>(d_dst, _offset2, _d_pitch);
 	} else if ((code == 0xF7) || (code == 0xF8)) {
-		byte tmp = *_d_src++;
+		const byte *pattern = _patternsBig[*_d_src++];
+		uint16 color1, color2;
 		if (code == 0xF8) {
-			val = READ_LE_UINT32(_d_src);
+			color1 = READ_LE_UINT16(_d_src);
+			color2 = READ_LE_UINT16(_d_src + 2);
 			_d_src += 4;
 		} else {
-			tmp2 = READ_LE_UINT16(_d_src);
-			val = READ_LE_UINT16(_param6_7Ptr + (byte)(tmp2 >> 8) * 2) << 16;
-			val |= READ_LE_UINT16(_param6_7Ptr + (byte)tmp2 * 2);
+			color1 = READ_LE_UINT16(_param6_7Ptr + _d_src[0] * 2);
+			color2 = READ_LE_UINT16(_param6_7Ptr + _d_src[1] * 2);
 			_d_src += 2;
 		}
-		byte *tmp_ptr = _tableBig + (tmp * 388);
-		byte l = tmp_ptr[384];
-		int16 *tmp_ptr2 = (int16 *)tmp_ptr;
-		while (l--) {
-			WRITE_2X1_LINE(d_dst + READ_LE_UINT16(tmp_ptr2) * 2, val);
-			tmp_ptr2++;
-		}
-		l = tmp_ptr[385];
-		val >>= 16;
-		tmp_ptr2 = (int16 *)(tmp_ptr + 128);
-		while (l--) {
-			WRITE_2X1_LINE(d_dst + READ_LE_UINT16(tmp_ptr2) * 2, val);
-			tmp_ptr2++;
-		}
-	} else if (code >= 0xF9) {
-		if (code == 0xFD) {
-			t = *_d_src++;
-			t = READ_LE_UINT16(_param6_7Ptr + t * 2);
-			t = (t << 16) | t;
-		} else if (code == 0xFE) {
-			t = READ_LE_UINT16(_d_src);
-			t = (t << 16) | t;
-			_d_src += 2;
-		} else if ((code >= 0xF9) && (code <= 0xFC))  {
-			t = READ_LE_UINT16(_paramPtr + code * 2);
-			t = (t << 16) | t;
-		}
-		for (i = 0; i < 8; i++) {
-			WRITE_4X1_LINE(d_dst +  0, t);
-			WRITE_4X1_LINE(d_dst +  4, t);
-			WRITE_4X1_LINE(d_dst +  8, t);
-			WRITE_4X1_LINE(d_dst + 12, t);
-			d_dst += _d_pitch;
-		}
+		patternBlock<8>(d_dst, pattern, color1, color2, _d_pitch);
+	} else {
+		fillBlock<8>(d_dst, readFillColor(code), _d_pitch);
 	}
 }
 
@@ -603,12 +426,36 @@ void Blocky16::decode2(byte *dst, const byte *src, int width, int height, const
 	int next_line = width * 2 * 7;
 	_d_pitch = width * 2;
 
+	// The blocks only stay within their rows when the size is a multiple of 8.
+	// Then a run of unchanged blocks, code 0, is copied a row at a time.
+	const bool copyRuns = !(width & 7) && !(height & 7);
+
 	do {
 		int tmp_bw = bw;
-		do {
-			level1(dst);
-			dst += 16;
-		} while (--tmp_bw);
+		while (tmp_bw > 0) {
+			int run = 0;
+			if (copyRuns) {
+				while (run < tmp_bw && _d_src[run] == 0)
+					run++;
+			}
+
+			if (run > 1) {
+				const int runSize = run * 16;
+				byte *d_dst = dst;
+				for (int i = 0; i < 8; i++) {
+					memmove(d_dst, d_dst + _offset1, runSize);
+					d_dst += _d_pitch;
+				}
+
+				_d_src += run;
+				dst += runSize;
+				tmp_bw -= run;
+			} else {
+				level1(dst);
+				dst += 16;
+				tmp_bw--;
+			}
+		}
 		dst += next_line;
 	} while (--bh);
 }
@@ -634,10 +481,6 @@ void Blocky16::init(int width, int height) {
 }
 
 Blocky16::Blocky16() {
-	_tableBig = new byte[99328];
-	_tableSmall = new byte[32768];
-	memset(_tableBig, 0, 99328);
-	memset(_tableSmall, 0, 32768);
 	_deltaBuf = NULL;
 }
 
@@ -654,14 +497,6 @@ void Blocky16::deinit() {
 
 Blocky16::~Blocky16() {
 	deinit();
-	if (_tableBig) {
-		delete[] _tableBig;
-		_tableBig = NULL;
-	}
-	if (_tableSmall) {
-		delete[] _tableSmall;
-		_tableSmall = NULL;
-	}
 }
 
 static int bomp_left;
@@ -39,14 +39,17 @@ private:
 	const byte *_d_src, *_paramPtr, *_param6_7Ptr;
 	int _d_pitch;
 	int32 _offset1, _offset2;
-	byte *_tableBig;
-	byte *_tableSmall;
-	int16 _table[256];
+	// The pixels of the two-colour blocks which take the first colour, a byte per row
+	byte _patternsBig[256][8];
+	byte _patternsSmall[256][4];
+	// The motion vectors, as byte offsets for the current width
+	int32 _motionOffsets[256];
 	int32 _frameSize;
 	int _width, _height;
 
 	void makeTablesInterpolation(int param);
 	void makeTables47(int width);
+	uint16 readFillColor(byte code);
 	void level1(byte *d_dst);
 	void level2(byte *d_dst);
 	void level3(byte *d_dst);
@@ -36,21 +36,16 @@
 #include "engines/grim/movie/codecs/blocky8.h"
 #include "engines/grim/movie/codecs/blocky16.h"
 #include "engines/grim/movie/codecs/smush_decoder.h"
+#include "engines/grim/movie/codecs/vima.h"
 
 #ifdef USE_SMUSH
 
 namespace Grim {
 
-// Prototypes to avoid depending on grim.h
-void vimaInit(uint16 *destTable);
-void decompressVima(const byte *src, int16 *dest, int destLen, uint16 *destTable);
-
 #define ANNO_HEADER "MakeAnim animation type 'Bl16' parameters: "
 #define BUFFER_SIZE 16385
 #define SMUSH_SPEED 66667
 
-static uint16 smushDestTable[5786];
-
 SmushDecoder::SmushDecoder() {
 	// Set colour-format statically here for SMUSH (5650), to allow for differing
 	// PixelFormat in engine and renderer (and conversion from Surface there)
@@ -83,7 +78,7 @@ void SmushDecoder::init() {
 
 	if (!_demo) {
 		_surface.create(_width, _height, _format);
-		vimaInit(smushDestTable);
+		vimaInit();
 	}
 }
 
@@ -102,9 +97,9 @@ void SmushDecoder::close() {
 	}
 }
 
-void SmushDecoder::handleWave(const byte *src, uint32 size) {
+void SmushDecoder::handleWave(const byte *src, uint32 srcLen, uint32 size) {
 	int16 *dst = (int16 *) malloc(size * _channels * sizeof(int16));
-	decompressVima(src, dst, size * _channels * 2, smushDestTable);
+	decompressVima(src, srcLen, dst, size * _channels * 2);
 
 	int flags = Audio::FLAG_16BITS;
 	if (_channels == 2)
@@ -185,9 +180,9 @@ void SmushDecoder::handleFrame() {
 		} else if (READ_BE_UINT32(frame + pos) == MKTAG('W','a','v','e')) {
 			int decompressed_size = READ_BE_UINT32(frame + pos + 8);
 			if (decompressed_size < 0)
-				handleWave(frame + pos + 8 + 4 + 8, READ_BE_UINT32(frame + pos + 8 + 8));
+				handleWave(frame + pos + 8 + 4 + 8, size - (pos + 8 + 4 + 8), READ_BE_UINT32(frame + pos + 8 + 8));
 			else
-				handleWave(frame + pos + 8 + 4, decompressed_size);
+				handleWave(frame + pos + 8 + 4, size - (pos + 8 + 4), decompressed_size);
 			pos += READ_BE_UINT32(frame + pos + 4) + 8;
 		} else {
 			Debug::error(Debug::Movie, "SmushDecoder::handleFrame() unknown tag");
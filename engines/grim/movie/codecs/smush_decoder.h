@@ -105,7 +105,7 @@ private:
 	void handleFrameDemo();
 	void handleFrame();
 	void handleBlocky16(byte *src);
-	void handleWave(const byte *src, uint32 size);
+	void handleWave(const byte *src, uint32 srcLen, uint32 size);
 	void handleIACT(const byte *src, int32 size);
 	bool setupAnim();
 	bool setupAnimDemo();
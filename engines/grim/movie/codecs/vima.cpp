@@ -21,6 +21,9 @@
  */
 
 #include "common/endian.h"
+#include "common/util.h"
+
+#include "engines/grim/movie/codecs/vima.h"
 
 namespace Grim {
 
@@ -99,25 +102,79 @@ static int8 *offsets[] = {
 	imcOtherTable4, imcOtherTable5, imcOtherTable6
 };
 
-void vimaInit(uint16 *destTable) {
-	int destTableStartPos, incer;
-
-	for (destTableStartPos = 0, incer = 0; destTableStartPos < 64; destTableStartPos++, incer++) {
-		unsigned int destTablePos, imcTable1Pos;
-		for (imcTable1Pos = 0, destTablePos = destTableStartPos;
-				imcTable1Pos < sizeof(imcTable1) / sizeof(imcTable1[0]); imcTable1Pos++, destTablePos += 64) {
-			int put = 0, count, tableValue;
-			for (count = 32, tableValue = imcTable1[imcTable1Pos]; count != 0; count >>= 1, tableValue >>= 1) {
-				if (incer & count) {
-					put += tableValue;
-				}
+/*
+ * Every (table position, code) pair gives a fixed delta and a fixed next
+ * position, so both are worked out once in vimaInit(). An entry holds the
+ * signed delta above VIMA_DELTA_SHIFT, VIMA_ESCAPE for the code that is
+ * followed by a raw 16-bit sample, and the next (clamped) table position in
+ * the low bits. The rows only have as many entries as the codes for their
+ * bit width.
+ */
+enum {
+	VIMA_POSITIONS = 89,
+	VIMA_STEPS = 45 * 16 + 14 * 32 + 15 * 64 + 15 * 128,
+	VIMA_DELTA_SHIFT = 8,
+	VIMA_ESCAPE = 0x80,
+	VIMA_POS_MASK = 0x7f
+};
+
+static int32 vimaSteps[VIMA_STEPS];
+static uint16 vimaStepStart[VIMA_POSITIONS];
+static bool vimaInitialized = false;
+
+void vimaInit() {
+	if (vimaInitialized)
+		return;
+
+	int entry = 0;
+	for (int pos = 0; pos < VIMA_POSITIONS; pos++) {
+		int numBits = imcTable2[pos];
+		int highBit = 1 << (numBits - 1);
+		int lowBits = highBit - 1;
+
+		vimaStepStart[pos] = entry;
+		for (int code = 0; code < (highBit << 1); code++, entry++) {
+			int val = code & lowBits;
+
+			// The bits of val pick halves of the step size, the
+			// remaining half step is added for anything but 0
+			int incer = val << (7 - numBits);
+			int delta = 0;
+			int tableValue = imcTable1[pos];
+			for (int count = 32; count != 0; count >>= 1, tableValue >>= 1) {
+				if (incer & count)
+					delta += tableValue;
 			}
-			destTable[destTablePos] = put;
+			if (val)
+				delta += imcTable1[pos] >> (numBits - 1);
+			if (code & highBit)
+				delta = -delta;
+
+			int next = CLIP(pos + offsets[numBits - 2][val], 0, VIMA_POSITIONS - 1);
+			if (val == lowBits)
+				vimaSteps[entry] = VIMA_ESCAPE | next;
+			else
+				vimaSteps[entry] = delta * (1 << VIMA_DELTA_SHIFT) | next;
 		}
 	}
+	assert(entry == VIMA_STEPS);
+
+	vimaInitialized = true;
 }
 
-void decompressVima(const byte *src, int16 *dest, int destLen, uint16 *destTable) {
+/*
+ * The samples are read MSB first from a 64-bit cache, which is topped up
+ * with a 32-bit word whenever it may not hold a whole code plus a raw
+ * sample anymore. Bytes past srcLen read as zero.
+ *
+ * The right channel of a stereo block starts where the left one ends in the
+ * bit stream, and the codes have variable lengths, so the two channels are
+ * decoded one after the other.
+ */
+void decompressVima(const byte *src, int srcLen, int16 *dest, int destLen) {
+	assert(vimaInitialized);
+
+	const byte *srcEnd = src + srcLen;
 	int numChannels = 1;
 	byte sBytes[2];
 	int16 sWords[2];
@@ -136,62 +193,47 @@ void decompressVima(const byte *src, int16 *dest, int destLen, uint16 *destTable
 	}
 
 	int numSamples = destLen / (numChannels * 2);
-	int bits = READ_BE_UINT16(src);
-	int bitPtr = 0;
-	src += 2;
+	uint64 cache = 0;
+	int cacheBits = 0;
 
 	for (int channel = 0; channel < numChannels; channel++) {
 		int16 *destPos = dest + channel;
-		int currTablePos = sBytes[channel];
+		int currTablePos = MIN<int>(sBytes[channel], VIMA_POSITIONS - 1);
 		int outputWord = sWords[channel];
 
 		for (int sample = 0; sample < numSamples; sample++) {
-			int numBits = imcTable2[currTablePos];
-			bitPtr += numBits;
-			int highBit = 1 << (numBits - 1);
-			int lowBits = highBit - 1;
-			int val = (bits >> (16 - bitPtr)) & (highBit | lowBits);
-
-			if (bitPtr > 7) {
-				bits = ((bits & 0xff) << 8) | *src++;
-				bitPtr -= 8;
+			// At most 7 bits of code and 16 bits of raw sample
+			if (cacheBits < 23) {
+				if (srcEnd - src >= 4) {
+					cache |= (uint64)READ_BE_UINT32(src) << (32 - cacheBits);
+					src += 4;
+					cacheBits += 32;
+				} else {
+					while (cacheBits < 32) {
+						byte b = src < srcEnd ? *src++ : 0;
+						cache |= (uint64)b << (56 - cacheBits);
+						cacheBits += 8;
+					}
+				}
 			}
 
-			if (val & highBit)
-				val ^= highBit;
-			else
-				highBit = 0;
-
-			if (val == lowBits) {
-				outputWord = ((int16)(bits << bitPtr) & 0xffffff00);
-				bits = ((bits & 0xff) << 8) | *src++;
-				outputWord |= ((bits >> (8 - bitPtr)) & 0xff);
-				bits = ((bits & 0xff) << 8) | *src++;
+			int numBits = imcTable2[currTablePos];
+			uint32 code = (uint32)(cache >> (64 - numBits));
+			cache <<= numBits;
+			cacheBits -= numBits;
+
+			int32 step = vimaSteps[vimaStepStart[currTablePos] + code];
+			if (step & VIMA_ESCAPE) {
+				outputWord = (int16)(cache >> 48);
+				cache <<= 16;
+				cacheBits -= 16;
 			} else {
-				int index = (val << (7 - numBits)) | (currTablePos << 6);
-				int delta = destTable[index];
-
-				if (val)
-					delta += (imcTable1[currTablePos] >> (numBits - 1));
-				if (highBit)
-					delta = -delta;
-
-				outputWord += delta;
-				if (outputWord < -0x8000)
-					outputWord = -0x8000;
-				else if (outputWord > 0x7fff)
-					outputWord = 0x7fff;
+				outputWord = CLIP(outputWord + (step >> VIMA_DELTA_SHIFT), -0x8000, 0x7fff);
 			}
 
 			WRITE_BE_UINT16(destPos, outputWord);
 			destPos += numChannels;
-
-			currTablePos += offsets[numBits - 2][val];
-
-			if (currTablePos < 0)
-				currTablePos = 0;
-			else if (currTablePos > 88)
-				currTablePos = 88;
+			currTablePos = step & VIMA_POS_MASK;
 		}
 	}
 }
@@ -25,8 +25,17 @@
 
 namespace Grim {
 
-void vimaInit(uint16 *destTable);
-void decompressVima(const byte *src, int16 *dest, int destLen, uint16 *destTable);
+/**
+ * Build the decoding tables shared by SMUSH and iMUSE. Call it once before
+ * decompressVima(); calling it again does nothing.
+ */
+void vimaInit();
+
+/**
+ * Decode a VIMA block into destLen bytes of big endian 16-bit samples,
+ * interleaved if the block is stereo. No more than srcLen bytes are read.
+ */
+void decompressVima(const byte *src, int srcLen, int16 *dest, int destLen);
 
 } // end of namespace Grim
 
@@ -20,6 +20,7 @@
  *
  */
 
+#include "graphics/pixelbuffer.h"
 #include "graphics/surface.h"
 
 #include "common/system.h"
@@ -27,6 +28,7 @@
 
 #include "engines/grim/movie/movie.h"
 #include "engines/grim/grim.h"
+#include "engines/grim/gfx_base.h"
 #include "engines/grim/debug.h"
 #include "engines/grim/savegame.h"
 
@@ -46,8 +48,9 @@ MoviePlayer::MoviePlayer() {
 	_x = 0;
 	_y = 0;
 	_videoDecoder = NULL;
-	_internalSurface = NULL;
-	_externalSurface = new Graphics::Surface();
+	_backFrame = 0;
+	_readyFrame = 1;
+	_frontFrame = 2;
 
 	g_system->getTimerManager()->installTimerProc(&timerCallback, 10000, NULL, "movieLoop");
 }
@@ -59,7 +62,9 @@ MoviePlayer::~MoviePlayer() {
 
 	deinit();
 	delete _videoDecoder;
-	delete _externalSurface;
+
+	for (int i = 0; i < 3; i++)
+		_frameBuffers[i].free();
 }
 
 void MoviePlayer::pause(bool p) {
@@ -101,8 +106,9 @@ bool MoviePlayer::prepareFrame() {
 
 	handleFrame();
 
-	_internalSurface = _videoDecoder->decodeNextFrame();
-	_updateNeeded = true;
+	const Graphics::Surface *frame = _videoDecoder->decodeNextFrame();
+	if (frame)
+		deliverFrame(frame);
 
 	_movieTime = _videoDecoder->getElapsedTime();
 	_frame = _videoDecoder->getCurFrame();
@@ -110,13 +116,37 @@ bool MoviePlayer::prepareFrame() {
 	return true;
 }
 
+void MoviePlayer::deliverFrame(const Graphics::Surface *frame) {
+	Graphics::Surface &back = _frameBuffers[_backFrame];
+	const Graphics::PixelFormat &format = _frameFormat;
+
+	if (back.w != frame->w || back.h != frame->h || back.format != format) {
+		back.free();
+		back.create(frame->w, frame->h, format);
+	}
+
+	if (frame->format == format) {
+		for (int y = 0; y < frame->h; y++)
+			memcpy(back.getBasePtr(0, y), frame->getBasePtr(0, y), frame->w * format.bytesPerPixel);
+	} else {
+		Graphics::PixelBuffer src(frame->format, (byte *)frame->pixels);
+		Graphics::PixelBuffer dst(format, (byte *)back.pixels);
+		dst.copyBuffer(0, frame->w * frame->h, src);
+	}
+
+	Common::StackLock lock(_exchangeMutex);
+	SWAP(_backFrame, _readyFrame);
+	_updateNeeded = true;
+}
+
 Graphics::Surface *MoviePlayer::getDstSurface() {
-	Common::StackLock lock(_frameMutex);
-	if (_updateNeeded && _internalSurface) {
-		_externalSurface->copyFrom(*_internalSurface);
+	Common::StackLock lock(_exchangeMutex);
+	if (_updateNeeded) {
+		SWAP(_frontFrame, _readyFrame);
+		_updateNeeded = false;
 	}
 
-	return _externalSurface;
+	return &_frameBuffers[_frontFrame];
 }
 
 void MoviePlayer::init() {
@@ -124,6 +154,7 @@ void MoviePlayer::init() {
 	_movieTime = 0;
 	_updateNeeded = false;
 	_videoFinished = false;
+	_frameFormat = g_driver->getMovieFramePixelFormat();
 }
 
 void MoviePlayer::deinit() {
@@ -132,10 +163,13 @@ void MoviePlayer::deinit() {
 	if (_videoDecoder)
 		_videoDecoder->close();
 
-	_internalSurface = NULL;
-
-	if (_externalSurface)
-		_externalSurface->free();
+	// The front frame may still be drawn
+	{
+		Common::StackLock lock(_exchangeMutex);
+		_frameBuffers[_backFrame].free();
+		_frameBuffers[_readyFrame].free();
+		_updateNeeded = false;
+	}
 
 	_videoPause = false;
 	_videoFinished = true;
@@ -155,7 +189,6 @@ bool MoviePlayer::play(Common::String filename, bool looping, int x, int y) {
 	Debug::debug(Debug::Movie, "Playing video '%s'.\n", filename.c_str());
 
 	init();
-	_internalSurface = NULL;
 
 	// Get the first frame immediately
 	timerCallback(0);
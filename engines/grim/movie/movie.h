@@ -26,6 +26,8 @@
 #include "common/mutex.h"
 #include "common/system.h"
 
+#include "graphics/surface.h"
+
 #include "video/video_decoder.h"
 
 namespace Grim {
@@ -37,8 +39,17 @@ protected:
 	Common::String _fname;
 	Common::Mutex _frameMutex;
 	Video::VideoDecoder *_videoDecoder;		//< Initialize this to your needed subclass of VideoDecoder in the constructor
-	const Graphics::Surface *_internalSurface;
-	Graphics::Surface *_externalSurface;
+	/**
+	 * The frames handed to the renderer, in its pixel format. The timer writes
+	 * the back frame and the renderer owns the front one. The ready frame is
+	 * the last complete one when _updateNeeded is set. Only swapping them
+	 * needs _exchangeMutex, so that the renderer never waits for a decode.
+	 */
+	Graphics::Surface _frameBuffers[3];
+	int _backFrame, _readyFrame, _frontFrame;
+	Common::Mutex _exchangeMutex;
+	/** The renderer's movie frame format, read on the main thread in init() */
+	Graphics::PixelFormat _frameFormat;
 	int32 _frame;
 	bool _updateNeeded;
 	float _movieTime;
@@ -70,11 +81,14 @@ public:
 	virtual void pause(bool p);
 	virtual bool isPlaying() { return !_videoFinished; }
 	virtual bool isUpdateNeeded() { return _updateNeeded; }
+	/**
+	 * Take the last complete frame, if there is a new one, and return the
+	 * frame to draw. It belongs to the renderer until the next call.
+	 */
 	virtual Graphics::Surface *getDstSurface();
 	virtual int getX() { return _x; }
 	virtual int getY() { return _y; }
 	virtual int getFrame() { return _frame; }
-	virtual void clearUpdateNeeded() { _updateNeeded = false; }
 	virtual int32 getMovieTime() { return (int32)_movieTime; }
 
 	/**
@@ -91,14 +105,23 @@ public:
 protected:
 	static void timerCallback(void *ptr);
 	/**
-	 * Handles basic stuff per frame, like copying the latest frame to
-	 * _externalBuffer, and updating the frame-counters.
+	 * Handles basic stuff per frame, like decoding the next frame and
+	 * delivering it, and updating the frame-counters.
 	 *
-	 * @return false if a frame wasnt drawn to _externalBuffer, true otherwise.
+	 * @return false if no frame was decoded, true otherwise.
 	 * @see handleFrame
 	 */
 	virtual bool prepareFrame();
 
+	/**
+	 * Copy a decoded frame into the back frame, in the pixel format of the
+	 * renderer, and make it the ready frame.
+	 *
+	 * @param frame			the decoded frame
+	 * @see getDstSurface
+	 */
+	void deliverFrame(const Graphics::Surface *frame);
+
 	/**
 	 * Frame-handling function.
 	 *
@@ -106,7 +129,7 @@ protected:
 	 * decodes the next frame.
 	 *
 	 * @see prepareFrame
-	 * @see clearUpdateNeeded
+	 * @see getDstSurface
 	 * @see isUpdateNeeded
 	 */
 	virtual void handleFrame() {};
@@ -118,7 +141,7 @@ protected:
 	 * run, this function is called whenever prepareFrame returns true.
 	 *
 	 * @see prepareFrame
-	 * @see clearUpdateNeeded
+	 * @see getDstSurface
 	 * @see isUpdateNeeded
 	 */
 	virtual void postHandleFrame() {};
@@ -78,10 +78,6 @@ MpegPlayer::MpegPlayer() : MoviePlayer() {
 void MpegPlayer::init() {
 	MoviePlayer::init();
 
-	// FIXME, deal with pixelformat differently when we get this properly tested.
-	Graphics::PixelFormat format = Graphics::PixelFormat(16, 5, 6, 5, 0, 11, 5, 0, 0);
-	_externalSurface->create(MWIDTH, MHEIGHT, format);
-
 	g_system->getTimerManager()->installTimerProc(&timerCallback, _speed, NULL, "mpeg loop");
 }
 
@@ -111,9 +107,16 @@ void MpegPlayer::handleFrame() {
 }
 
 void MpegPlayer::deliverFrameFromDecode(int width, int height, uint16 *dat) {
-	memcpy(_externalSurface->pixels, dat, _externalSurface->w * _externalSurface->h * 2);
+	// FIXME, deal with pixelformat differently when we get this properly tested.
+	Graphics::Surface frame;
+	frame.w = MWIDTH;
+	frame.h = MHEIGHT;
+	frame.pitch = MWIDTH * 2;
+	frame.pixels = dat;
+	frame.format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+	deliverFrame(&frame);
 	_frame++;
-	_updateNeeded = true;
 }
 
 bool MpegPlayer::loadFile(Common::String filename) {
@@ -42,17 +42,22 @@ SaveGame *SaveGame::openForLoading(const Common::String &filename) {
 		return NULL;
 	}
 
+	return openForLoading(inSaveFile, DisposeAfterUse::YES);
+}
+
+SaveGame *SaveGame::openForLoading(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeStream) {
 	SaveGame *save = new SaveGame();
 
 	save->_saving = false;
-	save->_inSaveFile = inSaveFile;
+	save->_inSaveFile = stream;
+	save->_disposeStream = disposeStream;
 
-	uint32 tag = inSaveFile->readUint32BE();
+	uint32 tag = stream->readUint32BE();
 	if (tag != SAVEGAME_HEADERTAG) {
 		delete save;
 		return NULL;
 	}
-	save->_version = inSaveFile->readUint32BE();
+	save->_version = stream->readUint32BE();
 
 	return save;
 }
@@ -64,13 +69,18 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 		return NULL;
 	}
 
+	return openForSaving(outSaveFile, DisposeAfterUse::YES);
+}
+
+SaveGame *SaveGame::openForSaving(Common::WriteStream *stream, DisposeAfterUse::Flag disposeStream) {
 	SaveGame *save = new SaveGame();
 
 	save->_saving = true;
-	save->_outSaveFile = outSaveFile;
+	save->_outSaveFile = stream;
+	save->_disposeStream = disposeStream;
 
-	outSaveFile->writeUint32BE(SAVEGAME_HEADERTAG);
-	outSaveFile->writeUint32BE(SAVEGAME_VERSION);
+	stream->writeUint32BE(SAVEGAME_HEADERTAG);
+	stream->writeUint32BE(SAVEGAME_VERSION);
 
 	save->_version = SAVEGAME_VERSION;
 
@@ -78,7 +88,7 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 }
 
 SaveGame::SaveGame() :
-	_currentSection(0), _sectionBuffer(0) {
+	_currentSection(0), _sectionBuffer(0), _disposeStream(DisposeAfterUse::YES) {
 
 }
 
@@ -88,8 +98,9 @@ SaveGame::~SaveGame() {
 		_outSaveFile->finalize();
 		if (_outSaveFile->err())
 			warning("SaveGame::~SaveGame() Can't write file. (Disk full?)");
-		delete _outSaveFile;
-	} else {
+		if (_disposeStream == DisposeAfterUse::YES)
+			delete _outSaveFile;
+	} else if (_disposeStream == DisposeAfterUse::YES) {
 		delete _inSaveFile;
 	}
 	free(_sectionBuffer);
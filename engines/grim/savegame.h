@@ -24,6 +24,7 @@
 #define GRIM_SAVEGAME_H
 
 #include "common/savefile.h"
+#include "common/types.h"
 
 #include "math/mathfwd.h"
 
@@ -35,6 +36,12 @@ class SaveGame {
 public:
 	static SaveGame *openForLoading(const Common::String &filename);
 	static SaveGame *openForSaving(const Common::String &filename);
+	/**
+	 * Use the given stream instead of a savefile, e.g. a
+	 * Common::MemoryWriteStreamDynamic to keep the state in memory.
+	 */
+	static SaveGame *openForLoading(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeStream);
+	static SaveGame *openForSaving(Common::WriteStream *stream, DisposeAfterUse::Flag disposeStream);
 	~SaveGame();
 
 	static int SAVEGAME_VERSION;
@@ -79,6 +86,7 @@ protected:
 	uint32 _sectionAlloc;
 	uint32 _sectionPtr;
 	byte *_sectionBuffer;
+	DisposeAfterUse::Flag _disposeStream;
 
 	static const int _allocAmmount = 1048576;
 };
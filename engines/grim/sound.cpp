@@ -100,5 +100,25 @@ uint32 SoundPlayer::getMsPos(int stateId) {
 	assert(_emiSound); // This shouldn't ever be called from Grim.
 	return _emiSound->getMsPos(stateId);
 }
+
+bool SoundPlayer::preloadVoice(const char *soundName) {
+	assert(_emiSound);
+	return _emiSound->preloadVoice(soundName);
+}
+
+bool SoundPlayer::preloadMusicState(int stateId) {
+	assert(_emiSound);
+	return _emiSound->preloadMusicState(stateId);
+}
+
+void SoundPlayer::flushPreloaded() {
+	assert(_emiSound);
+	_emiSound->flushPreloaded();
+}
+
+void SoundPlayer::preloadQueued() {
+	if (_emiSound)
+		_emiSound->preloadQueued();
+}
 	
 } // end of namespace Grim
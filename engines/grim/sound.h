@@ -42,6 +42,11 @@ public:
 	
 	void setMusicState(int stateId);
 	uint32 getMsPos(int stateId);
+
+	bool preloadVoice(const char *soundName);
+	bool preloadMusicState(int stateId);
+	void flushPreloaded();
+	void preloadQueued();
 };
 
 extern SoundPlayer *g_sound;
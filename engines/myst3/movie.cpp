@@ -36,6 +36,7 @@ Movie::Movie(Myst3Engine *vm, uint16 id) :
 	_id(id),
 	_posU(0),
 	_posV(0),
+	_bink(new Video::SeekableBinkDecoder()),
 	_startFrame(0),
 	_endFrame(0),
 	_texture(0),
@@ -137,6 +138,8 @@ void Movie::drawOverlay() {
 
 void Movie::drawNextFrameToTexture() {
 	const Graphics::Surface *frame = _bink.decodeNextFrame();
+	if (!frame)
+		return;
 
 	if (_texture)
 		_texture->update(frame);
@@ -164,6 +167,7 @@ ScriptedMovie::ScriptedMovie(Myst3Engine *vm, uint16 id) :
 	_playingVar(0),
 	_enabled(false),
 	_disableWhenComplete(false),
+	_loop(false),
 	_scriptDriven(false),
 	_isLastFrame(false) {
 
@@ -196,6 +200,11 @@ void ScriptedMovie::update() {
 		_endFrame = _bink.getFrameCount();
 	}
 
+	// Looping and scrubbing go back over the same frames again and again
+	if (_loop || _nextFrameReadVar) {
+		_bink.setFrameCache(_startFrame, _endFrame - 1, kFrameCacheFrames * _bink.getCachedFrameSize());
+	}
+
 	if (_posUVar) {
 		_posU = _vm->_state->getVar(_posUVar);
 	}
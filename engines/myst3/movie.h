@@ -27,7 +27,7 @@
 #include "engines/myst3/node.h"
 
 #include "math/vector3d.h"
-#include "video/bink_decoder_seek.h"
+#include "video/threaded_video_decoder.h"
 
 namespace Myst3 {
 
@@ -66,7 +66,7 @@ protected:
 	int32 _posU;
 	int32 _posV;
 
-	Video::SeekableBinkDecoder _bink;
+	Video::ThreadedVideoDecoder _bink;
 	Texture *_texture;
 
 	int32 _startFrame;
@@ -102,6 +102,9 @@ public:
 	void setScriptDriven(bool b) { _scriptDriven = b; }
 
 protected:
+	// Frames kept for looping and scrubbing, whatever the size of the movie
+	static const uint32 kFrameCacheFrames = 30;
+
 	bool _enabled;
 	bool _loop;
 	bool _disableWhenComplete;
@@ -29,26 +29,24 @@
 #include "common/debug.h"
 #include "common/rect.h"
 
-#include "graphics/conversion.h"
+#include "graphics/yuv_to_rgb.h"
 
 namespace Myst3 {
 
+void Face::convertJPEG(Graphics::JPEG *jpeg, Graphics::Surface *bitmap) {
+	Graphics::Surface *y = jpeg->getComponent(1);
+	Graphics::Surface *u = jpeg->getComponent(2);
+	Graphics::Surface *v = jpeg->getComponent(3);
+
+	Graphics::convertYUV444ToRGB(bitmap, (const byte *)y->pixels, (const byte *)u->pixels, (const byte *)v->pixels,
+			bitmap->w, bitmap->h, y->pitch, u->pitch, Graphics::kYUVCoefficientsJPEG);
+}
+
 void Face::setTextureFromJPEG(Graphics::JPEG *jpeg) {
 	_bitmap = new Graphics::Surface();
 	_bitmap->create(jpeg->getComponent(1)->w, jpeg->getComponent(1)->h, Graphics::PixelFormat(3, 8, 8, 8, 0, 16, 8, 0, 0));
 
-	byte *y = (byte *)jpeg->getComponent(1)->getBasePtr(0, 0);
-	byte *u = (byte *)jpeg->getComponent(2)->getBasePtr(0, 0);
-	byte *v = (byte *)jpeg->getComponent(3)->getBasePtr(0, 0);
-	
-	byte *ptr = (byte *)_bitmap->getBasePtr(0, 0);
-	for (int i = 0; i < _bitmap->w * _bitmap->h; i++) {
-		byte r, g, b;
-		Graphics::YUV2RGB(*y++, *u++, *v++, r, g, b);
-		*ptr++ = r;
-		*ptr++ = g;
-		*ptr++ = b;
-	}
+	convertJPEG(jpeg, _bitmap);
 
 	_texture = _vm->_gfx->createTexture(_bitmap);
 }
@@ -298,22 +296,7 @@ void SpotItemFace::loadData(Graphics::JPEG *jpeg) {
 	// Convert active SpotItem image to raw data
 	_bitmap = new Graphics::Surface();
 	_bitmap->create(jpeg->getComponent(1)->w, jpeg->getComponent(1)->h, Graphics::PixelFormat(3, 8, 8, 8, 0, 16, 8, 0, 0));
-
-	for (int i = 0; i < _bitmap->h; i++) {
-		byte *y = (byte *)jpeg->getComponent(1)->getBasePtr(0, i);
-		byte *u = (byte *)jpeg->getComponent(2)->getBasePtr(0, i);
-		byte *v = (byte *)jpeg->getComponent(3)->getBasePtr(0, i);
-
-		byte *ptr = (byte *)_bitmap->getBasePtr(0, i);
-
-		for (int j = 0; j < _bitmap->w; j++) {
-			byte r, g, b;
-			Graphics::YUV2RGB(*y++, *u++, *v++, r, g, b);
-			*ptr++ = r;
-			*ptr++ = g;
-			*ptr++ = b;
-		}
-	}
+	Face::convertJPEG(jpeg, _bitmap);
 
 	initNotDrawn(_bitmap->w, _bitmap->h);
 }
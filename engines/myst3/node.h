@@ -47,6 +47,9 @@ class Face {
 
 		void setTextureFromJPEG(Graphics::JPEG *jpeg);
 
+		/** Convert the YUV components of a JPEG into an RGB bitmap of the same size */
+		static void convertJPEG(Graphics::JPEG *jpeg, Graphics::Surface *bitmap);
+
 		void markTextureDirty() { _textureDirty = true; }
 		void uploadTexture();
 
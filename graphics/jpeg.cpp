@@ -20,12 +20,13 @@
  *
  */
 
-#include "graphics/conversion.h"
 #include "graphics/jpeg.h"
 #include "graphics/pixelformat.h"
+#include "graphics/yuv_to_rgb.h"
 
 #include "common/debug.h"
 #include "common/endian.h"
+#include "common/huffman.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 
@@ -52,12 +53,8 @@ JPEG::JPEG() :
 		_quant[i] = NULL;
 
 	// Initialize the Huffman tables
-	for (int i = 0; i < 2 * JPEG_MAX_HUFF_TABLES; i++) {
-		_huff[i].count = 0;
-		_huff[i].values = NULL;
-		_huff[i].sizes = NULL;
-		_huff[i].codes = NULL;
-	}
+	for (int i = 0; i < 2 * JPEG_MAX_HUFF_TABLES; i++)
+		_huff[i] = NULL;
 }
 
 JPEG::~JPEG() {
@@ -81,16 +78,8 @@ Surface *JPEG::getSurface(const PixelFormat &format) {
 	Graphics::Surface *output = new Graphics::Surface();
 	output->create(yComponent->w, yComponent->h, format);
 
-	for (uint16 i = 0; i < output->h; i++) {
-		for (uint16 j = 0; j < output->w; j++) {
-			byte r = 0, g = 0, b = 0;
-			YUV2RGB(*((byte *)yComponent->getBasePtr(j, i)), *((byte *)uComponent->getBasePtr(j, i)), *((byte *)vComponent->getBasePtr(j, i)), r, g, b);
-			if (format.bytesPerPixel == 2)
-				*((uint16 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
-			else
-				*((uint32 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
-		}
-	}
+	convertYUV444ToRGB(output, (const byte *)yComponent->pixels, (const byte *)uComponent->pixels, (const byte *)vComponent->pixels,
+			output->w, output->h, yComponent->pitch, uComponent->pitch, kYUVCoefficientsJPEG);
 
 	return output;
 }
@@ -120,10 +109,8 @@ void JPEG::reset() {
 
 	// Free the Huffman tables
 	for (int i = 0; i < 2 * JPEG_MAX_HUFF_TABLES; i++) {
-		_huff[i].count = 0;
-		delete[] _huff[i].values; _huff[i].values = NULL;
-		delete[] _huff[i].sizes; _huff[i].sizes = NULL;
-		delete[] _huff[i].codes; _huff[i].codes = NULL;
+		delete _huff[i];
+		_huff[i] = NULL;
 	}
 }
 
@@ -297,29 +284,31 @@ bool JPEG::readDHT() {
 		uint8 tableNum = (tableId << 1) + tableType;
 
 		// Free the Huffman table
-		delete[] _huff[tableNum].values; _huff[tableNum].values = NULL;
-		delete[] _huff[tableNum].sizes; _huff[tableNum].sizes = NULL;
-		delete[] _huff[tableNum].codes; _huff[tableNum].codes = NULL;
+		delete _huff[tableNum];
+		_huff[tableNum] = NULL;
 
 		// Read the number of values for each length
 		uint8 numValues[16];
-		_huff[tableNum].count = 0;
+		uint count = 0;
 		for (int len = 0; len < 16; len++) {
 			numValues[len] = _stream->readByte();
-			_huff[tableNum].count += numValues[len];
+			count += numValues[len];
 		}
 
+		if (count == 0)
+			continue;
+
 		// Allocate memory for the current table
-		_huff[tableNum].values = new uint8[_huff[tableNum].count];
-		_huff[tableNum].sizes = new uint8[_huff[tableNum].count];
-		_huff[tableNum].codes = new uint16[_huff[tableNum].count];
+		uint32 *values = new uint32[count];
+		uint8 *sizes = new uint8[count];
+		uint32 *codes = new uint32[count];
 
 		// Read the table contents
-		int cur = 0;
+		uint cur = 0;
 		for (int len = 0; len < 16; len++) {
 			for (int i = 0; i < numValues[len]; i++) {
-				_huff[tableNum].values[cur] = _stream->readByte();
-				_huff[tableNum].sizes[cur] = len + 1;
+				values[cur] = _stream->readByte();
+				sizes[cur] = len + 1;
 				cur++;
 			}
 		}
@@ -327,19 +316,25 @@ bool JPEG::readDHT() {
 		// Fill the table of Huffman codes
 		cur = 0;
 		uint16 curCode = 0;
-		uint8 curCodeSize = _huff[tableNum].sizes[0];
-		while (cur < _huff[tableNum].count) {
+		uint8 curCodeSize = sizes[0];
+		while (cur < count) {
 			// Increase the code size to fit the request
-			while (_huff[tableNum].sizes[cur] != curCodeSize) {
+			while (sizes[cur] != curCodeSize) {
 				curCode <<= 1;
 				curCodeSize++;
 			}
 
 			// Assign the current code
-			_huff[tableNum].codes[cur] = curCode;
+			codes[cur] = curCode;
 			curCode++;
 			cur++;
 		}
+
+		_huff[tableNum] = new Common::Huffman(0, count, codes, sizes, values);
+
+		delete[] values;
+		delete[] sizes;
+		delete[] codes;
 	}
 
 	return true;
@@ -454,6 +449,7 @@ bool JPEG::readSOS() {
 				if (interval == 0) {
 					interval = _restartInterval;
 					_bitsNumber = 0;
+					skipRestartMarker();
 
 					for (byte i = 0; i < _numScanComp; i++)
 						_scanComp[i]->DCpredictor = 0;					
@@ -701,8 +697,8 @@ int16 JPEG::readSignedBits(uint8 numBits) {
 		error("requested %d bits", numBits); //XXX
 
 	// MSB=0 for negatives, 1 for positives
-	for (int i = 0; i < numBits; i++)
-		ret = (ret << 1) + readBit();
+	ret = peekBits(numBits);
+	skipBits(numBits);
 
 	// Extend sign bits (PAG109)
 	if (!(ret >> (numBits - 1))) {
@@ -712,65 +708,65 @@ int16 JPEG::readSignedBits(uint8 numBits) {
 	return ret;
 }
 
-// TODO: optimize?
 uint8 JPEG::readHuff(uint8 table) {
-	bool foundCode = false;
-	uint8 val = 0;
-
-	uint8 cur = 0;
-	uint8 codeSize = 1;
-	uint16 code = readBit();
-	while (!foundCode) {
-		// Prepare a code of the current size
-		while (codeSize < _huff[table].sizes[cur]) {
-			code = (code << 1) + readBit();
-			codeSize++;
-		}
+	if (!_huff[table])
+		error("JPEG: Undefined Huffman table %d", table);
 
-		// Compare the codes of the current size
-		while (!foundCode && (codeSize == _huff[table].sizes[cur])) {
-			if (code == _huff[table].codes[cur]) {
-				// Found the code
-				val = _huff[table].values[cur];
-				foundCode = true;
-			} else {
-				// Continue reading
-				cur++;
-			}
-		}
-	}
+	// One lookup with as many bits as the longest code
+	uint8 length;
+	uint8 val = _huff[table]->getSymbol(peekBits(_huff[table]->getMaxLength()), true, length);
+	skipBits(length);
 
 	return val;
 }
 
-uint8 JPEG::readBit() {
-	// Read a whole byte if necessary
-	if (_bitsNumber == 0) {
-		_bitsData = _stream->readByte();
-		_bitsNumber = 8;
-
-		// Detect markers
-		if (_bitsData == 0xFF) {
-			uint8 byte2 = _stream->readByte();
-
-			// A stuffed 0 validates the previous byte
-			if (byte2 != 0) {
-				if (byte2 == 0xDC) {
-					// DNL marker: Define Number of Lines
-					// TODO: terminate scan
-					warning("DNL marker detected: terminate scan");
-				} else if (byte2 >= 0xD0 && byte2 <= 0xD7) {
-					debug(7, "RST%d marker detected", byte2 & 7);
-					_bitsData = _stream->readByte();
-				} else {
-					warning("Error: marker 0x%02X read in entropy data", byte2);
-				}
-			}
+uint32 JPEG::peekBits(uint8 n) {
+	// Read whole bytes as necessary
+	while (_bitsNumber < n) {
+		_bitsData = (_bitsData << 8) | readEntropyByte();
+		_bitsNumber += 8;
+	}
+
+	return (_bitsData >> (_bitsNumber - n)) & ((1 << n) - 1);
+}
+
+void JPEG::skipBits(uint8 n) {
+	peekBits(n);
+	_bitsNumber -= n;
+}
+
+uint8 JPEG::readEntropyByte() {
+	uint8 data = _stream->readByte();
+
+	// Detect markers
+	if (data == 0xFF) {
+		uint8 byte2 = _stream->readByte();
+
+		// A stuffed 0 validates the previous byte
+		if (byte2 != 0) {
+			// The entropy coded data stops at a marker, but the bits after
+			// the last code may still be peeked at. Leave the marker to
+			// whoever reads it, and pad the data with 0s.
+			debug(7, "JPEG: Marker 0x%02X at the end of the entropy coded data", byte2);
+			_stream->seek(-2, SEEK_CUR);
+			data = 0;
 		}
 	}
-	_bitsNumber--;
 
-	return (_bitsData & (1 << _bitsNumber)) ? 1 : 0;
+	return data;
+}
+
+void JPEG::skipRestartMarker() {
+	uint32 pos = _stream->pos();
+
+	uint8 marker = 0;
+	if (_stream->readByte() == 0xFF)
+		marker = _stream->readByte();
+
+	if (marker >= 0xD0 && marker <= 0xD7)
+		debug(7, "RST%d marker detected", marker & 7);
+	else
+		_stream->seek(pos);
 }
 
 Surface *JPEG::getComponent(uint c) {
@@ -26,6 +26,7 @@
 #include "graphics/surface.h"
 
 namespace Common {
+class Huffman;
 class SeekableReadStream;
 }
 
@@ -89,12 +90,7 @@ private:
 	uint16 *_quant[JPEG_MAX_QUANT_TABLES];
 
 	// Huffman tables
-	struct HuffmanTable {
-		uint8 count;
-		uint8 *values;
-		uint8 *sizes;
-		uint16 *codes;
-	} _huff[2 * JPEG_MAX_HUFF_TABLES];
+	Common::Huffman *_huff[2 * JPEG_MAX_HUFF_TABLES];
 
 	// Marker read functions
 	bool readJFIF();
@@ -113,8 +109,11 @@ private:
 
 	// Huffman decoding
 	uint8 readHuff(uint8 table);
-	uint8 readBit();
-	uint8 _bitsData;
+	uint32 peekBits(uint8 n);
+	void skipBits(uint8 n);
+	uint8 readEntropyByte();
+	void skipRestartMarker();
+	uint32 _bitsData;
 	uint8 _bitsNumber;
 
 	// Inverse Discrete Cosine Transformation
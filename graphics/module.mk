@@ -17,7 +17,6 @@ MODULE_OBJS := \
 	VectorRenderer.o \
 	VectorRendererSpec.o \
 	yuv_to_rgb.o \
-	yuva_to_rgba.o \
 	pixelbuffer.o \
 	tinygl/api.o \
 	tinygl/arrays.o \
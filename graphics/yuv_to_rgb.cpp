@@ -24,7 +24,7 @@
 // in turn appears to be derived from mpeg_play. The following copyright
 // notices have been included in accordance with the original license. Please
 // note that the term "software" in this context only applies to the
-// buildLookup() and plotYUV*() functions below.
+// YUVToRGBLookup constructor below.
 
 // Copyright (c) 1995 The Regents of the University of California.
 // All rights reserved.
@@ -85,103 +85,85 @@
 
 #include "common/scummsys.h"
 #include "common/singleton.h"
+#include "common/util.h"
 
 #include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuva_to_rgba.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define USE_SSE2_YUV
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON_YUV
+#endif
 
 namespace Graphics {
 
+/**
+ * The color differences brought by each U and V value. A pixel is
+ * (y + crR[v], y + crG[v] + cbG[u], y + cbB[u]), with each component
+ * clipped to 0-255, whatever the pixel format.
+ */
 class YUVToRGBLookup {
 public:
-	YUVToRGBLookup(Graphics::PixelFormat format);
-	~YUVToRGBLookup();
+	YUVToRGBLookup(YUVToRGBCoefficients coefficients);
 
-	int16 *_colorTab;
-	uint32 *_rgbToPix;
+	int16 _crR[256];
+	int16 _crG[256];
+	int16 _cbG[256];
+	int16 _cbB[256];
 };
 
-YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format) {
-	_colorTab = new int16[4 * 256]; // 2048 bytes
-
-	int16 *Cr_r_tab = &_colorTab[0 * 256];
-	int16 *Cr_g_tab = &_colorTab[1 * 256];
-	int16 *Cb_g_tab = &_colorTab[2 * 256];
-	int16 *Cb_b_tab = &_colorTab[3 * 256];
-
-	_rgbToPix = new uint32[3 * 768]; // 9216 bytes
-
-	uint32 *r_2_pix_alloc = &_rgbToPix[0 * 768];
-	uint32 *g_2_pix_alloc = &_rgbToPix[1 * 768];
-	uint32 *b_2_pix_alloc = &_rgbToPix[2 * 768];
-
-	int16 CR, CB;
-	int i;
-
-	// Generate the tables for the display surface
-
-	for (i = 0; i < 256; i++) {
-		// Gamma correction (luminescence table) and chroma correction
-		// would be done here. See the Berkeley mpeg_play sources.
-
+YUVToRGBLookup::YUVToRGBLookup(YUVToRGBCoefficients coefficients) {
+	for (int i = 0; i < 256; i++) {
+		int16 CR, CB;
 		CR = CB = (i - 128);
-		Cr_r_tab[i] = (int16) ( (0.419 / 0.299) * CR) + 0 * 768 + 256;
-		Cr_g_tab[i] = (int16) (-(0.299 / 0.419) * CR) + 1 * 768 + 256;
-		Cb_g_tab[i] = (int16) (-(0.114 / 0.331) * CB);
-		Cb_b_tab[i] = (int16) ( (0.587 / 0.331) * CB) + 2 * 768 + 256;
-	}
-
-	// Set up entries 0-255 in rgb-to-pixel value tables.
-	for (i = 0; i < 256; i++) {
-		r_2_pix_alloc[i + 256] = format.RGBToColor(i, 0, 0);
-		g_2_pix_alloc[i + 256] = format.RGBToColor(0, i, 0);
-		b_2_pix_alloc[i + 256] = format.RGBToColor(0, 0, i);
-	}
 
-	// Spread out the values we have to the rest of the array so that we do
-	// not need to check for overflow.
-	for (i = 0; i < 256; i++) {
-		r_2_pix_alloc[i] = r_2_pix_alloc[256];
-		r_2_pix_alloc[i + 512] = r_2_pix_alloc[511];
-		g_2_pix_alloc[i] = g_2_pix_alloc[256];
-		g_2_pix_alloc[i + 512] = g_2_pix_alloc[511];
-		b_2_pix_alloc[i] = b_2_pix_alloc[256];
-		b_2_pix_alloc[i + 512] = b_2_pix_alloc[511];
+		if (coefficients == kYUVCoefficientsJPEG) {
+			// Same as YUV2RGB()
+			_crR[i] =  ((1357 * CR) >> 10);
+			_crG[i] = -(( 691 * CR) >> 10);
+			_cbG[i] = -(( 333 * CB) >> 10);
+			_cbB[i] =  ((1715 * CB) >> 10);
+		} else {
+			// Gamma correction (luminescence table) and chroma correction
+			// would be done here. See the Berkeley mpeg_play sources.
+			_crR[i] = (int16) ( (0.419 / 0.299) * CR);
+			_crG[i] = (int16) (-(0.299 / 0.419) * CR);
+			_cbG[i] = (int16) (-(0.114 / 0.331) * CB);
+			_cbB[i] = (int16) ( (0.587 / 0.331) * CB);
+		}
 	}
 }
 
-YUVToRGBLookup::~YUVToRGBLookup() {
-	delete[] _rgbToPix;
-	delete[] _colorTab;
-}
-
 class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
 public:
-	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format);
+	const YUVToRGBLookup *getLookup(YUVToRGBCoefficients coefficients);
 
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
-	Graphics::PixelFormat _lastFormat;
-	YUVToRGBLookup *_lookup;
+	YUVToRGBLookup *_lookup[2];
 };
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
+	_lookup[0] = _lookup[1] = 0;
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	delete _lookup[0];
+	delete _lookup[1];
 }
 
-const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format) {
-	if (_lastFormat == format)
-		return _lookup;
+const YUVToRGBLookup *YUVToRGBManager::getLookup(YUVToRGBCoefficients coefficients) {
+	if (!_lookup[coefficients])
+		_lookup[coefficients] = new YUVToRGBLookup(coefficients);
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format);
-	_lastFormat = format;
-	return _lookup;
+	return _lookup[coefficients];
 }
 
 } // End of namespace Graphics
@@ -194,64 +176,261 @@ DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 
 namespace Graphics {
 
-#define PUT_PIXEL(s, d) \
-	L = &rgbToPix[(s)]; \
-	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
-
-template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
-
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = lookup->_colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->_rgbToPix;
-
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			register const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
+// 24 bits pixels are written most significant byte first, the way the
+// OpenGL renderers upload them
+static inline void writePixel(byte *dst, int bytesPerPixel, uint32 color) {
+	if (bytesPerPixel == 2) {
+		*((uint16 *)dst) = color;
+	} else if (bytesPerPixel == 4) {
+		*((uint32 *)dst) = color;
+	} else {
+		dst[0] = (color >> 16) & 0xFF;
+		dst[1] = (color >>  8) & 0xFF;
+		dst[2] =  color        & 0xFF;
+	}
+}
+
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+
+/** Pixels converted at once */
+static const int kBlockSize = 16;
+
+/** The color differences of the pixels of a block */
+struct ChromaBlock {
+	int16 r[kBlockSize];
+	int16 g[kBlockSize];
+	int16 b[kBlockSize];
+};
+
+/** Is the format 24 bits RGB, in any order? */
+static bool isPackedRGB24(const PixelFormat &format) {
+	return format.bytesPerPixel == 3
+			&& format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0
+			&& format.rShift % 8 == 0 && format.gShift % 8 == 0 && format.bShift % 8 == 0
+			&& format.rShift <= 16 && format.gShift <= 16 && format.bShift <= 16
+			&& format.rShift != format.gShift && format.gShift != format.bShift && format.rShift != format.bShift;
+}
+
+#endif
+
+#if defined(USE_SSE2_YUV)
+
+/**
+ * Convert one block of pixels. Alpha is taken from aSrc when there is one,
+ * the pixels are opaque otherwise.
+ */
+static void convertBlock(byte *dst, const PixelFormat &format, const byte *ySrc, const byte *aSrc, const ChromaBlock &chroma) {
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i y = _mm_loadu_si128((const __m128i *)ySrc);
+	__m128i yLo = _mm_unpacklo_epi8(y, zero);
+	__m128i yHi = _mm_unpackhi_epi8(y, zero);
+
+	// The saturating pack does the clipping
+	__m128i c[4];
+	c[0] = _mm_packus_epi16(_mm_add_epi16(yLo, _mm_loadu_si128((const __m128i *)chroma.r)),
+	                        _mm_add_epi16(yHi, _mm_loadu_si128((const __m128i *)(chroma.r + 8))));
+	c[1] = _mm_packus_epi16(_mm_add_epi16(yLo, _mm_loadu_si128((const __m128i *)chroma.g)),
+	                        _mm_add_epi16(yHi, _mm_loadu_si128((const __m128i *)(chroma.g + 8))));
+	c[2] = _mm_packus_epi16(_mm_add_epi16(yLo, _mm_loadu_si128((const __m128i *)chroma.b)),
+	                        _mm_add_epi16(yHi, _mm_loadu_si128((const __m128i *)(chroma.b + 8))));
+	c[3] = aSrc ? _mm_loadu_si128((const __m128i *)aSrc) : _mm_set1_epi8((char)0xFF);
+
+	const byte loss[4]  = { format.rLoss,  format.gLoss,  format.bLoss,  format.aLoss  };
+	const byte shift[4] = { format.rShift, format.gShift, format.bShift, format.aShift };
+
+	if (format.bytesPerPixel == 2) {
+		__m128i lo = zero, hi = zero;
+		for (int i = 0; i < 4; i++) {
+			__m128i l = _mm_cvtsi32_si128(loss[i]);
+			__m128i s = _mm_cvtsi32_si128(shift[i]);
+			lo = _mm_or_si128(lo, _mm_sll_epi16(_mm_srl_epi16(_mm_unpacklo_epi8(c[i], zero), l), s));
+			hi = _mm_or_si128(hi, _mm_sll_epi16(_mm_srl_epi16(_mm_unpackhi_epi8(c[i], zero), l), s));
 		}
+		_mm_storeu_si128((__m128i *)dst, lo);
+		_mm_storeu_si128((__m128i *)(dst + 16), hi);
+	} else if (format.bytesPerPixel == 4) {
+		__m128i p[4] = { zero, zero, zero, zero };
+		for (int i = 0; i < 4; i++) {
+			__m128i l = _mm_cvtsi32_si128(loss[i]);
+			__m128i s = _mm_cvtsi32_si128(shift[i]);
+			__m128i lo = _mm_unpacklo_epi8(c[i], zero);
+			__m128i hi = _mm_unpackhi_epi8(c[i], zero);
+			p[0] = _mm_or_si128(p[0], _mm_sll_epi32(_mm_srl_epi32(_mm_unpacklo_epi16(lo, zero), l), s));
+			p[1] = _mm_or_si128(p[1], _mm_sll_epi32(_mm_srl_epi32(_mm_unpackhi_epi16(lo, zero), l), s));
+			p[2] = _mm_or_si128(p[2], _mm_sll_epi32(_mm_srl_epi32(_mm_unpacklo_epi16(hi, zero), l), s));
+			p[3] = _mm_or_si128(p[3], _mm_sll_epi32(_mm_srl_epi32(_mm_unpackhi_epi16(hi, zero), l), s));
+		}
+		for (int i = 0; i < 4; i++)
+			_mm_storeu_si128((__m128i *)(dst + 16 * i), p[i]);
+	} else {
+		// There is no 3 way interleave in SSE2
+		byte r[kBlockSize], g[kBlockSize], b[kBlockSize];
+		_mm_storeu_si128((__m128i *)r, c[0]);
+		_mm_storeu_si128((__m128i *)g, c[1]);
+		_mm_storeu_si128((__m128i *)b, c[2]);
+		for (int i = 0; i < kBlockSize; i++, dst += 3)
+			writePixel(dst, 3, format.RGBToColor(r[i], g[i], b[i]));
+	}
+}
+
+#elif defined(USE_NEON_YUV)
+
+static inline uint8x16_t addClip(int16x8_t yLo, int16x8_t yHi, const int16 *chroma) {
+	return vcombine_u8(vqmovun_s16(vaddq_s16(yLo, vld1q_s16(chroma))),
+	                   vqmovun_s16(vaddq_s16(yHi, vld1q_s16(chroma + 8))));
+}
 
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+/**
+ * Convert one block of pixels. Alpha is taken from aSrc when there is one,
+ * the pixels are opaque otherwise.
+ */
+static void convertBlock(byte *dst, const PixelFormat &format, const byte *ySrc, const byte *aSrc, const ChromaBlock &chroma) {
+	uint8x16_t y = vld1q_u8(ySrc);
+	int16x8_t yLo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y)));
+	int16x8_t yHi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y)));
+
+	// The saturating narrowing does the clipping
+	uint8x16_t c[4];
+	c[0] = addClip(yLo, yHi, chroma.r);
+	c[1] = addClip(yLo, yHi, chroma.g);
+	c[2] = addClip(yLo, yHi, chroma.b);
+	c[3] = aSrc ? vld1q_u8(aSrc) : vdupq_n_u8(0xFF);
+
+	const byte loss[4]  = { format.rLoss,  format.gLoss,  format.bLoss,  format.aLoss  };
+	const byte shift[4] = { format.rShift, format.gShift, format.bShift, format.aShift };
+
+	if (format.bytesPerPixel == 2) {
+		uint16x8_t lo = vdupq_n_u16(0), hi = vdupq_n_u16(0);
+		for (int i = 0; i < 4; i++) {
+			int16x8_t l = vdupq_n_s16(-loss[i]);
+			int16x8_t s = vdupq_n_s16(shift[i]);
+			lo = vorrq_u16(lo, vshlq_u16(vshlq_u16(vmovl_u8(vget_low_u8(c[i])), l), s));
+			hi = vorrq_u16(hi, vshlq_u16(vshlq_u16(vmovl_u8(vget_high_u8(c[i])), l), s));
+		}
+		vst1q_u16((uint16 *)dst, lo);
+		vst1q_u16((uint16 *)(dst + 16), hi);
+	} else if (format.bytesPerPixel == 4) {
+		uint32x4_t p[4] = { vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0) };
+		for (int i = 0; i < 4; i++) {
+			int32x4_t l = vdupq_n_s32(-loss[i]);
+			int32x4_t s = vdupq_n_s32(shift[i]);
+			uint16x8_t lo = vmovl_u8(vget_low_u8(c[i]));
+			uint16x8_t hi = vmovl_u8(vget_high_u8(c[i]));
+			p[0] = vorrq_u32(p[0], vshlq_u32(vshlq_u32(vmovl_u16(vget_low_u16(lo)), l), s));
+			p[1] = vorrq_u32(p[1], vshlq_u32(vshlq_u32(vmovl_u16(vget_high_u16(lo)), l), s));
+			p[2] = vorrq_u32(p[2], vshlq_u32(vshlq_u32(vmovl_u16(vget_low_u16(hi)), l), s));
+			p[3] = vorrq_u32(p[3], vshlq_u32(vshlq_u32(vmovl_u16(vget_high_u16(hi)), l), s));
+		}
+		for (int i = 0; i < 4; i++)
+			vst1q_u32((uint32 *)(dst + 16 * i), p[i]);
+	} else {
+		// Checked by isPackedRGB24(), the first byte has the highest shift
+		uint8x16x3_t rgb;
+		rgb.val[(16 - format.rShift) / 8] = c[0];
+		rgb.val[(16 - format.gShift) / 8] = c[1];
+		rgb.val[(16 - format.bShift) / 8] = c[2];
+		vst3q_u8(dst, rgb);
 	}
 }
 
-void convertYUV420ToRGB(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+#endif
+
+/**
+ * Convert the rows of a YUV image sharing one row of chroma: one with
+ * YUV444, two with YUV420. aSrc may be 0.
+ */
+static void convertRows(byte *dst, int dstPitch, const PixelFormat &format, const YUVToRGBLookup *lookup,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+		int yWidth, int yPitch, int rows, int chromaShift) {
+	int bpp = format.bytesPerPixel;
+	int w = 0;
+
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+	if (bpp != 3 || isPackedRGB24(format)) {
+		ChromaBlock chroma;
+		for (; w + kBlockSize <= yWidth; w += kBlockSize) {
+			// The table lookups stay scalar, once for the rows sharing them
+			for (int i = 0; i < kBlockSize; i++) {
+				byte u = uSrc[(w + i) >> chromaShift];
+				byte v = vSrc[(w + i) >> chromaShift];
+				chroma.r[i] = lookup->_crR[v];
+				chroma.g[i] = lookup->_crG[v] + lookup->_cbG[u];
+				chroma.b[i] = lookup->_cbB[u];
+			}
+
+			for (int row = 0; row < rows; row++)
+				convertBlock(dst + row * dstPitch + w * bpp, format, ySrc + row * yPitch + w,
+						aSrc ? aSrc + row * yPitch + w : 0, chroma);
+		}
+	}
+#endif
+
+	for (; w < yWidth; w++) {
+		byte u = uSrc[w >> chromaShift];
+		byte v = vSrc[w >> chromaShift];
+		int16 cr_r  = lookup->_crR[v];
+		int16 crb_g = lookup->_crG[v] + lookup->_cbG[u];
+		int16 cb_b  = lookup->_cbB[u];
+
+		for (int row = 0; row < rows; row++) {
+			int y = ySrc[row * yPitch + w];
+			byte a = aSrc ? aSrc[row * yPitch + w] : 0xFF;
+			uint32 color = format.ARGBToColor(a, CLIP(y + cr_r, 0, 255), CLIP(y + crb_g, 0, 255), CLIP(y + cb_b, 0, 255));
+			writePixel(dst + row * dstPitch + w * bpp, bpp, color);
+		}
+	}
+}
+
+static void convertYUV(byte *dst, int dstPitch, const PixelFormat &format, YUVToRGBCoefficients coefficients,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc,
+		int yWidth, int yHeight, int yPitch, int uvPitch, int chromaShift) {
 	// Sanity checks
-	assert(dst && dst->pixels);
-	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
+	assert(dst);
+	assert(format.bytesPerPixel >= 2 && format.bytesPerPixel <= 4);
 	assert(ySrc && uSrc && vSrc);
+
+	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(coefficients);
+	int rowStep = 1 << chromaShift;
+
+	for (int h = 0; h < yHeight; h += rowStep) {
+		int rows = MIN(rowStep, yHeight - h);
+		convertRows(dst, dstPitch, format, lookup, ySrc, uSrc, vSrc, aSrc, yWidth, yPitch, rows, chromaShift);
+
+		dst  += dstPitch * rowStep;
+		ySrc += yPitch * rowStep;
+		if (aSrc)
+			aSrc += yPitch * rowStep;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+void convertYUV420ToRGB(byte *dst, int dstPitch, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(dst->format);
+	convertYUV(dst, dstPitch, format, kYUVCoefficientsVideo, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch, 1);
+}
+
+void convertYUV420ToRGB(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	assert(dst && dst->pixels);
+
+	convertYUV420ToRGB((byte *)dst->pixels, dst->pitch, dst->format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void convertYUV444ToRGB(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, YUVToRGBCoefficients coefficients) {
+	assert(dst && dst->pixels);
+
+	convertYUV((byte *)dst->pixels, dst->pitch, dst->format, coefficients, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch, 0);
+}
+
+void convertYUVA420ToRGBA(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	assert(dst && dst->pixels);
+	assert(aSrc);
+	assert((yWidth & 1) == 0);
 
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->pixels, dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV420ToRGB<uint32>((byte *)dst->pixels, dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+	convertYUV((byte *)dst->pixels, dst->pitch, dst->format, kYUVCoefficientsVideo, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, 1);
 }
 
 } // End of namespace Graphics
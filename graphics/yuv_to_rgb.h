@@ -35,6 +35,30 @@
 
 namespace Graphics {
 
+/** The colors a YUV triplet stands for */
+enum YUVToRGBCoefficients {
+	kYUVCoefficientsVideo = 0, ///< Those used for the video codecs, from mpeg_play
+	kYUVCoefficientsJPEG  = 1  ///< Those of YUV2RGB(), used for the JPEG images
+};
+
+/**
+ * Convert a YUV420 image to RGB pixels of any 2, 3 or 4 bytes format.
+ * Blocks of 16 pixels are converted at once when SSE2 or NEON is available,
+ * with the same result.
+ *
+ * @param dst      the destination pixels
+ * @param dstPitch the pitch of the destination
+ * @param format   the format of the destination
+ * @param ySrc     the source of the y component
+ * @param uSrc     the source of the u component
+ * @param vSrc     the source of the v component
+ * @param yWidth   the width of the y surface (must be divisible by 2)
+ * @param yHeight  the height of the y surface (must be divisible by 2)
+ * @param yPitch   the pitch of the y surface
+ * @param uvPitch  the pitch of the u and v surfaces
+ */
+void convertYUV420ToRGB(byte *dst, int dstPitch, const Graphics::PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
 /**
  * Convert a YUV420 image to an RGB surface
  *
@@ -49,6 +73,21 @@ namespace Graphics {
  */
 void convertYUV420ToRGB(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+/**
+ * Convert a YUV444 image, such as the components of a JPEG, to an RGB surface
+ *
+ * @param dst          the destination surface
+ * @param ySrc         the source of the y component
+ * @param uSrc         the source of the u component
+ * @param vSrc         the source of the v component
+ * @param yWidth       the width of the surfaces
+ * @param yHeight      the height of the surfaces
+ * @param yPitch       the pitch of the y surface
+ * @param uvPitch      the pitch of the u and v surfaces
+ * @param coefficients the conversion to use
+ */
+void convertYUV444ToRGB(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, YUVToRGBCoefficients coefficients = kYUVCoefficientsVideo);
+
 } // End of namespace Graphics
 
 #endif
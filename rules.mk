@@ -20,12 +20,14 @@ ifdef TOOL_EXECUTABLE
 # TODO: Refactor this, so that even our master executable can use this rule?
 ################################################
 TOOL-$(MODULE) := $(MODULE)/$(TOOL_EXECUTABLE)$(EXEEXT)
+$(TOOL-$(MODULE)): TOOL_LIBS := $(TOOL_LIBS)
 $(TOOL-$(MODULE)): $(MODULE_OBJS-$(MODULE)) $(TOOL_DEPS)
-	$(QUIET_CXX)$(CXX) $(LDFLAGS) $+ -o $@
+	$(QUIET_CXX)$(CXX) $(LDFLAGS) $+ $(TOOL_LIBS) -o $@
 
 # Reset TOOL_* vars
 TOOL_EXECUTABLE:=
 TOOL_DEPS:=
+TOOL_LIBS:=
 
 # Add to "devtools" target
 devtools: $(TOOL-$(MODULE))
@@ -0,0 +1,30 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostats.h"
+
+class AudioStatsTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_histogram() {
+		Audio::DurationHistogram h;
+		h.add(0);
+		h.add(1);
+		h.add(3);
+		h.add(4);
+		h.add(7);
+		h.add(1000);
+
+		TS_ASSERT_EQUALS(h.count, 6u);
+		TS_ASSERT_EQUALS(h.total, 1015u);
+		TS_ASSERT_EQUALS(h.max, 1000u);
+		TS_ASSERT_EQUALS(h.buckets[0], 1u);
+		TS_ASSERT_EQUALS(h.buckets[1], 1u);
+		TS_ASSERT_EQUALS(h.buckets[2], 1u);
+		TS_ASSERT_EQUALS(h.buckets[3], 2u);
+		TS_ASSERT_EQUALS(h.buckets[Audio::DurationHistogram::kBuckets - 1], 1u);
+
+		h.reset();
+		TS_ASSERT_EQUALS(h.count, 0u);
+		TS_ASSERT_EQUALS(h.format(), "no samples");
+	}
+};
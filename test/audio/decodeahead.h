@@ -0,0 +1,108 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decodeahead.h"
+
+#include "helper.h"
+
+class DecodeAheadStreamTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_read_mono() {
+		testRead(11025, false);
+	}
+
+	void test_read_stereo() {
+		testRead(22050, true);
+	}
+
+	void test_seek() {
+		const int sampleRate = 11025;
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 1, &sine, false, false);
+		Audio::SeekableAudioStream *ahead = Audio::makeDecodeAheadStream(s, DisposeAfterUse::YES, 1, 100);
+
+		int16 *buffer = new int16[sampleRate];
+		TS_ASSERT_EQUALS(ahead->readBuffer(buffer, 100), 100);
+
+		// Nothing comes out until the seek has been done
+		TS_ASSERT_EQUALS(ahead->seek(Audio::Timestamp(500, sampleRate)), true);
+		TS_ASSERT_EQUALS(ahead->readBuffer(buffer, 100), 0);
+		TS_ASSERT_EQUALS(ahead->endOfData(), false);
+		Audio::decodeAheadStreams();
+
+		const int half = sampleRate / 2;
+		TS_ASSERT_EQUALS(readAll(ahead, buffer, sampleRate), sampleRate - half);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + half, (sampleRate - half) * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(ahead->endOfData(), true);
+
+		// Rewinding after the end works too
+		TS_ASSERT_EQUALS(ahead->rewind(), true);
+		Audio::decodeAheadStreams();
+		TS_ASSERT_EQUALS(readAll(ahead, buffer, sampleRate), sampleRate);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, sampleRate * sizeof(int16)), 0);
+
+		TS_ASSERT_EQUALS(ahead->seek(Audio::Timestamp(2000, sampleRate)), false);
+
+		delete[] buffer;
+		delete[] sine;
+		delete ahead;
+		Audio::decodeAheadStreams();
+	}
+
+	void test_loop() {
+		const int sampleRate = 11025;
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 1, &sine, false, false);
+		Audio::SeekableAudioStream *ahead = Audio::makeDecodeAheadStream(s, DisposeAfterUse::YES, 3, 100);
+
+		int16 *buffer = new int16[sampleRate * 4];
+		TS_ASSERT_EQUALS(readAll(ahead, buffer, sampleRate * 4), sampleRate * 3);
+		for (int i = 0; i < 3; ++i)
+			TS_ASSERT_EQUALS(memcmp(buffer + i * sampleRate, sine, sampleRate * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(ahead->endOfData(), true);
+
+		delete[] buffer;
+		delete[] sine;
+		delete ahead;
+		Audio::decodeAheadStreams();
+	}
+
+private:
+	// Read like the mixer would, with the decoder running in between
+	static int readAll(Audio::AudioStream *stream, int16 *buffer, int numSamples) {
+		int total = 0;
+		while (total < numSamples && !stream->endOfData()) {
+			total += stream->readBuffer(buffer + total, MIN(512, numSamples - total));
+			Audio::decodeAheadStreams();
+		}
+		return total;
+	}
+
+	void testRead(const int sampleRate, const bool isStereo) {
+		const int secondLength = sampleRate * (isStereo ? 2 : 1);
+
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 1, &sine, false, isStereo);
+		Audio::SeekableAudioStream *ahead = Audio::makeDecodeAheadStream(s, DisposeAfterUse::YES, 1, 100);
+
+		TS_ASSERT_EQUALS(ahead->isStereo(), isStereo);
+		TS_ASSERT_EQUALS(ahead->getRate(), sampleRate);
+		TS_ASSERT_EQUALS(ahead->getLength().totalNumberOfFrames(), sampleRate);
+		TS_ASSERT_EQUALS(ahead->endOfData(), false);
+
+		// The buffer is filled on creation, but only holds part of the stream
+		int16 *buffer = new int16[secondLength];
+		int first = ahead->readBuffer(buffer, secondLength);
+		TS_ASSERT_LESS_THAN(0, first);
+		TS_ASSERT_LESS_THAN(first, secondLength);
+
+		TS_ASSERT_EQUALS(readAll(ahead, buffer + first, secondLength - first), secondLength - first);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, secondLength * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(ahead->endOfData(), true);
+
+		delete[] buffer;
+		delete[] sine;
+		delete ahead;
+		Audio::decodeAheadStreams();
+	}
+};
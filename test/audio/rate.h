@@ -0,0 +1,224 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/config-manager.h"
+
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_copy_stereo() {
+		testCopy(true, false);
+	}
+
+	void test_copy_reverse_stereo() {
+		testCopy(true, true);
+	}
+
+	void test_copy_mono() {
+		testCopy(false, false);
+	}
+
+	void test_linear_stereo() {
+		testLinear(true, false);
+	}
+
+	void test_linear_reverse_stereo() {
+		testLinear(true, true);
+	}
+
+	void test_linear_mono() {
+		testLinear(false, false);
+	}
+
+	void test_fir_dc_stereo() {
+		testFIRConstant(22050, 48000, true);
+	}
+
+	void test_fir_dc_mono() {
+		testFIRConstant(11025, 44100, false);
+	}
+
+	void test_fir_dc_downsample() {
+		testFIRConstant(48000, 44100, true);
+	}
+
+	// Upsampling a 5 kHz tone from 22050 Hz leaves an image at 17050 Hz,
+	// which is only attenuated by about 23 dB with linear interpolation
+	void test_fir_image() {
+		ConfMan.set("resampler", "fir", Common::ConfigManager::kTransientDomain);
+
+		const int inRate = 22050, outRate = 44100;
+		int16 *input = (int16 *)malloc(kFrames * sizeof(int16));
+		for (int i = 0; i < kFrames; ++i)
+			WRITE_BE_UINT16(&input[i], (int16)(sin(2 * M_PI * 5000 * i / inRate) * 16000));
+		Audio::SeekableAudioStream *s = Audio::makeRawStream((const byte *)input, kFrames * sizeof(int16), inRate, Audio::FLAG_16BITS);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false);
+
+		const int outFrames = 1800;
+		int16 *output = new int16[outFrames * 2];
+		memset(output, 0, outFrames * 2 * sizeof(int16));
+		TS_ASSERT_EQUALS(converter->flow(*s, output, outFrames, kVolR, kVolR), outFrames);
+
+		// Skip the start of the filter
+		double tone = magnitude(output + 200, outFrames - 200, 5000.0 / outRate);
+		double image = magnitude(output + 200, outFrames - 200, 17050.0 / outRate);
+		TS_ASSERT_LESS_THAN(image * 100, tone);
+
+		delete[] output;
+		delete converter;
+		delete s;
+		ConfMan.removeKey("resampler", Common::ConfigManager::kTransientDomain);
+	}
+
+	void test_fir_length() {
+		ConfMan.set("resampler", "fir", Common::ConfigManager::kTransientDomain);
+
+		int16 *input = (int16 *)malloc(kFrames * sizeof(int16));
+		for (int i = 0; i < kFrames; ++i)
+			WRITE_BE_UINT16(&input[i], i);
+		Audio::SeekableAudioStream *s = Audio::makeRawStream((const byte *)input, kFrames * sizeof(int16), 22050, Audio::FLAG_16BITS);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, false);
+
+		// Every input frame gives exactly two output frames
+		int16 *output = new int16[kFrames * 2 * 2 + 2];
+		memset(output, 0, (kFrames * 2 * 2 + 2) * sizeof(int16));
+		TS_ASSERT_EQUALS(converter->flow(*s, output, kFrames * 2 + 1, kVolR, kVolR), kFrames * 2);
+
+		delete[] output;
+		delete converter;
+		delete s;
+		ConfMan.removeKey("resampler", Common::ConfigManager::kTransientDomain);
+	}
+
+private:
+	enum {
+		kFrames = 1003,
+		kVolL = 200,
+		kVolR = Audio::Mixer::kMaxMixerVolume
+	};
+
+	// The output buffer starts close to the limits, so that the mix has to clip
+	static void fillOutput(int16 *buf, int samples) {
+		for (int i = 0; i < samples; ++i)
+			buf[i] = (int16)((i % 3 - 1) * 30000 + i);
+	}
+
+	static void mixReference(int16 *obuf, int in0, int in1, bool reverseStereo) {
+		int left = obuf[reverseStereo ? 1 : 0] + in0 * kVolL / Audio::Mixer::kMaxMixerVolume;
+		int right = obuf[reverseStereo ? 0 : 1] + in1 * kVolR / Audio::Mixer::kMaxMixerVolume;
+		obuf[reverseStereo ? 1 : 0] = (int16)CLIP<int>(left, -32768, 32767);
+		obuf[reverseStereo ? 0 : 1] = (int16)CLIP<int>(right, -32768, 32767);
+	}
+
+	// Magnitude of one frequency in the left channel of a stereo buffer
+	static double magnitude(const int16 *buf, int frames, double freq) {
+		double re = 0, im = 0;
+		for (int i = 0; i < frames; ++i) {
+			re += buf[i * 2] * cos(2 * M_PI * freq * i);
+			im += buf[i * 2] * sin(2 * M_PI * freq * i);
+		}
+		return sqrt(re * re + im * im);
+	}
+
+	// The coefficients of each phase add up to one, so once the filter
+	// is past the silence before the first input frame a constant comes
+	// out unchanged
+	void testFIRConstant(int inRate, int outRate, bool isStereo) {
+		ConfMan.set("resampler", "fir", Common::ConfigManager::kTransientDomain);
+
+		const int16 left = 12345, right = -5000;
+		const int samples = kFrames * (isStereo ? 2 : 1);
+		int16 *input = (int16 *)malloc(samples * sizeof(int16));
+		for (int i = 0; i < samples; ++i)
+			WRITE_BE_UINT16(&input[i], (isStereo && (i & 1)) ? right : left);
+		Audio::SeekableAudioStream *s = Audio::makeRawStream((const byte *)input, samples * sizeof(int16), inRate,
+		                                                     Audio::FLAG_16BITS | (isStereo ? Audio::FLAG_STEREO : 0));
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo);
+
+		const int outFrames = 500;
+		int16 *output = new int16[outFrames * 2];
+		memset(output, 0, outFrames * 2 * sizeof(int16));
+		TS_ASSERT_EQUALS(converter->flow(*s, output, outFrames, kVolR, kVolR), outFrames);
+
+		for (int i = 100; i < outFrames; ++i) {
+			TS_ASSERT_EQUALS(output[i * 2], left);
+			TS_ASSERT_EQUALS(output[i * 2 + 1], isStereo ? right : left);
+		}
+
+		delete[] output;
+		delete converter;
+		delete s;
+		ConfMan.removeKey("resampler", Common::ConfigManager::kTransientDomain);
+	}
+
+	void testCopy(bool isStereo, bool reverseStereo) {
+		const int rate = 22050;
+		int16 *input;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(rate, 1, &input, false, isStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(rate, rate, isStereo, reverseStereo);
+
+		int16 *output = new int16[kFrames * 2];
+		int16 *expected = new int16[kFrames * 2];
+		fillOutput(output, kFrames * 2);
+		fillOutput(expected, kFrames * 2);
+
+		for (int i = 0; i < kFrames; ++i) {
+			int in0 = isStereo ? input[i * 2] : input[i];
+			int in1 = isStereo ? input[i * 2 + 1] : in0;
+			mixReference(expected + i * 2, in0, in1, reverseStereo);
+		}
+
+		TS_ASSERT_EQUALS(converter->flow(*s, output, kFrames, kVolL, kVolR), kFrames);
+		TS_ASSERT_EQUALS(memcmp(output, expected, kFrames * 2 * sizeof(int16)), 0);
+
+		delete[] output;
+		delete[] expected;
+		delete[] input;
+		delete converter;
+		delete s;
+	}
+
+	void testLinear(bool isStereo, bool reverseStereo) {
+		const int inRate = 22050, outRate = 44100;
+		int16 *input;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, &input, false, isStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, reverseStereo);
+
+		int16 *output = new int16[kFrames * 2];
+		int16 *expected = new int16[kFrames * 2];
+		fillOutput(output, kFrames * 2);
+		fillOutput(expected, kFrames * 2);
+
+		// The same interpolation as LinearRateConverter, one frame at a time
+		const frac_t inc = (inRate << FRAC_BITS) / outRate;
+		frac_t pos = FRAC_ONE;
+		int last0 = 0, last1 = 0, cur0 = 0, cur1 = 0;
+		int inPos = 0;
+		for (int i = 0; i < kFrames; ++i) {
+			while (pos >= (frac_t)FRAC_ONE) {
+				last0 = cur0;
+				last1 = cur1;
+				cur0 = input[inPos++];
+				cur1 = isStereo ? input[inPos++] : cur0;
+				pos -= FRAC_ONE;
+			}
+			int out0 = (int16)(last0 + (((cur0 - last0) * pos + FRAC_HALF) >> FRAC_BITS));
+			int out1 = (int16)(last1 + (((cur1 - last1) * pos + FRAC_HALF) >> FRAC_BITS));
+			mixReference(expected + i * 2, out0, out1, reverseStereo);
+			pos += inc;
+		}
+
+		TS_ASSERT_EQUALS(converter->flow(*s, output, kFrames, kVolL, kVolR), kFrames);
+		TS_ASSERT_EQUALS(memcmp(output, expected, kFrames * 2 * sizeof(int16)), 0);
+
+		delete[] output;
+		delete[] expected;
+		delete[] input;
+		delete converter;
+		delete s;
+	}
+};
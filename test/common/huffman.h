@@ -0,0 +1,222 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+
+#include "test/random_helper.h"
+
+class HuffmanTestSuite : public CxxTest::TestSuite {
+	public:
+	// Codes up to 12 bits, so that the second-level tables are used
+	void test_lookup_msb() {
+		_random.setSeed(1);
+		for (int n = 0; n < 20; n++)
+			checkDecode(true, 12);
+	}
+
+	void test_lookup_lsb() {
+		_random.setSeed(2);
+		for (int n = 0; n < 20; n++)
+			checkDecode(false, 12);
+	}
+
+	// Short codes only use the first-level table
+	void test_lookup_short() {
+		_random.setSeed(3);
+		for (int n = 0; n < 20; n++) {
+			checkDecode(true, 6);
+			checkDecode(false, 6);
+		}
+	}
+
+	void test_get_symbol_bits() {
+		// 0 -> 'a', 10 -> 'b', 110 -> 'c', 111 -> 'd'
+		const uint32 codes[]   = { 0, 2, 6, 7 };
+		const uint8 lengths[]  = { 1, 2, 3, 3 };
+		const uint32 symbols[] = { 'a', 'b', 'c', 'd' };
+		Common::Huffman huffman(0, 4, codes, lengths, symbols);
+
+		TS_ASSERT_EQUALS(huffman.getMaxLength(), 3);
+
+		uint8 length;
+		TS_ASSERT_EQUALS(huffman.getSymbol(0x3, true, length), (uint32)'a');
+		TS_ASSERT_EQUALS(length, 1);
+		TS_ASSERT_EQUALS(huffman.getSymbol(0x5, true, length), (uint32)'b');
+		TS_ASSERT_EQUALS(length, 2);
+		TS_ASSERT_EQUALS(huffman.getSymbol(0x6, true, length), (uint32)'c');
+		TS_ASSERT_EQUALS(length, 3);
+		TS_ASSERT_EQUALS(huffman.getSymbol(0x7, true, length), (uint32)'d');
+		TS_ASSERT_EQUALS(length, 3);
+	}
+
+	void test_peek_skip_msb() {
+		_random.setSeed(4);
+		checkBits<Common::BitStream8MSB>();
+		checkBits<Common::BitStream16BEMSB>();
+		checkBits<Common::BitStream32LEMSB>();
+	}
+
+	void test_peek_skip_lsb() {
+		_random.setSeed(5);
+		checkBits<Common::BitStream8LSB>();
+		checkBits<Common::BitStream16LELSB>();
+		checkBits<Common::BitStream32LELSB>();
+	}
+
+	void test_peek_past_end() {
+		byte data[] = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+		Common::MemoryReadStream msbStream(data, sizeof(data));
+		Common::BitStream32BEMSB msb(msbStream);
+		msb.skip(28);
+		TS_ASSERT_EQUALS(msb.peekBits(8), 0xF0u);
+		TS_ASSERT_EQUALS(msb.pos(), 28u);
+
+		Common::MemoryReadStream lsbStream(data, sizeof(data));
+		Common::BitStream32LELSB lsb(lsbStream);
+		lsb.skip(28);
+		TS_ASSERT_EQUALS(lsb.peekBits(8), 0x0Fu);
+		TS_ASSERT_EQUALS(lsb.pos(), 28u);
+	}
+
+	private:
+	enum {
+		kMaxCodes = 256,
+		kSymbolCount = 2000
+	};
+
+	TestRandom _random;
+
+	/**
+	 * Build a complete prefix code by splitting random leaves of the code
+	 * tree. The codes have their first bit as the MSB.
+	 */
+	uint32 buildCodes(uint32 *codes, uint8 *lengths, uint8 maxLength) {
+		uint32 count = 1;
+		codes[0] = 0;
+		lengths[0] = 0;
+
+		for (int i = 0; i < 200 && count < kMaxCodes; i++) {
+			uint32 leaf = _random.getRandomNumber() % count;
+			if (lengths[leaf] >= maxLength)
+				continue;
+
+			codes[count] = (codes[leaf] << 1) | 1;
+			lengths[count] = lengths[leaf] + 1;
+			codes[leaf] <<= 1;
+			lengths[leaf]++;
+			count++;
+		}
+
+		return count;
+	}
+
+	static uint32 reverseBits(uint32 code, uint8 length) {
+		uint32 reversed = 0;
+		for (uint8 i = 0; i < length; i++)
+			reversed |= ((code >> i) & 1) << (length - 1 - i);
+
+		return reversed;
+	}
+
+	/**
+	 * Encode random symbols, and decode them with the lookup tables, and
+	 * with the bit walk used for long codes.
+	 */
+	void checkDecode(bool msbFirst, uint8 maxLength) {
+		uint32 codes[kMaxCodes], symbols[kMaxCodes];
+		uint8 lengths[kMaxCodes];
+		uint32 count = buildCodes(codes, lengths, maxLength);
+
+		// A stream in LSB first order holds the first bit of a code at bit 0
+		uint32 streamCodes[kMaxCodes];
+		for (uint32 i = 0; i < count; i++) {
+			streamCodes[i] = msbFirst ? codes[i] : reverseBits(codes[i], lengths[i]);
+			symbols[i] = _random.getRandomNumber();
+		}
+
+		uint32 *message = new uint32[kSymbolCount];
+		byte *data = new byte[kSymbolCount * maxLength / 8 + 4];
+		memset(data, 0, kSymbolCount * maxLength / 8 + 4);
+
+		uint32 bitCount = 0;
+		for (uint32 i = 0; i < kSymbolCount; i++) {
+			message[i] = _random.getRandomNumber() % count;
+
+			for (uint8 j = 0; j < lengths[message[i]]; j++, bitCount++) {
+				if (!((codes[message[i]] >> (lengths[message[i]] - 1 - j)) & 1))
+					continue;
+
+				if (msbFirst)
+					data[bitCount / 8] |= 0x80 >> (bitCount % 8);
+				else
+					data[bitCount / 8] |= 1 << (bitCount % 8);
+			}
+		}
+
+		const uint32 dataSize = (bitCount + 31) / 32 * 4;
+
+		Common::Huffman tables(0, count, streamCodes, lengths, symbols);
+		// Longer than the longest code with tables
+		Common::Huffman walk(21, count, streamCodes, lengths, symbols);
+
+		for (int pass = 0; pass < 2; pass++) {
+			const Common::Huffman &huffman = pass ? walk : tables;
+			Common::MemoryReadStream stream(data, dataSize);
+
+			Common::BitStream *bits;
+			if (msbFirst)
+				bits = new Common::BitStream8MSB(stream);
+			else
+				bits = new Common::BitStream32LELSB(stream);
+
+			uint32 errors = 0;
+			for (uint32 i = 0; i < kSymbolCount; i++)
+				if (huffman.getSymbol(*bits) != symbols[message[i]])
+					errors++;
+
+			TS_ASSERT_EQUALS(errors, 0u);
+			TS_ASSERT_EQUALS(bits->pos(), bitCount);
+
+			delete bits;
+		}
+
+		delete[] message;
+		delete[] data;
+	}
+
+	/** Compare peekBits(), getBits() and skip() with reading single bits. */
+	template<class BITSTREAM>
+	void checkBits() {
+		byte data[64];
+		for (int i = 0; i < 64; i++)
+			data[i] = _random.getRandomNumber() & 0xFF;
+
+		Common::MemoryReadStream stream(data, sizeof(data)), refStream(data, sizeof(data));
+		BITSTREAM bits(stream), ref(refStream);
+
+		uint32 errors = 0;
+		while (ref.pos() + 32 <= ref.size()) {
+			uint8 n = _random.getRandomNumber() % 32 + 1;
+
+			uint32 expected = 0;
+			for (uint8 i = 0; i < n; i++)
+				ref.addBit(expected, i);
+
+			uint32 peeked = bits.peekBits(n);
+			uint32 value;
+			if (_random.getRandomNumber() & 1) {
+				value = bits.getBits(n);
+			} else {
+				value = peeked;
+				bits.skip(n);
+			}
+
+			if (peeked != expected || value != expected || bits.pos() != ref.pos())
+				errors++;
+		}
+
+		TS_ASSERT_EQUALS(errors, 0u);
+	}
+};
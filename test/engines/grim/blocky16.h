@@ -0,0 +1,226 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+
+#include "engines/grim/movie/codecs/blocky16.h"
+
+#include "test/random_helper.h"
+
+/*
+ * The checksums of the frames were taken once from the decoder as it was
+ * before the motion and pattern tables, on the same streams.
+ */
+class Blocky16TestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_codec2() {
+		TS_ASSERT_EQUALS(testStream(640, 480, 12, 1, 0, 100), 0x3ab3334cu);
+	}
+
+	void test_codec2_small() {
+		TS_ASSERT_EQUALS(testStream(100, 64, 100, 2, 0, 100), 0xc5e71ce5u);
+	}
+
+	// The blocks of a row run past its end
+	void test_codec2_unaligned() {
+		TS_ASSERT_EQUALS(testStream(36, 20, 200, 3, 0, 100), 0xf22deeb8u);
+	}
+
+	// Mostly copies, with the motion vectors spread over the whole table
+	void test_codec2_copies() {
+		TS_ASSERT_EQUALS(testStream(100, 64, 100, 4, 0, 60), 0xac7b5f0du);
+		TS_ASSERT_EQUALS(testStream(36, 20, 200, 5, 35, 60), 0xc8cb10cfu);
+	}
+
+	// Mostly fills and two-colour blocks
+	void test_codec2_fills() {
+		TS_ASSERT_EQUALS(testStream(100, 64, 100, 6, 60, 100), 0x6eab400du);
+	}
+
+private:
+	enum {
+		kHeaderSize = 560,
+		kPadding = 64,
+		// The largest motion vector of the table, in either direction
+		kMaxMotion = 43
+	};
+
+	TestRandom _random;
+	int _width, _height;
+	int _minKind, _maxKind;
+	// Where the decoder keeps the current frame and the two previous ones,
+	// from the start of its delta buffer, and how large that is
+	int32 _curBuf, _deltaBufs[2];
+	int32 _deltaSize;
+	int32 _offset1, _offset2;
+	Common::Array<byte> _stream;
+
+	void put16(int value) {
+		_stream.push_back(value & 0xff);
+		_stream.push_back((value >> 8) & 0xff);
+	}
+
+	// Whether a block copied from offset bytes away stays inside the delta
+	// buffer, which the decoder does not check
+	bool inBuffers(int x, int y, int size, int32 offset) {
+		int pitch = _width * 2;
+		// The blocks of a row run past its end when the width is not a multiple of 8
+		int32 start = _curBuf;
+		start += (y / 8) * (((_width + 7) / 8) * 16 + 7 * pitch) + (x / 8) * 16;
+		start += (y % 8) * pitch + (x % 8) * 2 + offset;
+		int32 end = start + (size - 1) * pitch + size * 2;
+		return start >= 0 && end <= _deltaSize;
+	}
+
+	void makeBlock(int size, int x, int y) {
+		int kind = _minKind + _random.getRandomNumber() % (_maxKind - _minKind);
+
+		// Copies from the other buffers
+		if (kind < 35 && inBuffers(x, y, size, _offset1)) {
+			_stream.push_back(0);
+			return;
+		}
+		if (kind < 50) {
+			// Any motion vector of the table has to fit
+			byte code = _random.getRandomNumber() % 0xf5;
+			int32 motion = (kMaxMotion * _width + kMaxMotion) * 2;
+			if (inBuffers(x, y, size, _offset1 - motion) && inBuffers(x, y, size, _offset1 + motion)) {
+				_stream.push_back(code);
+				return;
+			}
+		}
+		if (kind < 55) {
+			int16 motion = (int16)((int)(_random.getRandomNumber() % 2001) - 1000);
+			if (inBuffers(x, y, size, _offset1 + motion * 2)) {
+				_stream.push_back(0xf5);
+				put16(motion);
+				return;
+			}
+		}
+		if (kind < 60 && inBuffers(x, y, size, _offset2)) {
+			_stream.push_back(0xf6);
+			return;
+		}
+
+		if (kind < 70 && size > 2) {
+			int half = size / 2;
+			_stream.push_back(0xff);
+			makeBlock(half, x, y);
+			makeBlock(half, x + half, y);
+			makeBlock(half, x, y + half);
+			makeBlock(half, x + half, y + half);
+			return;
+		}
+
+		// Four pixels for a 2x2 block, two colours and a pattern for the others
+		if (kind < 78) {
+			if (size == 2) {
+				if (_random.getRandomNumber() & 1) {
+					_stream.push_back((_random.getRandomNumber() & 1) ? 0xff : 0xf8);
+					for (int i = 0; i < 4; i++)
+						put16(_random.getRandomNumber());
+				} else {
+					_stream.push_back(0xf7);
+					for (int i = 0; i < 4; i++)
+						_stream.push_back(_random.getRandomNumber() & 0xff);
+				}
+			} else {
+				if (_random.getRandomNumber() & 1) {
+					_stream.push_back(0xf8);
+					_stream.push_back(_random.getRandomNumber() & 0xff);
+					put16(_random.getRandomNumber());
+					put16(_random.getRandomNumber());
+				} else {
+					_stream.push_back(0xf7);
+					for (int i = 0; i < 3; i++)
+						_stream.push_back(_random.getRandomNumber() & 0xff);
+				}
+			}
+			return;
+		}
+
+		// Fills
+		byte code = 0xf9 + _random.getRandomNumber() % 6;
+		_stream.push_back(code);
+		if (code == 0xfd)
+			_stream.push_back(_random.getRandomNumber() & 0xff);
+		else if (code == 0xfe)
+			put16(_random.getRandomNumber());
+	}
+
+	void makeFrame(int frame) {
+		_stream.resize(kHeaderSize);
+		for (int i = 0; i < kHeaderSize; i++)
+			_stream[i] = _random.getRandomNumber() & 0xff;
+
+		WRITE_LE_UINT16(&_stream[16], frame);
+		_stream[19] = _random.getRandomNumber() % 3;
+
+		uint32 type = _random.getRandomNumber() % 10;
+		if (frame == 0 || type == 0) {
+			_stream[18] = 0;
+			for (int i = 0; i < _width * _height * 2; i++)
+				_stream.push_back(_random.getRandomNumber() & 0xff);
+		} else if (type == 1) {
+			// A copy of one of the other buffers
+			_stream[18] = 3 + _random.getRandomNumber() % 2;
+		} else {
+			_stream[18] = 2;
+			_offset1 = _deltaBufs[1] - _curBuf;
+			_offset2 = _deltaBufs[0] - _curBuf;
+			for (int y = 0; y < _height; y += 8)
+				for (int x = 0; x < _width; x += 8)
+					makeBlock(8, x, y);
+		}
+
+		for (int i = 0; i < kPadding; i++)
+			_stream.push_back(0);
+	}
+
+	// The decoder swaps its buffers after each frame of a sequence
+	void rotateBuffers() {
+		int32 cur = _curBuf;
+		if (_stream[19] == 1) {
+			_curBuf = _deltaBufs[1];
+			_deltaBufs[1] = cur;
+		} else if (_stream[19] == 2) {
+			_curBuf = _deltaBufs[0];
+			_deltaBufs[0] = _deltaBufs[1];
+			_deltaBufs[1] = cur;
+		}
+	}
+
+	// Decodes the frames of a stream, and returns the checksum of them all
+	uint32 testStream(int width, int height, int numFrames, uint32 seed, int minKind, int maxKind) {
+		_width = width;
+		_height = height;
+		_random.setSeed(seed);
+		_minKind = minKind;
+		_maxKind = maxKind;
+
+		int frameSize = width * height * 2;
+		_deltaSize = frameSize * 3 + 5700;
+		_deltaBufs[0] = 0;
+		_deltaBufs[1] = frameSize;
+		_curBuf = frameSize * 2;
+
+		Grim::Blocky16 decoder;
+		decoder.init(width, height);
+		byte *dest = new byte[frameSize];
+		uint32 checksum = 2166136261u;
+
+		for (int frame = 0; frame < numFrames; frame++) {
+			makeFrame(frame);
+			decoder.decode(dest, &_stream[0]);
+			rotateBuffers();
+
+			// FNV-1a over the pixels, which are native endian
+			for (int i = 0; i < frameSize; i += 2)
+				checksum = (checksum ^ READ_UINT16(dest + i)) * 16777619;
+		}
+
+		delete[] dest;
+		return checksum;
+	}
+};
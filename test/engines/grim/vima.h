@@ -0,0 +1,272 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+#include "common/util.h"
+
+#include "engines/grim/movie/codecs/vima.h"
+
+#include "test/random_helper.h"
+
+// The step tables of the decoder, for the reference below
+namespace VimaReference {
+
+static const int16 imcTable1[] = {
+	  7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+	 19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+	 50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+	130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+	337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+	876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+	2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+	5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8 imcTable2[] = {
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+	5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7
+};
+
+static const int8 imcOtherTable1[] = {
+	-1, 4, -1, 4
+};
+
+static const int8 imcOtherTable2[] = {
+	-1, -1, 2, 6, -1, -1, 2, 6
+};
+
+static const int8 imcOtherTable3[] = {
+	-1, -1, -1, -1, 1, 2, 4, 6,
+	-1, -1, -1, -1, 1, 2, 4, 6
+};
+
+static const int8 imcOtherTable4[] = {
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	1, 1, 1, 2, 2, 4, 5, 6,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	1, 1, 1, 2, 2, 4, 5, 6
+};
+
+static const int8 imcOtherTable5[] = {
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	 1, 1, 1, 1, 1, 2, 2, 2,
+	 2, 4, 4, 4, 5, 5, 6, 6,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	 1, 1, 1, 1, 1, 2, 2, 2,
+	 2, 4, 4, 4, 5, 5, 6, 6
+};
+
+static const int8 imcOtherTable6[] = {
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	 1, 1, 1, 1, 1, 1, 1, 1,
+	 1, 1, 2, 2, 2, 2, 2, 2,
+	 2, 2, 4, 4, 4, 4, 4, 4,
+	 5, 5, 5, 5, 6, 6, 6, 6,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1,
+	 1, 1, 1, 1, 1, 1, 1, 1,
+	 1, 1, 2, 2, 2, 2, 2, 2,
+	 2, 2, 4, 4, 4, 4, 4, 4,
+	 5, 5, 5, 5, 6, 6, 6, 6
+};
+
+static const int8 *const offsets[] = {
+	imcOtherTable1, imcOtherTable2, imcOtherTable3,
+	imcOtherTable4, imcOtherTable5, imcOtherTable6
+};
+
+} // End of namespace VimaReference
+
+class VimaTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_mono() {
+		testStreams(false, 2000);
+	}
+
+	void test_stereo() {
+		testStreams(true, 2000);
+	}
+
+	// Escape codes and table positions close to the ends of the table
+	void test_extremes() {
+		_random.setSeed(3);
+		for (int i = 0; i < 50; ++i) {
+			byte *src = makeStream((i & 1) != 0, 300, (i & 2) ? 0 : 88);
+			compare(src, 300);
+			delete[] src;
+		}
+	}
+
+	void test_short_input() {
+		Grim::vimaInit();
+
+		// Everything after the header reads as zero
+		const byte src[] = { 0x10, 0x12, 0x34 };
+		int16 dest[64];
+		int16 expected[64];
+		Grim::decompressVima(src, sizeof(src), dest, sizeof(dest));
+
+		byte padded[64];
+		memset(padded, 0, sizeof(padded));
+		memcpy(padded, src, sizeof(src));
+		decompressReference(padded, expected, sizeof(expected));
+		TS_ASSERT_EQUALS(memcmp(dest, expected, sizeof(dest)), 0);
+	}
+
+private:
+	enum {
+		kPadding = 16
+	};
+
+	TestRandom _random;
+
+	// A header followed by random codes, with enough bytes for even the
+	// worst case of an escape code for every sample
+	byte *makeStream(bool isStereo, int numSamples, int startPos) {
+		int channels = isStereo ? 2 : 1;
+		int size = 6 + numSamples * channels * 3 + kPadding;
+		byte *src = new byte[size];
+		for (int i = 0; i < size; ++i)
+			src[i] = _random.getRandomNumber() & 0xff;
+
+		byte *header = src;
+		for (int c = 0; c < channels; ++c) {
+			byte pos = startPos < 0 ? _random.getRandomNumber() % 89 : startPos;
+			*header++ = (c == 0 && isStereo) ? ~pos : pos;
+			header += 2;
+		}
+		return src;
+	}
+
+	void compare(const byte *src, int numFrames) {
+		Grim::vimaInit();
+
+		bool isStereo = (src[0] & 0x80) != 0;
+		int destLen = numFrames * (isStereo ? 2 : 1) * 2;
+		int srcLen = 6 + destLen / 2 * 3 + kPadding;
+		int16 *dest = new int16[destLen / 2];
+		int16 *expected = new int16[destLen / 2];
+
+		Grim::decompressVima(src, srcLen, dest, destLen);
+		decompressReference(src, expected, destLen);
+		TS_ASSERT_EQUALS(memcmp(dest, expected, destLen), 0);
+
+		delete[] dest;
+		delete[] expected;
+	}
+
+	void testStreams(bool isStereo, int numFrames) {
+		_random.setSeed(isStereo ? 2 : 1);
+		for (int i = 0; i < 20; ++i) {
+			byte *src = makeStream(isStereo, numFrames, -1);
+			compare(src, numFrames - i * 7);
+			delete[] src;
+		}
+	}
+
+	// The decoder as it was before the tables, reading one byte at a time
+	static void decompressReference(const byte *src, int16 *dest, int destLen) {
+		uint16 destTable[5786];
+		for (int destTableStartPos = 0, incer = 0; destTableStartPos < 64; destTableStartPos++, incer++) {
+			unsigned int destTablePos, imcTable1Pos;
+			for (imcTable1Pos = 0, destTablePos = destTableStartPos;
+					imcTable1Pos < ARRAYSIZE(VimaReference::imcTable1); imcTable1Pos++, destTablePos += 64) {
+				int put = 0, count, tableValue;
+				for (count = 32, tableValue = VimaReference::imcTable1[imcTable1Pos]; count != 0; count >>= 1, tableValue >>= 1) {
+					if (incer & count) {
+						put += tableValue;
+					}
+				}
+				destTable[destTablePos] = put;
+			}
+		}
+
+		int numChannels = 1;
+		byte sBytes[2];
+		int16 sWords[2];
+
+		sBytes[0] = *src++;
+		if (sBytes[0] & 0x80) {
+			sBytes[0] = ~sBytes[0];
+			numChannels = 2;
+		}
+		sWords[0] = READ_BE_UINT16(src);
+		src += 2;
+		if (numChannels > 1) {
+			sBytes[1] = *src++;
+			sWords[1] = READ_BE_UINT16(src);
+			src += 2;
+		}
+
+		int numSamples = destLen / (numChannels * 2);
+		int bits = READ_BE_UINT16(src);
+		int bitPtr = 0;
+		src += 2;
+
+		for (int channel = 0; channel < numChannels; channel++) {
+			int16 *destPos = dest + channel;
+			int currTablePos = sBytes[channel];
+			int outputWord = sWords[channel];
+
+			for (int sample = 0; sample < numSamples; sample++) {
+				int numBits = VimaReference::imcTable2[currTablePos];
+				bitPtr += numBits;
+				int highBit = 1 << (numBits - 1);
+				int lowBits = highBit - 1;
+				int val = (bits >> (16 - bitPtr)) & (highBit | lowBits);
+
+				if (bitPtr > 7) {
+					bits = ((bits & 0xff) << 8) | *src++;
+					bitPtr -= 8;
+				}
+
+				if (val & highBit)
+					val ^= highBit;
+				else
+					highBit = 0;
+
+				if (val == lowBits) {
+					outputWord = ((int16)(bits << bitPtr) & 0xffffff00);
+					bits = ((bits & 0xff) << 8) | *src++;
+					outputWord |= ((bits >> (8 - bitPtr)) & 0xff);
+					bits = ((bits & 0xff) << 8) | *src++;
+				} else {
+					int index = (val << (7 - numBits)) | (currTablePos << 6);
+					int delta = destTable[index];
+
+					if (val)
+						delta += (VimaReference::imcTable1[currTablePos] >> (numBits - 1));
+					if (highBit)
+						delta = -delta;
+
+					outputWord += delta;
+					if (outputWord < -0x8000)
+						outputWord = -0x8000;
+					else if (outputWord > 0x7fff)
+						outputWord = 0x7fff;
+				}
+
+				WRITE_BE_UINT16(destPos, outputWord);
+				destPos += numChannels;
+
+				currTablePos += VimaReference::offsets[numBits - 2][val];
+
+				if (currTablePos < 0)
+					currTablePos = 0;
+				else if (currTablePos > 88)
+					currTablePos = 88;
+			}
+		}
+	}
+};
@@ -0,0 +1,189 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/conversion.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuva_to_rgba.h"
+
+#include "test/random_helper.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_yuv420_rgb565() {
+		testYUV420(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), false);
+	}
+
+	void test_yuv420_argb1555() {
+		testYUV420(Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15), false);
+	}
+
+	void test_yuv420_rgba8888() {
+		testYUV420(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), false);
+	}
+
+	void test_yuva420_rgba8888() {
+		testYUV420(Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), true);
+	}
+
+	void test_yuva420_rgb565() {
+		testYUV420(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), true);
+	}
+
+	// The cube faces of Myst III
+	void test_jpeg_rgb24() {
+		_random.setSeed(7);
+		const Graphics::PixelFormat format(3, 8, 8, 8, 0, 16, 8, 0, 0);
+		fillPlanes(kPitch);
+
+		Graphics::Surface dst;
+		dst.create(kWidth, kHeight, format);
+		Graphics::convertYUV444ToRGB(&dst, _y, _u, _v, kWidth, kHeight, kPitch, kPitch, Graphics::kYUVCoefficientsJPEG);
+
+		for (int i = 0; i < kHeight; i++) {
+			const byte *p = (const byte *)dst.getBasePtr(0, i);
+			for (int j = 0; j < kWidth; j++, p += 3) {
+				byte r, g, b;
+				Graphics::YUV2RGB(_y[i * kPitch + j], _u[i * kPitch + j], _v[i * kPitch + j], r, g, b);
+				TS_ASSERT_EQUALS(p[0], r);
+				TS_ASSERT_EQUALS(p[1], g);
+				TS_ASSERT_EQUALS(p[2], b);
+			}
+		}
+
+		dst.free();
+	}
+
+	void test_jpeg_rgba8888() {
+		_random.setSeed(8);
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		fillPlanes(kPitch);
+
+		Graphics::Surface dst;
+		dst.create(kWidth, kHeight, format);
+		Graphics::convertYUV444ToRGB(&dst, _y, _u, _v, kWidth, kHeight, kPitch, kPitch, Graphics::kYUVCoefficientsJPEG);
+
+		for (int i = 0; i < kHeight; i++) {
+			for (int j = 0; j < kWidth; j++) {
+				byte r, g, b;
+				Graphics::YUV2RGB(_y[i * kPitch + j], _u[i * kPitch + j], _v[i * kPitch + j], r, g, b);
+				TS_ASSERT_EQUALS(*((const uint32 *)dst.getBasePtr(j, i)), format.RGBToColor(r, g, b));
+			}
+		}
+
+		dst.free();
+	}
+
+private:
+	enum {
+		// Not a multiple of the block size, so that the ends of the rows
+		// go through the scalar code
+		kWidth = 54,
+		kHeight = 6,
+		kPitch = 64
+	};
+
+	TestRandom _random;
+	byte _y[kPitch * kHeight];
+	byte _u[kPitch * kHeight];
+	byte _v[kPitch * kHeight];
+	byte _a[kPitch * kHeight];
+
+	// Mostly random, with the extremes that make the components clip
+	void fillPlanes(int pitch) {
+		for (int i = 0; i < pitch * kHeight; i++) {
+			_y[i] = (i % 7 == 0) ? 0 : (i % 7 == 1) ? 255 : _random.getRandomNumber() & 0xFF;
+			_u[i] = (i % 5 == 0) ? 0 : (i % 5 == 1) ? 255 : _random.getRandomNumber() & 0xFF;
+			_v[i] = (i % 3 == 0) ? 255 : _random.getRandomNumber() & 0xFF;
+			_a[i] = _random.getRandomNumber() & 0xFF;
+		}
+	}
+
+	void testYUV420(const Graphics::PixelFormat &format, bool withAlpha) {
+		_random.setSeed(format.bytesPerPixel + (withAlpha ? 10 : 0));
+		fillPlanes(kPitch);
+
+		Graphics::Surface dst;
+		dst.create(kWidth, kHeight, format);
+		if (withAlpha)
+			Graphics::convertYUVA420ToRGBA(&dst, _y, _u, _v, _a, kWidth, kHeight, kPitch, kPitch / 2);
+		else
+			Graphics::convertYUV420ToRGB(&dst, _y, _u, _v, kWidth, kHeight, kPitch, kPitch / 2);
+
+		ReferenceLookup ref(format, withAlpha);
+		for (int i = 0; i < kHeight; i++) {
+			for (int j = 0; j < kWidth; j++) {
+				byte u = _u[(i >> 1) * (kPitch / 2) + (j >> 1)];
+				byte v = _v[(i >> 1) * (kPitch / 2) + (j >> 1)];
+				uint32 expected = ref.pixel(_y[i * kPitch + j], u, v);
+				if (withAlpha)
+					expected |= ref._alphaToPix[_a[i * kPitch + j]];
+
+				if (format.bytesPerPixel == 2) {
+					TS_ASSERT_EQUALS(*((const uint16 *)dst.getBasePtr(j, i)), expected);
+				} else {
+					TS_ASSERT_EQUALS(*((const uint32 *)dst.getBasePtr(j, i)), expected);
+				}
+			}
+		}
+
+		dst.free();
+	}
+
+	// The lookup tables the video converters used before the SIMD code
+	struct ReferenceLookup {
+		int16 _colorTab[4 * 256];
+		uint32 _rgbToPix[3 * 768];
+		uint32 _alphaToPix[256];
+
+		ReferenceLookup(const Graphics::PixelFormat &format, bool withAlpha) {
+			int16 *Cr_r_tab = &_colorTab[0 * 256];
+			int16 *Cr_g_tab = &_colorTab[1 * 256];
+			int16 *Cb_g_tab = &_colorTab[2 * 256];
+			int16 *Cb_b_tab = &_colorTab[3 * 256];
+
+			uint32 *r_2_pix_alloc = &_rgbToPix[0 * 768];
+			uint32 *g_2_pix_alloc = &_rgbToPix[1 * 768];
+			uint32 *b_2_pix_alloc = &_rgbToPix[2 * 768];
+
+			for (int i = 0; i < 256; i++) {
+				int16 CR, CB;
+				CR = CB = (i - 128);
+				Cr_r_tab[i] = (int16) ( (0.419 / 0.299) * CR) + 0 * 768 + 256;
+				Cr_g_tab[i] = (int16) (-(0.299 / 0.419) * CR) + 1 * 768 + 256;
+				Cb_g_tab[i] = (int16) (-(0.114 / 0.331) * CB);
+				Cb_b_tab[i] = (int16) ( (0.587 / 0.331) * CB) + 2 * 768 + 256;
+			}
+
+			for (int i = 0; i < 256; i++) {
+				if (withAlpha) {
+					r_2_pix_alloc[i + 256] = format.ARGBToColor(0, i, 0, 0);
+					g_2_pix_alloc[i + 256] = format.ARGBToColor(0, 0, i, 0);
+					b_2_pix_alloc[i + 256] = format.ARGBToColor(0, 0, 0, i);
+				} else {
+					r_2_pix_alloc[i + 256] = format.RGBToColor(i, 0, 0);
+					g_2_pix_alloc[i + 256] = format.RGBToColor(0, i, 0);
+					b_2_pix_alloc[i + 256] = format.RGBToColor(0, 0, i);
+				}
+				_alphaToPix[i] = format.ARGBToColor(i, 0, 0, 0);
+			}
+
+			for (int i = 0; i < 256; i++) {
+				r_2_pix_alloc[i] = r_2_pix_alloc[256];
+				r_2_pix_alloc[i + 512] = r_2_pix_alloc[511];
+				g_2_pix_alloc[i] = g_2_pix_alloc[256];
+				g_2_pix_alloc[i + 512] = g_2_pix_alloc[511];
+				b_2_pix_alloc[i] = b_2_pix_alloc[256];
+				b_2_pix_alloc[i + 512] = b_2_pix_alloc[511];
+			}
+		}
+
+		uint32 pixel(byte y, byte u, byte v) const {
+			int16 cr_r  = _colorTab[0 * 256 + v];
+			int16 crb_g = _colorTab[1 * 256 + v] + _colorTab[2 * 256 + u];
+			int16 cb_b  = _colorTab[3 * 256 + u];
+			const uint32 *L = &_rgbToPix[y];
+			return L[cr_r] | L[crb_g] | L[cb_b];
+		}
+	};
+};
@@ -5,8 +5,19 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_LIBS    := audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+ifdef USE_BINK
+TESTS        += $(srcdir)/test/video/*.h
+TEST_LIBS    := video/libvideo.a $(TEST_LIBS)
+endif
+
+# Only the codecs are tested, so only they get linked in from the engine
+ifeq ($(ENABLE_GRIM), STATIC_PLUGIN)
+TESTS        += $(srcdir)/test/engines/grim/*.h
+TEST_LIBS    := engines/grim/libgrim.a $(TEST_LIBS)
+endif
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
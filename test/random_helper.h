@@ -0,0 +1,27 @@
+#ifndef TEST_RANDOM_HELPER_H
+#define TEST_RANDOM_HELPER_H
+
+#include "common/scummsys.h"
+
+/**
+ * Pseudo random test input, the same on every run and every platform.
+ * Common::RandomSource needs a system to be created, and some tests
+ * compare against checksums which depend on the exact sequence.
+ */
+class TestRandom {
+public:
+	TestRandom() : _seed(1) {}
+
+	void setSeed(uint32 seed) { _seed = seed; }
+
+	/** Returns the next number, in the range [0, 0xffff]. */
+	uint32 getRandomNumber() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 16;
+	}
+
+private:
+	uint32 _seed;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+
+#include "video/bink_dsp.h"
+
+#include "test/random_helper.h"
+
+class BinkDSPTestSuite : public CxxTest::TestSuite
+{
+public:
+	// Full range coefficients, so that the sums wrap around
+	void test_idct_random() {
+		_random.setSeed(1);
+		for (int n = 0; n < 500; n++) {
+			int16 block[64];
+			for (int i = 0; i < 64; i++)
+				block[i] = (int16)_random.getRandomNumber();
+
+			compareIDCT(block);
+		}
+	}
+
+	// Blocks as the decoder reads them: a DC value and a few small
+	// coefficients, or only a DC value
+	void test_idct_sparse() {
+		_random.setSeed(2);
+		for (int n = 0; n < 500; n++) {
+			int16 block[64];
+			memset(block, 0, sizeof(block));
+			block[0] = (int16)(_random.getRandomNumber() % 4096) - 2048;
+
+			int count = (n & 1) ? _random.getRandomNumber() % 10 : 0;
+			for (int i = 0; i < count; i++)
+				block[_random.getRandomNumber() % 64] = (int16)(_random.getRandomNumber() % 512) - 256;
+
+			compareIDCT(block);
+		}
+	}
+
+	void test_idct_put() {
+		_random.setSeed(3);
+		for (int n = 0; n < 200; n++) {
+			int16 block[64];
+			fillBlock(block, n);
+
+			byte pixels[kPitch * 10], expected[kPitch * 10];
+			fillPixels(pixels, expected);
+
+			int16 temp[64];
+			memcpy(temp, block, sizeof(temp));
+			referenceIDCT(temp, true, expected + kPitch + 1);
+
+			Video::binkIDCTPut(pixels + kPitch + 1, kPitch, block);
+			TS_ASSERT_EQUALS(memcmp(pixels, expected, sizeof(pixels)), 0);
+		}
+	}
+
+	void test_idct_add() {
+		_random.setSeed(4);
+		for (int n = 0; n < 200; n++) {
+			int16 block[64];
+			fillBlock(block, n);
+
+			byte pixels[kPitch * 10], expected[kPitch * 10];
+			fillPixels(pixels, expected);
+
+			int16 temp[64];
+			memcpy(temp, block, sizeof(temp));
+			referenceIDCT(temp, false, 0);
+			referenceAdd(expected + kPitch + 1, temp);
+
+			Video::binkIDCTAdd(pixels + kPitch + 1, kPitch, block);
+			TS_ASSERT_EQUALS(memcmp(pixels, expected, sizeof(pixels)), 0);
+		}
+	}
+
+	void test_add_residue() {
+		_random.setSeed(5);
+		for (int n = 0; n < 200; n++) {
+			int16 block[64];
+			for (int i = 0; i < 64; i++)
+				block[i] = (n & 1) ? (int16)_random.getRandomNumber() : (int16)(_random.getRandomNumber() % 64) - 32;
+
+			byte pixels[kPitch * 10], expected[kPitch * 10];
+			fillPixels(pixels, expected);
+			referenceAdd(expected + kPitch + 1, block);
+
+			Video::binkAddBlock(pixels + kPitch + 1, kPitch, block);
+			TS_ASSERT_EQUALS(memcmp(pixels, expected, sizeof(pixels)), 0);
+		}
+	}
+
+private:
+	enum {
+		// A pitch wider than the block, with a border around it which
+		// must not change
+		kPitch = 19
+	};
+
+	TestRandom _random;
+
+	void fillBlock(int16 *block, int n) {
+		for (int i = 0; i < 64; i++) {
+			if (n & 1)
+				block[i] = (int16)_random.getRandomNumber();
+			else
+				block[i] = (i < 10) ? (int16)(_random.getRandomNumber() % 2048) - 1024 : 0;
+		}
+	}
+
+	void fillPixels(byte *pixels, byte *expected) {
+		for (int i = 0; i < kPitch * 10; i++)
+			pixels[i] = expected[i] = _random.getRandomNumber() & 0xFF;
+	}
+
+	void compareIDCT(const int16 *block) {
+		int16 result[64], expected[64];
+		memcpy(result, block, sizeof(result));
+		memcpy(expected, block, sizeof(expected));
+
+		Video::binkIDCT(result);
+		referenceIDCT(expected, false, 0);
+		TS_ASSERT_EQUALS(memcmp(result, expected, sizeof(result)), 0);
+	}
+
+	// The scalar transform the decoder used before the vector code, over
+	// 8 values with a stride
+	static void transform(int *out, const int16 *src, int stride) {
+		const int s0 = src[0 * stride], s1 = src[1 * stride], s2 = src[2 * stride], s3 = src[3 * stride];
+		const int s4 = src[4 * stride], s5 = src[5 * stride], s6 = src[6 * stride], s7 = src[7 * stride];
+
+		const int a0 = s0 + s4;
+		const int a1 = s0 - s4;
+		const int a2 = s2 + s6;
+		const int a3 = (2896 * (s2 - s6)) >> 11;
+		const int a4 = s5 + s3;
+		const int a5 = s5 - s3;
+		const int a6 = s1 + s7;
+		const int a7 = s1 - s7;
+		const int b0 = a4 + a6;
+		const int b1 = (3784 * (a5 + a7)) >> 11;
+		const int b2 = ((-5352 * a5) >> 11) - b0 + b1;
+		const int b3 = (2896 * (a6 - a4) >> 11) - b2;
+		const int b4 = ((2217 * a7) >> 11) + b3 - b1;
+
+		out[0] = a0 + a2 + b0;
+		out[1] = a1 + a3 - a2 + b2;
+		out[2] = a1 - a3 + a2 + b3;
+		out[3] = a0 - a2 - b4;
+		out[4] = a0 - a2 + b4;
+		out[5] = a1 - a3 + a2 - b3;
+		out[6] = a1 + a3 - a2 - b2;
+		out[7] = a0 + a2 - b0;
+	}
+
+	// The result goes into the block, or into pixels when put is set
+	static void referenceIDCT(int16 *block, bool put, byte *pixels) {
+		int16 temp[64];
+		int out[8];
+
+		for (int i = 0; i < 8; i++) {
+			transform(out, block + i, 8);
+			for (int j = 0; j < 8; j++)
+				temp[j * 8 + i] = (int16)out[j];
+		}
+
+		for (int i = 0; i < 8; i++) {
+			transform(out, temp + i * 8, 1);
+			for (int j = 0; j < 8; j++) {
+				if (put)
+					pixels[i * kPitch + j] = (byte)((out[j] + 0x7F) >> 8);
+				else
+					block[i * 8 + j] = (int16)((out[j] + 0x7F) >> 8);
+			}
+		}
+	}
+
+	static void referenceAdd(byte *pixels, const int16 *block) {
+		for (int i = 0; i < 8; i++)
+			for (int j = 0; j < 8; j++)
+				pixels[i * kPitch + j] += block[i * 8 + j];
+	}
+};
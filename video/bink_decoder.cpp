@@ -44,6 +44,7 @@
 
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
+#include "video/bink_dsp.h"
 
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -192,8 +193,20 @@ const Graphics::Surface *BinkDecoder::decodeNextFrame() {
 	if (endOfVideo())
 		return 0;
 
-	VideoFrame &frame = _frames[_curFrame + 1];
+	uint32 videoPacketSize = decodeAudioPackets(_frames[_curFrame + 1]);
+	decodeVideoPacket(_curFrame + 1, videoPacketSize);
 
+	// Only the frames which are returned need to be converted
+	convertPlanes();
+
+	_curFrame++;
+	if (_curFrame == 0)
+		_startTime = g_system->getMillis();
+
+	return &_surface;
+}
+
+uint32 BinkDecoder::decodeAudioPackets(VideoFrame &frame) {
 	if (!_bink->seek(frame.offset))
 		error("Bad bink seek");
 
@@ -235,23 +248,23 @@ const Graphics::Surface *BinkDecoder::decodeNextFrame() {
 		}
 	}
 
+	return frameSize;
+}
+
+void BinkDecoder::decodeVideoPacket(uint32 frame, uint32 size) {
+	VideoFrame &video = _frames[frame];
+
 	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
+	uint32 videoPacketEnd   = _bink->pos() + size;
 
-	frame.bits =
+	video.bits =
 		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
 		    videoPacketStart, videoPacketEnd), true);
 
-	videoPacket(frame);
-
-	delete frame.bits;
-	frame.bits = 0;
-
-	_curFrame++;
-	if (_curFrame == 0)
-		_startTime = g_system->getMillis();
+	videoPacket(video);
 
-	return &_surface;
+	delete video.bits;
+	video.bits = 0;
 }
 
 void BinkDecoder::audioPacket(AudioTrack &audio) {
@@ -302,15 +315,17 @@ void BinkDecoder::videoPacket(VideoFrame &video) {
 			break;
 	}
 
+	// Swap the planes with the reference planes
+	for (int i = 0; i < 4; i++)
+		SWAP(_curPlanes[i], _oldPlanes[i]);
+}
+
+void BinkDecoder::convertPlanes() {
 	// Convert the YUV data we have to our format
 	// We're ignoring alpha for now
-	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-	Graphics::convertYUV420ToRGB(&_surface, _curPlanes[0], _curPlanes[1], _curPlanes[2],
+	assert(_oldPlanes[0] && _oldPlanes[1] && _oldPlanes[2]);
+	Graphics::convertYUV420ToRGB(&_surface, _oldPlanes[0], _oldPlanes[1], _oldPlanes[2],
 			_surface.w, _surface.h, _surface.w, _surface.w >> 1);
-
-	// And swap the planes with the reference planes
-	for (int i = 0; i < 4; i++)
-		SWAP(_curPlanes[i], _oldPlanes[i]);
 }
 
 void BinkDecoder::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
@@ -828,7 +843,7 @@ void BinkDecoder::blockScaledIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCT(block);
+	binkIDCT(block);
 
 	int16 *src   = block;
 	byte  *dest1 = ctx.dest;
@@ -963,11 +978,7 @@ void BinkDecoder::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	binkAddBlock(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::blockIntra(DecodeContext &ctx) {
@@ -978,7 +989,7 @@ void BinkDecoder::blockIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCTPut(ctx, block);
+	binkIDCTPut(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::blockFill(DecodeContext &ctx) {
@@ -999,7 +1010,7 @@ void BinkDecoder::blockInter(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, false);
 
-	IDCTAdd(ctx, block);
+	binkIDCTAdd(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::blockPattern(DecodeContext &ctx) {
@@ -1564,87 +1575,4 @@ void BinkDecoder::floatToInt16Interleave(int16 *dst, const float **src, uint32 l
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-    const int a0 = (src)[s0] + (src)[s4]; \
-    const int a1 = (src)[s0] - (src)[s4]; \
-    const int a2 = (src)[s2] + (src)[s6]; \
-    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-    const int a4 = (src)[s5] + (src)[s3]; \
-    const int a5 = (src)[s5] - (src)[s3]; \
-    const int a6 = (src)[s1] + (src)[s7]; \
-    const int a7 = (src)[s1] - (src)[s7]; \
-    const int b0 = a4 + a6; \
-    const int b1 = (A3*(a5 + a7)) >> 11; \
-    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-    (dest)[d0] = munge(a0+a2   +b0); \
-    (dest)[d1] = munge(a1+a3-a2+b2); \
-    (dest)[d2] = munge(a1-a3+a2+b3); \
-    (dest)[d3] = munge(a0-a2   -b4); \
-    (dest)[d4] = munge(a0-a2   +b4); \
-    (dest)[d5] = munge(a1-a3+a2-b3); \
-    (dest)[d6] = munge(a1+a3-a2-b2); \
-    (dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int16 *dest, const int16 *src)
-{
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::IDCT(int16 *block) {
-	int i;
-	int16 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void BinkDecoder::IDCTAdd(DecodeContext &ctx, int16 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void BinkDecoder::IDCTPut(DecodeContext &ctx, int16 *block) {
-	int i;
-	int16 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 } // End of namespace Video
@@ -256,10 +256,23 @@ protected:
 	/** Initialize the Huffman decoders. */
 	void initHuffman();
 
+	/**
+	 * Seek to a frame and decode its packet for the audio track which is
+	 * played. Returns the size of the video packet which follows.
+	 */
+	uint32 decodeAudioPackets(VideoFrame &frame);
+	/** Decode the video packet of a frame, starting at the current stream position. */
+	virtual void decodeVideoPacket(uint32 frame, uint32 size);
+
 	/** Decode an audio packet. */
 	void audioPacket(AudioTrack &audio);
-	/** Decode a video packet. */
-	virtual void videoPacket(VideoFrame &video);
+	/**
+	 * Decode the planes of a video packet. They end up in the reference
+	 * planes, _oldPlanes, without being converted into the surface.
+	 */
+	void videoPacket(VideoFrame &video);
+	/** Convert the last decoded planes into the surface. */
+	virtual void convertPlanes();
 
 	/** Decode a plane. */
 	void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
@@ -323,11 +336,6 @@ protected:
 
 	void floatToInt16Interleave(int16 *dst, const float **src, uint32 length, uint8 channels);
 
-	// Bink video IDCT
-	void IDCT(int16 *block);
-	void IDCTPut(DecodeContext &ctx, int16 *block);
-	void IDCTAdd(DecodeContext &ctx, int16 *block);
-
 	/** Start playing the audio track */
 	void startAudio();
 	/** Stop playing the audio track */
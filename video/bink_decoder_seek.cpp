@@ -30,40 +30,134 @@
 
 #include "video/bink_decoder_seek.h"
 
-static const uint32 kBIKiID = MKTAG('B', 'I', 'K', 'i');
-
 namespace Video {
 
-void SeekableBinkDecoder::videoPacket(VideoFrame &video) {
-	assert(video.bits);
+SeekableBinkDecoder::SeekableBinkDecoder() :
+		_frameCacheStart(0),
+		_frameCacheBytes(0),
+		_frameCacheMaxBytes(0) {
+}
+
+SeekableBinkDecoder::~SeekableBinkDecoder() {
+	clearFrameCache();
+}
 
-	if (_hasAlpha) {
-		if (_id == kBIKiID)
-			video.bits->skip(32);
+void SeekableBinkDecoder::close() {
+	clearFrameCache();
+	BinkDecoder::close();
+}
+
+void SeekableBinkDecoder::setFrameCache(uint32 firstFrame, uint32 lastFrame, uint32 maxBytes) {
+	if (firstFrame >= _frames.size() || lastFrame < firstFrame)
+		return;
 
-		decodePlane(video, 3, false);
+	lastFrame = MIN<uint32>(lastFrame, _frames.size() - 1);
+
+	// Keep what is already there when the range stays the same
+	if (!_frameCache.empty() && _frameCacheStart == firstFrame
+			&& _frameCache.size() == lastFrame - firstFrame + 1) {
+		_frameCacheMaxBytes = maxBytes;
+		return;
 	}
 
-	if (_id == kBIKiID)
-		video.bits->skip(32);
+	clearFrameCache();
+
+	_frameCacheStart = firstFrame;
+	_frameCacheMaxBytes = maxBytes;
+	_frameCache.resize(lastFrame - firstFrame + 1);
+	for (uint32 i = 0; i < _frameCache.size(); i++)
+		_frameCache[i] = 0;
+}
 
-	for (int i = 0; i < 3; i++) {
-		int planeIdx = ((i == 0) || !_swapPlanes) ? i : (i ^ 3);
+void SeekableBinkDecoder::clearFrameCache() {
+	for (uint32 i = 0; i < _frameCache.size(); i++)
+		delete[] _frameCache[i];
 
-		decodePlane(video, planeIdx, i != 0);
+	_frameCache.clear();
+	_frameCacheBytes = 0;
+}
 
-		if (video.bits->pos() >= video.bits->size())
-			break;
+uint32 SeekableBinkDecoder::getPlaneSize(int plane) const {
+	// The planes are allocated with some extra space, see loadStream
+	uint32 width  = _surface.w + 32;
+	uint32 height = _surface.h + 32;
+
+	if (plane == 1 || plane == 2)
+		return (width >> 1) * (height >> 1);
+
+	return width * height;
+}
+
+uint32 SeekableBinkDecoder::getCachedFrameSize() const {
+	// The alpha plane is never written to when there is none
+	int planeCount = _hasAlpha ? 4 : 3;
+
+	uint32 size = 0;
+	for (int i = 0; i < planeCount; i++)
+		size += getPlaneSize(i);
+	return size;
+}
+
+byte *SeekableBinkDecoder::getCachedFrame(uint32 frame) const {
+	if (frame < _frameCacheStart || frame - _frameCacheStart >= _frameCache.size())
+		return 0;
+
+	return _frameCache[frame - _frameCacheStart];
+}
+
+void SeekableBinkDecoder::storeFrame(uint32 frame) {
+	if (frame < _frameCacheStart || frame - _frameCacheStart >= _frameCache.size())
+		return;
+
+	if (_frameCache[frame - _frameCacheStart])
+		return;
+
+	int planeCount = _hasAlpha ? 4 : 3;
+	uint32 size = getCachedFrameSize();
+
+	// Frames are not evicted: a looping movie would always miss the
+	// frame it needs next, so the first frames visited keep their place
+	if (_frameCacheBytes + size > _frameCacheMaxBytes)
+		return;
+
+	byte *planes = new byte[size];
+	byte *dst = planes;
+	for (int i = 0; i < planeCount; i++) {
+		memcpy(dst, _oldPlanes[i], getPlaneSize(i));
+		dst += getPlaneSize(i);
+	}
+
+	_frameCache[frame - _frameCacheStart] = planes;
+	_frameCacheBytes += size;
+}
+
+bool SeekableBinkDecoder::restoreFrame(uint32 frame) {
+	const byte *src = getCachedFrame(frame);
+	if (!src)
+		return false;
+
+	int planeCount = _hasAlpha ? 4 : 3;
+	for (int i = 0; i < planeCount; i++) {
+		memcpy(_oldPlanes[i], src, getPlaneSize(i));
+		src += getPlaneSize(i);
 	}
 
+	return true;
+}
+
+void SeekableBinkDecoder::decodeVideoPacket(uint32 frame, uint32 size) {
+	if (restoreFrame(frame))
+		return;
+
+	BinkDecoder::decodeVideoPacket(frame, size);
+	storeFrame(frame);
+}
+
+void SeekableBinkDecoder::convertPlanes() {
 	// Convert the YUV data we have to our format
-	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-	Graphics::convertYUVA420ToRGBA(&_surface, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
+	assert(_oldPlanes[0] && _oldPlanes[1] && _oldPlanes[2] && _oldPlanes[3]);
+	Graphics::convertYUVA420ToRGBA(&_surface, _oldPlanes[0], _oldPlanes[1], _oldPlanes[2], _oldPlanes[3],
 			_surface.w, _surface.h, _surface.w, _surface.w >> 1);
-
-	// And swap the planes with the reference planes
-	for (int i = 0; i < 4; i++)
-		SWAP(_curPlanes[i], _oldPlanes[i]);
 }
 
 uint32 SeekableBinkDecoder::getDuration() const
@@ -92,8 +186,16 @@ void SeekableBinkDecoder::seekToFrame(uint32 frame) {
 	// Stop all audio (for now)
 	stopAudio();
 
-	// Track down the keyframe
-	_curFrame = findKeyFrame(frame) - 1;
+	// Track down the keyframe, or a closer frame from the cache
+	uint32 keyFrame = findKeyFrame(frame);
+	_curFrame = keyFrame - 1;
+	for (uint32 i = frame; i > keyFrame; i--) {
+		if (restoreFrame(i - 1)) {
+			_curFrame = i - 1;
+			break;
+		}
+	}
+
 	while (_curFrame < (int32)frame - 1)
 		skipNextFrame();
 
@@ -145,17 +247,7 @@ void SeekableBinkDecoder::skipNextFrame() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits =
-		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-		    videoPacketStart, videoPacketEnd), true);
-
-	videoPacket(frame);
-
-	delete frame.bits;
-	frame.bits = 0;
+	decodeVideoPacket(_curFrame + 1, frameSize);
 
 	_curFrame++;
 	if (_curFrame == 0)
@@ -32,19 +32,58 @@ namespace Video {
 class SeekableBinkDecoder: public Video::BinkDecoder,
 		public Video::SeekableVideoDecoder {
 public:
+	SeekableBinkDecoder();
+	~SeekableBinkDecoder();
+
+	// VideoDecoder API
+	void close();
+
 	// SeekableVideoDecoder API
 	void seekToFrame(uint32 frame);
 	void seekToTime(Audio::Timestamp time);
 	uint32 getDuration() const;
 
+	// Bink specific
+	static const uint32 kDefaultFrameCacheSize = 16 * 1024 * 1024;
+
+	/**
+	 * Keep the decoded planes of the frames from firstFrame to lastFrame,
+	 * so that looping or scrubbing over them does not decode again from
+	 * the keyframe. At most maxBytes are used: the frames which do not
+	 * fit anymore are decoded as usual.
+	 */
+	void setFrameCache(uint32 firstFrame, uint32 lastFrame, uint32 maxBytes = kDefaultFrameCacheSize);
+	/** Drop the cached frames and stop caching */
+	void clearFrameCache();
+	/** Memory a cached frame of the loaded video takes, in bytes */
+	uint32 getCachedFrameSize() const;
+
 protected:
-	/** Decode a video packet. */
-	void videoPacket(VideoFrame &video);
-	
+	Common::Array<byte *> _frameCache; ///< Saved planes of the frames from _frameCacheStart, or 0
+	uint32 _frameCacheStart;
+	uint32 _frameCacheBytes;           ///< Memory used by the saved planes
+	uint32 _frameCacheMaxBytes;
+
+	/** Decode the video packet of a frame, or restore its planes from the cache */
+	void decodeVideoPacket(uint32 frame, uint32 size);
+
+	/** Size of one of the allocated planes, in bytes */
+	uint32 getPlaneSize(int plane) const;
+	/** The saved planes of a frame, or 0 when it is not cached */
+	byte *getCachedFrame(uint32 frame) const;
+	/** Save the last decoded planes, if the frame should be cached and fits */
+	void storeFrame(uint32 frame);
+	/** Make the saved planes of a frame the reference planes */
+	bool restoreFrame(uint32 frame);
+
+
+	/** Convert the last decoded planes, with alpha, into the surface. */
+	void convertPlanes();
+
 	/** Find the keyframe needed to decode a frame */
 	uint32 findKeyFrame(uint32 frame) const;
 
-	/** Skip the next frame */
+	/** Decode the next frame without converting it, on the way to a seek target */
 	void skipNextFrame();
 };
 
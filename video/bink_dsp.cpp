@@ -0,0 +1,430 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Based on the Bink DSP functions of FFmpeg
+
+#include "video/bink_dsp.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define USE_SSE2_BINK
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON_BINK
+#endif
+
+namespace Video {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#if defined(USE_SSE2_BINK)
+
+// The vector code does the same integer operations as IDCT_TRANSFORM below,
+// on four columns or rows at a time, in 32-bit lanes
+
+/** The low 32 bits of the products, as pmulld is only in SSE4.1 */
+static inline __m128i mul32(__m128i a, int c) {
+	const __m128i b = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd  = _mm_mul_epu32(_mm_srli_si128(a, 4), b);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline void idctTransform(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mul32(_mm_sub_epi32(s[2], s[6]), A1), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mul32(_mm_add_epi32(a5, a7), A3), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mul32(a5, A4), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mul32(_mm_sub_epi32(a6, a4), A1), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mul32(a7, A2), 11), b3), b1);
+
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_sub_epi32(a0, a2);
+
+	d[0] = _mm_add_epi32(c0, b0);
+	d[1] = _mm_add_epi32(c1, b2);
+	d[2] = _mm_add_epi32(c2, b3);
+	d[3] = _mm_sub_epi32(c3, b4);
+	d[4] = _mm_add_epi32(c3, b4);
+	d[5] = _mm_sub_epi32(c2, b3);
+	d[6] = _mm_sub_epi32(c1, b2);
+	d[7] = _mm_sub_epi32(c0, b0);
+}
+
+/** Narrow to 16 bits, wrapping around like the stores into int16 */
+static inline __m128i packWrap(__m128i lo, __m128i hi) {
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+static inline void transpose(__m128i *r) {
+	const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	r[0] = _mm_unpacklo_epi64(b0, b4);
+	r[1] = _mm_unpackhi_epi64(b0, b4);
+	r[2] = _mm_unpacklo_epi64(b1, b5);
+	r[3] = _mm_unpackhi_epi64(b1, b5);
+	r[4] = _mm_unpacklo_epi64(b2, b6);
+	r[5] = _mm_unpackhi_epi64(b2, b6);
+	r[6] = _mm_unpacklo_epi64(b3, b7);
+	r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/**
+ * One pass of the transform, over the columns of the 8 rows in r. The
+ * result is transposed, so that the second pass works on the rows.
+ */
+static inline void idctPass(__m128i *r, bool isRowPass) {
+	__m128i s[8], lo[8], hi[8];
+
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_srai_epi32(_mm_unpacklo_epi16(r[i], r[i]), 16);
+	idctTransform(lo, s);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_srai_epi32(_mm_unpackhi_epi16(r[i], r[i]), 16);
+	idctTransform(hi, s);
+
+	if (isRowPass) {
+		const __m128i round = _mm_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++) {
+			lo[i] = _mm_srai_epi32(_mm_add_epi32(lo[i], round), 8);
+			hi[i] = _mm_srai_epi32(_mm_add_epi32(hi[i], round), 8);
+		}
+	}
+
+	for (int i = 0; i < 8; i++)
+		r[i] = packWrap(lo[i], hi[i]);
+
+	transpose(r);
+}
+
+/** The inverse DCT of a block, leaving the rows of the result in r */
+static inline void idct(__m128i *r, const int16 *block) {
+	for (int i = 0; i < 8; i++)
+		r[i] = _mm_loadu_si128((const __m128i *)(block + i * 8));
+
+	idctPass(r, false);
+	idctPass(r, true);
+}
+
+/** Write or add the low bytes of 8 rows of 16-bit values */
+static inline void storeRows(byte *dest, uint32 pitch, const __m128i *r, bool add) {
+	const __m128i mask = _mm_set1_epi16(0xFF);
+
+	for (int i = 0; i < 8; i += 2, dest += pitch * 2) {
+		__m128i v = _mm_packus_epi16(_mm_and_si128(r[i], mask), _mm_and_si128(r[i + 1], mask));
+		if (add) {
+			const __m128i d = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)dest),
+			                                     _mm_loadl_epi64((const __m128i *)(dest + pitch)));
+			v = _mm_add_epi8(v, d);
+		}
+
+		_mm_storel_epi64((__m128i *)dest, v);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_srli_si128(v, 8));
+	}
+}
+
+void binkIDCT(int16 *block) {
+	__m128i r[8];
+	idct(r, block);
+
+	for (int i = 0; i < 8; i++)
+		_mm_storeu_si128((__m128i *)(block + i * 8), r[i]);
+}
+
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *block) {
+	__m128i r[8];
+	idct(r, block);
+	storeRows(dest, pitch, r, false);
+}
+
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block) {
+	__m128i r[8];
+	idct(r, block);
+	storeRows(dest, pitch, r, true);
+}
+
+void binkAddBlock(byte *dest, uint32 pitch, const int16 *block) {
+	__m128i r[8];
+	for (int i = 0; i < 8; i++)
+		r[i] = _mm_loadu_si128((const __m128i *)(block + i * 8));
+
+	storeRows(dest, pitch, r, true);
+}
+
+#elif defined(USE_NEON_BINK)
+
+// The vector code does the same integer operations as IDCT_TRANSFORM below,
+// on four columns or rows at a time, in 32-bit lanes
+
+static inline void idctTransform(int32x4_t *d, const int32x4_t *s) {
+	const int32x4_t a0 = vaddq_s32(s[0], s[4]);
+	const int32x4_t a1 = vsubq_s32(s[0], s[4]);
+	const int32x4_t a2 = vaddq_s32(s[2], s[6]);
+	const int32x4_t a3 = vshrq_n_s32(vmulq_n_s32(vsubq_s32(s[2], s[6]), A1), 11);
+	const int32x4_t a4 = vaddq_s32(s[5], s[3]);
+	const int32x4_t a5 = vsubq_s32(s[5], s[3]);
+	const int32x4_t a6 = vaddq_s32(s[1], s[7]);
+	const int32x4_t a7 = vsubq_s32(s[1], s[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = vshrq_n_s32(vmulq_n_s32(vaddq_s32(a5, a7), A3), 11);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(vshrq_n_s32(vmulq_n_s32(a5, A4), 11), b0), b1);
+	const int32x4_t b3 = vsubq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(a6, a4), A1), 11), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(vshrq_n_s32(vmulq_n_s32(a7, A2), 11), b3), b1);
+
+	const int32x4_t c0 = vaddq_s32(a0, a2);
+	const int32x4_t c1 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t c2 = vaddq_s32(vsubq_s32(a1, a3), a2);
+	const int32x4_t c3 = vsubq_s32(a0, a2);
+
+	d[0] = vaddq_s32(c0, b0);
+	d[1] = vaddq_s32(c1, b2);
+	d[2] = vaddq_s32(c2, b3);
+	d[3] = vsubq_s32(c3, b4);
+	d[4] = vaddq_s32(c3, b4);
+	d[5] = vsubq_s32(c2, b3);
+	d[6] = vsubq_s32(c1, b2);
+	d[7] = vsubq_s32(c0, b0);
+}
+
+static inline int16x8_t combine32(int32x4_t lo, int32x4_t hi, bool high) {
+	const int16x8_t l = vreinterpretq_s16_s32(lo);
+	const int16x8_t h = vreinterpretq_s16_s32(hi);
+	if (high)
+		return vcombine_s16(vget_high_s16(l), vget_high_s16(h));
+	return vcombine_s16(vget_low_s16(l), vget_low_s16(h));
+}
+
+static inline void transpose(int16x8_t *r) {
+	const int16x8x2_t t01 = vtrnq_s16(r[0], r[1]);
+	const int16x8x2_t t23 = vtrnq_s16(r[2], r[3]);
+	const int16x8x2_t t45 = vtrnq_s16(r[4], r[5]);
+	const int16x8x2_t t67 = vtrnq_s16(r[6], r[7]);
+
+	const int32x4x2_t u02 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[0]), vreinterpretq_s32_s16(t23.val[0]));
+	const int32x4x2_t u13 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[1]), vreinterpretq_s32_s16(t23.val[1]));
+	const int32x4x2_t u46 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[0]), vreinterpretq_s32_s16(t67.val[0]));
+	const int32x4x2_t u57 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[1]), vreinterpretq_s32_s16(t67.val[1]));
+
+	r[0] = combine32(u02.val[0], u46.val[0], false);
+	r[1] = combine32(u13.val[0], u57.val[0], false);
+	r[2] = combine32(u02.val[1], u46.val[1], false);
+	r[3] = combine32(u13.val[1], u57.val[1], false);
+	r[4] = combine32(u02.val[0], u46.val[0], true);
+	r[5] = combine32(u13.val[0], u57.val[0], true);
+	r[6] = combine32(u02.val[1], u46.val[1], true);
+	r[7] = combine32(u13.val[1], u57.val[1], true);
+}
+
+/**
+ * One pass of the transform, over the columns of the 8 rows in r. The
+ * result is transposed, so that the second pass works on the rows.
+ */
+static inline void idctPass(int16x8_t *r, bool isRowPass) {
+	int32x4_t s[8], lo[8], hi[8];
+
+	for (int i = 0; i < 8; i++)
+		s[i] = vmovl_s16(vget_low_s16(r[i]));
+	idctTransform(lo, s);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = vmovl_s16(vget_high_s16(r[i]));
+	idctTransform(hi, s);
+
+	if (isRowPass) {
+		const int32x4_t round = vdupq_n_s32(0x7F);
+		for (int i = 0; i < 8; i++) {
+			lo[i] = vshrq_n_s32(vaddq_s32(lo[i], round), 8);
+			hi[i] = vshrq_n_s32(vaddq_s32(hi[i], round), 8);
+		}
+	}
+
+	// Narrowing keeps the low bits, like the stores into int16
+	for (int i = 0; i < 8; i++)
+		r[i] = vcombine_s16(vmovn_s32(lo[i]), vmovn_s32(hi[i]));
+
+	transpose(r);
+}
+
+/** The inverse DCT of a block, leaving the rows of the result in r */
+static inline void idct(int16x8_t *r, const int16 *block) {
+	for (int i = 0; i < 8; i++)
+		r[i] = vld1q_s16(block + i * 8);
+
+	idctPass(r, false);
+	idctPass(r, true);
+}
+
+/** Write or add the low bytes of 8 rows of 16-bit values */
+static inline void storeRows(byte *dest, uint32 pitch, const int16x8_t *r, bool add) {
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		uint8x8_t v = vmovn_u16(vreinterpretq_u16_s16(r[i]));
+		if (add)
+			v = vadd_u8(v, vld1_u8(dest));
+
+		vst1_u8(dest, v);
+	}
+}
+
+void binkIDCT(int16 *block) {
+	int16x8_t r[8];
+	idct(r, block);
+
+	for (int i = 0; i < 8; i++)
+		vst1q_s16(block + i * 8, r[i]);
+}
+
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *block) {
+	int16x8_t r[8];
+	idct(r, block);
+	storeRows(dest, pitch, r, false);
+}
+
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block) {
+	int16x8_t r[8];
+	idct(r, block);
+	storeRows(dest, pitch, r, true);
+}
+
+void binkAddBlock(byte *dest, uint32 pitch, const int16 *block) {
+	int16x8_t r[8];
+	for (int i = 0; i < 8; i++)
+		r[i] = vld1q_s16(block + i * 8);
+
+	storeRows(dest, pitch, r, true);
+}
+
+#else
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int16 *dest, const int16 *src)
+{
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+void binkIDCT(int16 *block) {
+	int i;
+	int16 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *block) {
+	int i;
+	int16 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block) {
+	binkIDCT(block);
+	binkAddBlock(dest, pitch, block);
+}
+
+void binkAddBlock(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+#endif
+
+} // End of namespace Video
@@ -0,0 +1,56 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef VIDEO_BINK_DSP_H
+#define VIDEO_BINK_DSP_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * @name Bink video block kernels
+ *
+ * The inverse DCT and the residue of the Bink video codec, over 8x8
+ * blocks. They use SSE2 or NEON where the compiler targets them, and give
+ * exactly the same results as the plain C++ versions, including where
+ * the values wrap around.
+ * @{
+ */
+
+/** Inverse DCT of a block, in place. */
+void binkIDCT(int16 *block);
+
+/** Inverse DCT of a block, written into 8x8 pixels. */
+void binkIDCTPut(byte *dest, uint32 pitch, const int16 *block);
+
+/** Inverse DCT of a block, added to 8x8 pixels. The block is overwritten. */
+void binkIDCTAdd(byte *dest, uint32 pitch, int16 *block);
+
+/** Add a block of residue to 8x8 pixels. */
+void binkAddBlock(byte *dest, uint32 pitch, const int16 *block);
+
+/** @} */
+
+} // End of namespace Video
+
+#endif // VIDEO_BINK_DSP_H
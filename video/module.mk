@@ -6,7 +6,9 @@ MODULE_OBJS := \
 ifdef USE_BINK
 MODULE_OBJS += \
 	bink_decoder.o \
-	bink_decoder_seek.o
+	bink_decoder_seek.o \
+	bink_dsp.o \
+	threaded_video_decoder.o
 endif
 
 # Include common rules
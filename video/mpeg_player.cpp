@@ -88,6 +88,8 @@
 #include "common/system.h"
 #include "common/util.h"
 
+#include "graphics/yuv_to_rgb.h"
+
 namespace Video {
 
 BaseAnimationState::BaseAnimationState(OSystem *sys, int width, int height)
@@ -293,54 +295,9 @@ void BaseAnimationState::plotYUV(int width, int height, byte *const *dat) {
 }
 
 void BaseAnimationState::plotYUV1x(int width, int height, byte *const *dat) {
-	byte *lum = dat[0];
-	byte *cr = dat[2];
-	byte *cb = dat[1];
-
-	byte *lum2 = lum + width;
-
-	int16 cr_r;
-	int16 crb_g;
-	int16 cb_b;
-
-	OverlayColor *row1 = _overlay;
-	OverlayColor *row2 = row1 + _movieWidth;
-
-	int x;
-
-	for (; height > 0; height -= 2) {
-		OverlayColor *r1 = row1;
-		OverlayColor *r2 = row2;
-
-		for (x = width; x > 0; x -= 2) {
-			register OverlayColor *L;
-
-			cr_r  = _colorTab[*cr + 0 * 256];
-			crb_g = _colorTab[*cr + 1 * 256] + _colorTab[*cb + 2 * 256];
-			cb_b  = _colorTab[*cb + 3 * 256];
-			++cr;
-			++cb;
-
-			L = &_rgbToPix[*lum++];
-			*r1++ = L[cr_r] | L[crb_g] | L[cb_b];
-
-			L = &_rgbToPix[*lum++];
-			*r1++ = L[cr_r] | L[crb_g] | L[cb_b];
-
-			// Now, do second row.
-
-			L = &_rgbToPix[*lum2++];
-			*r2++ = L[cr_r] | L[crb_g] | L[cb_b];
-
-			L = &_rgbToPix[*lum2++];
-			*r2++ = L[cr_r] | L[crb_g] | L[cb_b];
-		}
-
-		lum  += width;
-		lum2 += width;
-		row1 += 2 * _movieWidth;
-		row2 += 2 * _movieWidth;
-	}
+	// dat holds the Y, U and V planes, the chroma ones at half the width
+	Graphics::convertYUV420ToRGB((byte *)_overlay, _movieWidth * sizeof(OverlayColor), _overlayFormat,
+			dat[0], dat[1], dat[2], width, height, width, width >> 1);
 }
 
 void BaseAnimationState::plotYUV2x(int width, int height, byte *const *dat) {
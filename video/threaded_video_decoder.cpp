@@ -0,0 +1,320 @@
+/* Residual - A 3D game interpreter
+ *
+ * Residual is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/system.h"
+#include "common/timer.h"
+
+#include "graphics/surface.h"
+
+#include "video/threaded_video_decoder.h"
+
+#ifdef USE_BINK
+
+namespace Video {
+
+/** How often the decoding timer runs, in microseconds */
+#define THREADED_VIDEO_INTERVAL 10000
+
+// A timer proc can only be installed once, so all the decoders share it.
+// It is installed along with the list and its mutex for the first loaded
+// decoder, and removed along with them when the last one is closed.
+static Common::Array<ThreadedVideoDecoder *> *threadedVideoDecoders = 0;
+static Common::Mutex *threadedVideoMutex = 0;
+
+/**
+ * The list stays locked while the frames are decoded, so that a decoder
+ * is never deleted under the timer. One frame is decoded per decoder and
+ * pass, which keeps the wait of close() short.
+ */
+static void threadedVideoHandler(void *) {
+	Common::StackLock lock(*threadedVideoMutex);
+	for (uint i = 0; i < threadedVideoDecoders->size(); i++)
+		(*threadedVideoDecoders)[i]->decodeAhead();
+}
+
+static void registerThreadedVideo(ThreadedVideoDecoder *decoder) {
+	if (!threadedVideoDecoders) {
+		threadedVideoDecoders = new Common::Array<ThreadedVideoDecoder *>();
+		threadedVideoMutex = new Common::Mutex();
+		g_system->getTimerManager()->installTimerProc(&threadedVideoHandler, THREADED_VIDEO_INTERVAL, 0, "threadedVideo");
+	}
+
+	Common::StackLock lock(*threadedVideoMutex);
+	threadedVideoDecoders->push_back(decoder);
+}
+
+static void unregisterThreadedVideo(ThreadedVideoDecoder *decoder) {
+	if (!threadedVideoDecoders)
+		return;
+
+	bool last;
+	{
+		Common::StackLock lock(*threadedVideoMutex);
+		for (uint i = 0; i < threadedVideoDecoders->size(); i++) {
+			if ((*threadedVideoDecoders)[i] == decoder) {
+				threadedVideoDecoders->remove_at(i);
+				break;
+			}
+		}
+		last = threadedVideoDecoders->empty();
+	}
+
+	if (!last)
+		return;
+
+	// Once removed, the timer is not running anymore
+	g_system->getTimerManager()->removeTimerProc(&threadedVideoHandler);
+	delete threadedVideoDecoders;
+	threadedVideoDecoders = 0;
+	delete threadedVideoMutex;
+	threadedVideoMutex = 0;
+}
+
+ThreadedVideoDecoder::ThreadedVideoDecoder(BinkDecoder *decoder, DisposeAfterUse::Flag disposeAfterUse, uint queueLength) {
+	init(decoder, 0, disposeAfterUse, queueLength);
+}
+
+ThreadedVideoDecoder::ThreadedVideoDecoder(SeekableBinkDecoder *decoder, DisposeAfterUse::Flag disposeAfterUse, uint queueLength) {
+	init(decoder, decoder, disposeAfterUse, queueLength);
+}
+
+void ThreadedVideoDecoder::init(BinkDecoder *decoder, SeekableBinkDecoder *seekable, DisposeAfterUse::Flag disposeAfterUse, uint queueLength) {
+	assert(decoder);
+	assert(queueLength > 0);
+
+	_decoder = decoder;
+	_seekable = seekable;
+	_disposeAfterUse = disposeAfterUse;
+	_queueLength = queueLength;
+	_displayedSurface = 0;
+	_decodingAhead = false;
+	_frameCacheFirst = _frameCacheLast = _frameCacheMaxBytes = 0;
+}
+
+ThreadedVideoDecoder::~ThreadedVideoDecoder() {
+	close();
+
+	if (_disposeAfterUse == DisposeAfterUse::YES)
+		delete _decoder;
+}
+
+bool ThreadedVideoDecoder::loadStream(Common::SeekableReadStream *stream) {
+	close();
+	return startDecoding(_decoder->loadStream(stream));
+}
+
+bool ThreadedVideoDecoder::loadStream(Common::SeekableReadStream *stream, const Graphics::PixelFormat &format) {
+	close();
+	return startDecoding(_decoder->loadStream(stream, format));
+}
+
+bool ThreadedVideoDecoder::startDecoding(bool loaded) {
+	if (!loaded)
+		return false;
+
+	// One more surface than there are queued frames, for the displayed one
+	for (uint i = 0; i <= _queueLength; i++) {
+		Graphics::Surface *surface = new Graphics::Surface();
+		surface->create(_decoder->getWidth(), _decoder->getHeight(), _decoder->getPixelFormat());
+		_surfaces.push_back(surface);
+		_freeSurfaces.push_back(surface);
+	}
+
+	registerThreadedVideo(this);
+	return true;
+}
+
+void ThreadedVideoDecoder::close() {
+	// Waits for the decoding timer to be done with this decoder
+	unregisterThreadedVideo(this);
+
+	_decodingAhead = false;
+	_decoder->close();
+	freeSurfaces();
+	_frameCacheFirst = _frameCacheLast = _frameCacheMaxBytes = 0;
+
+	reset();
+}
+
+void ThreadedVideoDecoder::freeSurfaces() {
+	for (uint i = 0; i < _surfaces.size(); i++) {
+		_surfaces[i]->free();
+		delete _surfaces[i];
+	}
+
+	_surfaces.clear();
+	_freeSurfaces.clear();
+	_readyFrames.clear();
+	_displayedSurface = 0;
+}
+
+bool ThreadedVideoDecoder::hasReadyFrame() const {
+	Common::StackLock lock(_queueMutex);
+	return !_readyFrames.empty();
+}
+
+bool ThreadedVideoDecoder::needsUpdate() const {
+	if (!VideoDecoder::needsUpdate())
+		return false;
+
+	// Without decoding ahead, decodeNextFrame() decodes synchronously
+	return !_decodingAhead || hasReadyFrame();
+}
+
+const Graphics::Surface *ThreadedVideoDecoder::decodeNextFrame() {
+	if (endOfVideo())
+		return 0;
+
+	const Graphics::Surface *surface = popReadyFrame();
+	if (surface)
+		return surface;
+
+	// Nothing is ready just after loading or seeking, or when the timer
+	// falls behind
+	Common::StackLock lock(_decoderMutex);
+	if (!hasReadyFrame())
+		decodeFrame();
+
+	surface = popReadyFrame();
+	updateDecodingAhead();
+
+	return surface;
+}
+
+const Graphics::Surface *ThreadedVideoDecoder::popReadyFrame() {
+	Common::StackLock lock(_queueMutex);
+	if (_readyFrames.empty())
+		return 0;
+
+	QueuedFrame next = _readyFrames.pop();
+	if (_displayedSurface)
+		_freeSurfaces.push_back(_displayedSurface);
+
+	_displayedSurface = next.surface;
+	_curFrame = next.frame;
+
+	return _displayedSurface;
+}
+
+void ThreadedVideoDecoder::decodeAhead() {
+	if (!_decodingAhead)
+		return;
+
+	Common::StackLock lock(_decoderMutex);
+	if (_decodingAhead)
+		decodeFrame();
+}
+
+bool ThreadedVideoDecoder::decodeFrame() {
+	if (_decoder->endOfVideo())
+		return false;
+
+	Graphics::Surface *surface;
+	{
+		Common::StackLock lock(_queueMutex);
+		if (_freeSurfaces.empty())
+			return false;
+
+		surface = _freeSurfaces.back();
+		_freeSurfaces.pop_back();
+	}
+
+	const Graphics::Surface *frame = _decoder->decodeNextFrame();
+
+	Common::StackLock lock(_queueMutex);
+	if (!frame) {
+		_freeSurfaces.push_back(surface);
+		return false;
+	}
+
+	for (int i = 0; i < frame->h; i++)
+		memcpy(surface->getBasePtr(0, i), frame->getBasePtr(0, i), frame->w * frame->format.bytesPerPixel);
+
+	QueuedFrame queued;
+	queued.surface = surface;
+	queued.frame = _decoder->getCurFrame();
+	_readyFrames.push(queued);
+
+	return true;
+}
+
+void ThreadedVideoDecoder::flushQueue() {
+	Common::StackLock lock(_queueMutex);
+	while (!_readyFrames.empty())
+		_freeSurfaces.push_back(_readyFrames.pop().surface);
+}
+
+void ThreadedVideoDecoder::updateDecodingAhead() {
+	// The clock of the wrapped decoder starts with the first frame, which
+	// is therefore decoded synchronously
+	_decodingAhead = isVideoLoaded() && _curFrame >= 0 && !isPaused();
+}
+
+void ThreadedVideoDecoder::pauseVideoIntern(bool pause) {
+	Common::StackLock lock(_decoderMutex);
+	_decoder->pauseVideo(pause);
+	updateDecodingAhead();
+}
+
+void ThreadedVideoDecoder::seekToFrame(uint32 frame) {
+	assert(_seekable);
+
+	// The next frame is either ready, or decoded next
+	if ((int32)frame == _curFrame + 1)
+		return;
+
+	Common::StackLock lock(_decoderMutex);
+	flushQueue();
+	_seekable->seekToFrame(frame);
+	_curFrame = _seekable->getCurFrame();
+	updateDecodingAhead();
+}
+
+void ThreadedVideoDecoder::seekToTime(Audio::Timestamp time) {
+	// The same rounding as SeekableBinkDecoder
+	Common::Rational frame = time.msecs() * getFrameRate() / 1000;
+	seekToFrame(frame.toInt());
+}
+
+uint32 ThreadedVideoDecoder::getDuration() const {
+	assert(_seekable);
+	return _seekable->getDuration();
+}
+
+void ThreadedVideoDecoder::setFrameCache(uint32 firstFrame, uint32 lastFrame, uint32 maxBytes) {
+	assert(_seekable);
+
+	// Called on every update, so only wait for the decoder on a change
+	if (firstFrame == _frameCacheFirst && lastFrame == _frameCacheLast && maxBytes == _frameCacheMaxBytes)
+		return;
+
+	_frameCacheFirst = firstFrame;
+	_frameCacheLast = lastFrame;
+	_frameCacheMaxBytes = maxBytes;
+
+	Common::StackLock lock(_decoderMutex);
+	_seekable->setFrameCache(firstFrame, lastFrame, maxBytes);
+}
+
+} // End of namespace Video
+
+#endif // USE_BINK
@@ -0,0 +1,157 @@
+/* Residual - A 3D game interpreter
+ *
+ * Residual is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef VIDEO_THREADED_VIDEO_DECODER_H
+#define VIDEO_THREADED_VIDEO_DECODER_H
+
+#include "video/bink_decoder_seek.h"
+
+#ifdef USE_BINK
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/queue.h"
+#include "common/types.h"
+
+namespace Video {
+
+/**
+ * A wrapper around a Bink decoder which decodes the next frames ahead of
+ * time, from a timer proc, into a queue of surfaces. decodeNextFrame() then
+ * only picks up a frame which is ready, so that a heavy keyframe does not
+ * land on whoever draws the video.
+ *
+ * The first frame after loading or seeking is decoded synchronously, as
+ * the clock of the video starts with it. After that, needsUpdate() only
+ * returns true once the next frame is ready.
+ *
+ * Seeking flushes the queue. While paused, nothing more is decoded, but
+ * the frames which are ready are kept.
+ *
+ * The surface returned by decodeNextFrame() stays valid until the next
+ * call to decodeNextFrame() or close().
+ */
+class ThreadedVideoDecoder : public FixedRateVideoDecoder, public SeekableVideoDecoder {
+public:
+	static const uint kDefaultQueueLength = 3;
+
+	/**
+	 * @param decoder The decoder to wrap
+	 * @param disposeAfterUse Whether to delete the decoder along with this one
+	 * @param queueLength How many frames to decode ahead
+	 */
+	ThreadedVideoDecoder(BinkDecoder *decoder, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES,
+			uint queueLength = kDefaultQueueLength);
+	/** A seekable wrapper, for a decoder which can seek. */
+	ThreadedVideoDecoder(SeekableBinkDecoder *decoder, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES,
+			uint queueLength = kDefaultQueueLength);
+	~ThreadedVideoDecoder();
+
+	// VideoDecoder API
+	bool loadStream(Common::SeekableReadStream *stream);
+	void close();
+	bool isVideoLoaded() const { return _decoder->isVideoLoaded(); }
+	uint16 getWidth() const { return _decoder->getWidth(); }
+	uint16 getHeight() const { return _decoder->getHeight(); }
+	Graphics::PixelFormat getPixelFormat() const { return _decoder->getPixelFormat(); }
+	uint32 getFrameCount() const { return _decoder->getFrameCount(); }
+	uint32 getElapsedTime() const { return _decoder->getElapsedTime(); }
+	bool needsUpdate() const;
+	const Graphics::Surface *decodeNextFrame();
+
+	// SeekableVideoDecoder API
+	void seekToFrame(uint32 frame);
+	void seekToTime(Audio::Timestamp time);
+	uint32 getDuration() const;
+
+	// FixedRateVideoDecoder
+	Common::Rational getFrameRate() const { return _decoder->getFrameRate(); }
+
+	// Bink specific
+	bool loadStream(Common::SeekableReadStream *stream, const Graphics::PixelFormat &format);
+	/** @see SeekableBinkDecoder::setFrameCache */
+	void setFrameCache(uint32 firstFrame, uint32 lastFrame, uint32 maxBytes = SeekableBinkDecoder::kDefaultFrameCacheSize);
+	/** @see SeekableBinkDecoder::getCachedFrameSize. Only depends on what was loaded, so it takes no lock. */
+	uint32 getCachedFrameSize() const { return _seekable ? _seekable->getCachedFrameSize() : 0; }
+
+	/** Is the next frame already decoded? */
+	bool hasReadyFrame() const;
+
+	/** Decode the next frame into the queue, if there is room. Called by the decoding timer. */
+	void decodeAhead();
+
+protected:
+	void pauseVideoIntern(bool pause);
+	// The wrapped decoder keeps track of the time spent paused
+	void addPauseTime(uint32 ms) {}
+
+private:
+	/** A decoded frame waiting in the queue */
+	struct QueuedFrame {
+		Graphics::Surface *surface;
+		int32 frame;
+	};
+
+	BinkDecoder *_decoder;
+	SeekableBinkDecoder *_seekable; ///< The same decoder, when it can seek
+	DisposeAfterUse::Flag _disposeAfterUse;
+	uint _queueLength;
+
+	/** Held while the wrapped decoder is used */
+	Common::Mutex _decoderMutex;
+	/** Held while the queues are changed, never for long */
+	Common::Mutex _queueMutex;
+
+	Common::Array<Graphics::Surface *> _surfaces; ///< All the allocated surfaces
+	Common::Array<Graphics::Surface *> _freeSurfaces;
+	Common::Queue<QueuedFrame> _readyFrames;
+	Graphics::Surface *_displayedSurface; ///< The surface last returned by decodeNextFrame()
+
+	/** Should the timer decode ahead? Only changed with _decoderMutex held. */
+	volatile bool _decodingAhead;
+
+	// The last frame cache settings, so that they are only passed on when they change
+	uint32 _frameCacheFirst;
+	uint32 _frameCacheLast;
+	uint32 _frameCacheMaxBytes;
+
+	void init(BinkDecoder *decoder, SeekableBinkDecoder *seekable, DisposeAfterUse::Flag disposeAfterUse, uint queueLength);
+
+	/** Allocate the surfaces and start decoding ahead, once the wrapped decoder is loaded */
+	bool startDecoding(bool loaded);
+	void freeSurfaces();
+
+	/** Move the ready frames back to the free surfaces. Needs _decoderMutex. */
+	void flushQueue();
+	/** Decode one frame into the queue. Needs _decoderMutex. */
+	bool decodeFrame();
+	/** Take the next ready frame, or return 0 if there is none */
+	const Graphics::Surface *popReadyFrame();
+
+	void updateDecodingAhead();
+};
+
+} // End of namespace Video
+
+#endif // USE_BINK
+
+#endif // VIDEO_THREADED_VIDEO_DECODER_H